@@ -3,74 +3,124 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include "game.h"
+#include "level.h"
+#include "materials.h"
+#include "hot_reload.h"
+#include "snapshot.h"
+#include "events.h"
+#include "alloc_tracker.h"
+#include "fixed_physics.h"
+#include "bench.h"
+#include "regression.h"
+#include "bodies.h"
+#include "render_state.h"
+#include "sim_thread.h"
+#include "quality.h"
+#include "dynamic_res.h"
+#include "idle.h"
+#include "telemetry.h"
+#include "spatial.h"
+#include "narrow_phase.h"
+#include "explosion.h"
+#include "level_prefetch.h"
+#include "ghost.h"
+#include "sprite_shapes.h"
 
-#define MAX_BLOCKS 10
-#define MAX_ENEMIES 5
-#define MAX_TRAJECTORY_POINTS 100
-#define ENEMY_MAX_HEALTH 3
 #define DARKRED (Color){139, 0, 0, 255}
 #define DARKBLUE (Color){0, 0, 139, 255}
 #define DARKGREEN (Color){0, 100, 0, 255}
 
-typedef struct {
-    Vector2 position;
-    Vector2 velocity;
-    bool launched;
-    float radius;
-} Bird;
-
-typedef struct {
-    Rectangle rect;
-    bool active;
-    Vector2 velocity;
-    bool falling;
-    Rectangle startRect;
-    float rotation;
-    float angularVelocity;
-    bool onGround;
-    float mass;
-    float friction;
-    float bounciness;
-} Block;
-
-typedef struct {
-    Vector2 position;
-    float radius;
-    bool active;
-    Vector2 velocity;
-    bool falling;
-    bool landed;
-    int health;
-    int maxHealth;
-    float hitTimer;
-} Enemy;
-
-typedef struct {
-    Vector2 points[MAX_TRAJECTORY_POINTS];
-    int count;
-} TrajectoryPoints;
-
-typedef enum {
-    MENU,
-    GAME,
-    SETTINGS,
-    LEVEL_COMPLETE
-} GameState;
-
 Enemy enemies[MAX_ENEMIES];
 Block blocks[MAX_BLOCKS];
 int enemyCount = 0;
 int blockCount = 0;
+Joint joints[MAX_JOINTS];
+int jointCount = 0;
+TimerWheel gameTimers;
 bool soundMuted = false;
 int currentLevel = 1;
 int totalLevels = 2;
+unsigned int gameRngState = 1;
 
 // Settings window variables
 bool settingsWindowOpen = false;
-Rectangle settingsWindow = { 400, 200, 400, 300 };
+Rectangle settingsWindow = { 400, 200, 400, 360 };
 float masterVolume = 1.0f;
 bool showTrajectory = true;
 int difficultyLevel = 1; // 1 = Easy, 2 = Medium, 3 = Hard
+QualityController quality;
+
+// Gameplay events emitted by the physics passes, consumed once per step
+EventQueue gameEvents;
+
+// This step's block rects and enemy circles, packed for the batch narrow phase
+#if MAX_BLOCKS > NARROW_MAX_BODIES || MAX_ENEMIES > NARROW_MAX_BODIES
+#error "Hit masks hold NARROW_MAX_BODIES bodies"
+#endif
+PackedRects blockShapes;
+PackedCircles enemyShapes;
+
+// Rewind history for undo-shot and timeline scrubbing
+SnapshotRing history;
+
+// Two-player session with a peer on this machine (--ghost); stepped with the simulation
+GhostLink ghostLink;
+
+// Gameplay state stepped by SimulateFrame(). It belongs to the simulation
+// thread; the main thread only touches it after SimThreadWaitIdle().
+typedef struct {
+    Bird bird;
+    int score;
+    int lives;
+    bool gameOver;
+    bool dragging;
+    bool victory;
+    bool levelComplete;
+
+    // Rewind state: U undoes the last shot, LEFT/RIGHT scrub, SPACE resumes
+    unsigned int simStep;
+    bool scrubbing;
+    int scrubCursor;
+    WorldSnapshot snapshot;
+
+    // Launches so far and the newest pull, sent to the ghost peer
+    unsigned char shots;
+    short pullX;
+    short pullY;
+} GameSession;
+
+GameSession session;
+
+// Function to move on to the level complete screen once the last kill has played out
+void CompleteLevel(int target, void* userData) {
+    if (target == currentLevel && session.victory) session.levelComplete = true;
+}
+
+// Frames published by the simulation for the main thread to draw
+RenderBuffer renderBuffer;
+
+#ifdef PHYSICS_FIXED_POINT
+// Fixed-point builds step this world and draw from its exported copy;
+// the shots are recorded so a finished level can be verified elsewhere
+FixedWorld fixedWorld;
+Replay replay;
+
+// Function to restart the fixed world and its replay from the level just loaded
+void ResetFixedWorld(void) {
+    FixedWorldReset(&fixedWorld, gameRngState);
+    BeginReplay(&replay, currentLevel, gameRngState);
+}
+
+// Function to draw the crates the fixed world set off this step
+void ShowFixedBlasts(void) {
+    Vector2 centres[MAX_BLOCKS];
+    for (int i = 0; i < fixedWorld.blastCount; i++) {
+        centres[i] = (Vector2){ FixToFloat(fixedWorld.blasts[i].x), FixToFloat(fixedWorld.blasts[i].y) };
+    }
+    ShowExplosions(centres, fixedWorld.blastCount);
+}
+#endif
 
 // Function to calculate trajectory
 TrajectoryPoints CalculateTrajectory(Vector2 startPos, Vector2 velocity, int numPoints, float timeStep) {
@@ -87,101 +137,109 @@ TrajectoryPoints CalculateTrajectory(Vector2 startPos, Vector2 velocity, int num
     return trajectory;
 }
 
-// Function to initialize enemies for different levels
-void InitializeEnemies(int level) {
-    if (level == 1) {
-        enemyCount = 2;
-        enemies[0] = (Enemy){
-            {1000.0f, 390.0f}, 15.0f, true, {0.0f, 0.0f}, false, false,
-            ENEMY_MAX_HEALTH, ENEMY_MAX_HEALTH, 0.0f
-        };
-        enemies[1] = (Enemy){
-            {1000.0f, 505.0f}, 15.0f, true, {0.0f, 0.0f}, false, false,
-            ENEMY_MAX_HEALTH, ENEMY_MAX_HEALTH, 0.0f
-        };
-    }
-    else if (level == 2) {
-        enemyCount = 3;
-        enemies[0] = (Enemy){
-            {1000.0f, 390.0f}, 15.0f, true, {0.0f, 0.0f}, false, false,
-            ENEMY_MAX_HEALTH, ENEMY_MAX_HEALTH, 0.0f
-        };
-        enemies[1] = (Enemy){
-            {1000.0f, 505.0f}, 15.0f, true, {0.0f, 0.0f}, false, false,
-            ENEMY_MAX_HEALTH, ENEMY_MAX_HEALTH, 0.0f
-        };
-        enemies[2] = (Enemy){
-            {920.0f, 390.0f}, 15.0f, true, {0.0f, 0.0f}, false, false,
-            ENEMY_MAX_HEALTH, ENEMY_MAX_HEALTH, 0.0f
-        };
+// Function to find when the launch arc first meets a body; duration if it never does
+float TrajectoryHitTime(Vector2 startPos, Vector2 velocity, float duration) {
+    const int segments = 50;
+    const float timeStep = duration / (float)segments;
+    TrajectoryPoints arc = CalculateTrajectory(startPos, velocity, segments + 1, timeStep);
+    Vector2 point;
+
+    for (int i = 0; i < segments; i++) {
+        if (SpatialRaycast(arc.points[i], arc.points[i + 1], NULL, &point)) {
+            float length = hypotf(arc.points[i + 1].x - arc.points[i].x, arc.points[i + 1].y - arc.points[i].y);
+            float fraction = (length > 0.0f) ? hypotf(point.x - arc.points[i].x, point.y - arc.points[i].y) / length : 0.0f;
+            return ((float)i + fraction) * timeStep;
+        }
     }
+    return duration;
 }
 
-// Function to initialize blocks with improved physics properties
-void InitializeBlocks(int level) {
-    blockCount = 8;
-
-    if (level == 1) {
-        Rectangle r1 = { 1000.0f, 300.0f, 46.0f, 120.0f };
-        blocks[0] = (Block){ r1, true, {0.0f, 0.0f}, false, r1, 0.0f, 0.0f, false, 2.0f, 0.8f, 0.3f };
-
-        Rectangle r2 = { 913.0f, 500.0f, 140.0f, 70.0f };
-        blocks[1] = (Block){ r2, true, {0.0f, 0.0f}, false, r2, 0.0f, 0.0f, false, 3.0f, 0.9f, 0.2f };
+// Function to let a block-hit enemy be hurt again
+void EnemyRecovered(int target, void* userData) {
+    if (target >= 0 && target < enemyCount) enemies[target].hitCooldown = TIMER_NONE;
+}
 
-        Rectangle r3 = { 1000.0f, 416.0f, 46.0f, 120.0f };
-        blocks[2] = (Block){ r3, true, {0.0f, 0.0f}, false, r3, 0.0f, 0.0f, false, 2.0f, 0.8f, 0.3f };
+// Function to initialize enemies for different levels (from levelN.lvl)
+void InitializeEnemies(int level) {
+    const LevelData* data = GetLevelData(level);
 
-        Rectangle r4 = { 913.0f, 270.0f, 140.0f, 70.0f };
-        blocks[3] = (Block){ r4, true, {0.0f, 0.0f}, false, r4, 0.0f, 0.0f, false, 3.0f, 0.9f, 0.2f };
+    enemyCount = data->enemyCount;
+    memcpy(enemies, data->enemies, sizeof(Enemy) * data->enemyCount);
 
-        Rectangle r5 = { 912.0f, 300.0f, 46.0f, 120.0f };
-        blocks[4] = (Block){ r5, true, {0.0f, 0.0f}, false, r5, 0.0f, 0.0f, false, 2.0f, 0.8f, 0.3f };
+    // No cooldowns are running on a fresh level
+    ClearTimers(&gameTimers);
+    SetTimerHandler(TIMER_ENEMY_RECOVER, EnemyRecovered, NULL);
+}
 
-        Rectangle r6 = { 913.0f, 384.0f, 140.0f, 70.0f };
-        blocks[5] = (Block){ r6, true, {0.0f, 0.0f}, false, r6, 0.0f, 0.0f, false, 3.0f, 0.9f, 0.2f };
+// Function to initialize blocks with improved physics properties (from levelN.lvl)
+void InitializeBlocks(int level) {
+    const LevelData* data = GetLevelData(level);
+
+    blockCount = data->blockCount;
+    memcpy(blocks, data->blocks, sizeof(Block) * data->blockCount);
+    jointCount = data->jointCount;
+    memcpy(joints, data->joints, sizeof(Joint) * data->jointCount);
+    ResetBodyLod();
+    ClearExplosions();
+}
 
-        Rectangle r7 = { 915.0f, 416.0f, 46.0f, 120.0f };
-        blocks[6] = (Block){ r7, true, {0.0f, 0.0f}, false, r7, 0.0f, 0.0f, false, 2.0f, 0.8f, 0.3f };
+// Function to damage enemy
+void DamageEnemy(int enemyIndex, int damage) {
+    if (enemyIndex < 0 || enemyIndex >= enemyCount || !enemies[enemyIndex].active) return;
 
-        Rectangle r8 = { 913.0f, 250.0f, 140.0f, 70.0f };
-        blocks[7] = (Block){ r8, true, {0.0f, 0.0f}, false, r8, 0.0f, 0.0f, false, 3.0f, 0.9f, 0.2f };
+    enemies[enemyIndex].health -= damage;
+    if (enemies[enemyIndex].health <= 0) {
+        enemies[enemyIndex].active = false;
     }
-    else if (level == 2) {
-        // Level 2 has same block layout but different positions
-        Rectangle r1 = { 1000.0f, 300.0f, 46.0f, 120.0f };
-        blocks[0] = (Block){ r1, true, {0.0f, 0.0f}, false, r1, 0.0f, 0.0f, false, 2.5f, 0.7f, 0.4f };
-
-        Rectangle r2 = { 913.0f, 500.0f, 140.0f, 70.0f };
-        blocks[1] = (Block){ r2, true, {0.0f, 0.0f}, false, r2, 0.0f, 0.0f, false, 3.5f, 0.8f, 0.3f };
+}
 
-        Rectangle r3 = { 1000.0f, 416.0f, 46.0f, 120.0f };
-        blocks[2] = (Block){ r3, true, {0.0f, 0.0f}, false, r3, 0.0f, 0.0f, false, 2.5f, 0.7f, 0.4f };
+// Event listener that applies damage and kills to the simulation state
+void ResolveCombatEvents(const GameEvent* events, int count, void* userData) {
+    for (int i = 0; i < count; i++) {
+        const GameEvent* e = &events[i];
+        if (e->type != EVENT_DAMAGE || e->kindB != BODY_ENEMY) continue;
 
-        Rectangle r4 = { 913.0f, 270.0f, 140.0f, 70.0f };
-        blocks[3] = (Block){ r4, true, {0.0f, 0.0f}, false, r4, 0.0f, 0.0f, false, 3.5f, 0.8f, 0.3f };
+        int j = e->indexB;
+        if (j < 0 || j >= enemyCount || !enemies[j].active) continue;
 
-        Rectangle r5 = { 850.0f, 300.0f, 46.0f, 120.0f };
-        blocks[4] = (Block){ r5, true, {0.0f, 0.0f}, false, r5, 0.0f, 0.0f, false, 2.5f, 0.7f, 0.4f };
+        DamageEnemy(j, e->amount);
 
-        Rectangle r6 = { 850.0f, 384.0f, 140.0f, 70.0f };
-        blocks[5] = (Block){ r6, true, {0.0f, 0.0f}, false, r6, 0.0f, 0.0f, false, 3.5f, 0.8f, 0.3f };
+        if (enemies[j].active) {
+            enemies[j].falling = true;
+            enemies[j].velocity = (Vector2){ 0.0f, -4.0f };
+        }
+        else {
+            EmitFollowUpEvent(EVENT_KILL, (BodyKind)e->kindA, e->indexA, BODY_ENEMY, j,
+                0, enemies[j].position.x, enemies[j].position.y, e->impact);
+        }
+    }
+}
 
-        Rectangle r7 = { 850.0f, 416.0f, 46.0f, 120.0f };
-        blocks[6] = (Block){ r7, true, {0.0f, 0.0f}, false, r7, 0.0f, 0.0f, false, 2.5f, 0.7f, 0.4f };
+// Event listener that turns kills and broken blocks into score
+void ApplyScoreEvents(const GameEvent* events, int count, void* userData) {
+    int* score = (int*)userData;
 
-        Rectangle r8 = { 850.0f, 250.0f, 140.0f, 70.0f };
-        blocks[7] = (Block){ r8, true, {0.0f, 0.0f}, false, r8, 0.0f, 0.0f, false, 3.5f, 0.8f, 0.3f };
+    for (int i = 0; i < count; i++) {
+        if (events[i].type == EVENT_KILL) {
+            *score += (events[i].kindA == BODY_BIRD) ? 150 : 100;
+        }
+        else if (events[i].type == EVENT_BLOCK_BROKEN && events[i].kindA == BODY_BIRD) {
+            *score += 10;
+        }
     }
 }
 
-// Function to damage enemy
-void DamageEnemy(int enemyIndex, int damage) {
-    if (enemyIndex < 0 || enemyIndex >= enemyCount || !enemies[enemyIndex].active) return;
+// Function to seed the simulation RNG (xorshift32, state must be non-zero)
+void SeedGameRandom(unsigned int seed) {
+    gameRngState = (seed != 0) ? seed : 0x9E3779B9u;
+}
 
-    enemies[enemyIndex].health -= damage;
-    if (enemies[enemyIndex].health <= 0) {
-        enemies[enemyIndex].active = false;
-    }
+// Function to get a random value in [min, max] from the simulation RNG
+int GameRandomValue(int min, int max) {
+    gameRngState ^= gameRngState << 13;
+    gameRngState ^= gameRngState >> 17;
+    gameRngState ^= gameRngState << 5;
+    return min + (int)(gameRngState % (unsigned int)(max - min + 1));
 }
 
 // Function to check if all enemies are dead
@@ -194,6 +252,18 @@ bool AllEnemiesDead(void) {
     return true;
 }
 
+// Function to count the bodies still in play: the bird in flight, blocks and enemies
+int CountLiveBodies(void) {
+    int live = session.bird.launched ? 1 : 0;
+    for (int i = 0; i < blockCount; i++) {
+        if (blocks[i].active) live++;
+    }
+    for (int i = 0; i < enemyCount; i++) {
+        if (enemies[i].active) live++;
+    }
+    return live;
+}
+
 // Function to reset game
 void ResetGame(Bird* bird, int* score, int* lives, bool* gameOver) {
     *bird = (Bird){ { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
@@ -201,11 +271,18 @@ void ResetGame(Bird* bird, int* score, int* lives, bool* gameOver) {
     *lives = 3;
     *gameOver = false;
 
+    SeedGameRandom((unsigned int)GetRandomValue(1, 0x7FFFFFFF));
+    SnapshotRingClear(&history);
+
     // Reset enemies based on current level
     InitializeEnemies(currentLevel);
 
     // Reset blocks based on current level
     InitializeBlocks(currentLevel);
+
+#ifdef PHYSICS_FIXED_POINT
+    ResetFixedWorld();
+#endif
 }
 
 // Function to advance to next level
@@ -219,14 +296,22 @@ void NextLevel(Bird* bird, int* score, int* lives, bool* gameOver) {
     *lives = 3;
     *gameOver = false;
 
+    SeedGameRandom((unsigned int)GetRandomValue(1, 0x7FFFFFFF));
+    SnapshotRingClear(&history);
+
     // Initialize new level
     InitializeEnemies(currentLevel);
     InitializeBlocks(currentLevel);
+
+#ifdef PHYSICS_FIXED_POINT
+    ResetFixedWorld();
+#endif
 }
 
 // Function to draw settings window
 void DrawSettingsWindow(void) {
     if (!settingsWindowOpen) return;
+    AllocTrackerPushScope(ALLOC_UI);
 
     // Draw semi-transparent overlay
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, 0.5f));
@@ -267,6 +352,23 @@ void DrawSettingsWindow(void) {
     DrawText("Medium", mediumBtn.x + 8, mediumBtn.y + 8, 12, WHITE);
     DrawText("Hard", hardBtn.x + 15, hardBtn.y + 8, 12, WHITE);
 
+    // Graphics quality: Auto lets the frame-time controller pick the tier
+    DrawText(TextFormat("Graphics: %s", QualityCurrent(&quality)->name), settingsWindow.x + 20, settingsWindow.y + 240, 16, DARKGRAY);
+    Rectangle autoBtn = { settingsWindow.x + 20, settingsWindow.y + 260, 60, 30 };
+    Rectangle lowBtn = { settingsWindow.x + 90, settingsWindow.y + 260, 60, 30 };
+    Rectangle midBtn = { settingsWindow.x + 160, settingsWindow.y + 260, 60, 30 };
+    Rectangle highBtn = { settingsWindow.x + 230, settingsWindow.y + 260, 60, 30 };
+
+    DrawRectangleRec(autoBtn, quality.automatic ? DARKBLUE : LIGHTGRAY);
+    DrawRectangleRec(lowBtn, !quality.automatic && quality.tier == QUALITY_LOW ? DARKBLUE : LIGHTGRAY);
+    DrawRectangleRec(midBtn, !quality.automatic && quality.tier == QUALITY_MEDIUM ? DARKBLUE : LIGHTGRAY);
+    DrawRectangleRec(highBtn, !quality.automatic && quality.tier == QUALITY_HIGH ? DARKBLUE : LIGHTGRAY);
+
+    DrawText("Auto", autoBtn.x + 15, autoBtn.y + 8, 12, WHITE);
+    DrawText("Low", lowBtn.x + 18, lowBtn.y + 8, 12, WHITE);
+    DrawText("Medium", midBtn.x + 8, midBtn.y + 8, 12, WHITE);
+    DrawText("High", highBtn.x + 16, highBtn.y + 8, 12, WHITE);
+
     // Close button
     Rectangle closeBtn = { settingsWindow.x + settingsWindow.width - 80, settingsWindow.y + settingsWindow.height - 50, 60, 30 };
     DrawRectangleRec(closeBtn, GRAY);
@@ -298,115 +400,762 @@ void DrawSettingsWindow(void) {
         if (CheckCollisionPointRec(mousePos, hardBtn)) {
             difficultyLevel = 3;
         }
+
+        if (CheckCollisionPointRec(mousePos, autoBtn)) {
+            QualitySetTier(&quality, quality.tier, true);
+        }
+        if (CheckCollisionPointRec(mousePos, lowBtn)) {
+            QualitySetTier(&quality, QUALITY_LOW, false);
+        }
+        if (CheckCollisionPointRec(mousePos, midBtn)) {
+            QualitySetTier(&quality, QUALITY_MEDIUM, false);
+        }
+        if (CheckCollisionPointRec(mousePos, highBtn)) {
+            QualitySetTier(&quality, QUALITY_HIGH, false);
+        }
     }
+
+    AllocTrackerPopScope();
 }
 
-// Improved block physics with realistic motion
-void UpdateBlockPhysics(float deltaTime) {
-    const float gravity = 0.5f;
-    const float groundY = GetScreenHeight() - 250.0f;
+// Function to pack every block and enemy collision shape; batch indices match blocks[] and enemies[]
+void PackBodyShapes(void) {
+    blockShapes.count = 0;
+    for (int i = 0; i < blockCount; i++) {
+        PackRect(&blockShapes, BlockCollisionRect(&blocks[i], i));
+    }
 
+    enemyShapes.count = 0;
+    for (int i = 0; i < enemyCount; i++) {
+        Vector2 centre;
+        float radius;
+        EnemyCollisionCircle(&enemies[i], &centre, &radius);
+        PackCircle(&enemyShapes, centre, radius);
+    }
+}
+
+// Function to read back a packed block collision rect
+static Rectangle PackedBlockRect(int i) {
+    return (Rectangle){ blockShapes.x[i], blockShapes.y[i], blockShapes.width[i], blockShapes.height[i] };
+}
+
+// Function to advance the simulation by one step
+void UpdateWorld(Bird* bird, int* lives, bool* gameOver, bool* victory, float deltaTime) {
+    const int screenWidth = SCREEN_WIDTH;
+    unsigned int pairsTested = 0;
+
+    // Cooldowns and delayed actions due this step
+    AdvanceTimers(&gameTimers);
+
+    // Gravity, integration and ground/wall response for every awake body
+    StepBodies(bird, &gameEvents, deltaTime);
+    SpatialSync(bird);
+
+    // Shapes don't move during the passes below, only velocities and flags change
+    PackBodyShapes();
+
+    // Enemies a falling block can still hurt this step; a hit takes them out of the mask
+    uint64_t enemyTargets = 0;
+    for (int j = 0; j < enemyCount; j++) {
+        if (enemies[j].active && !enemies[j].falling && enemies[j].hitCooldown == TIMER_NONE) {
+            enemyTargets |= (uint64_t)1 << j;
+        }
+    }
+
+    // Block-enemy collision; blocks deferred by the physics LOD are checked when they next move
     for (int i = 0; i < blockCount; i++) {
-        if (!blocks[i].active || blocks[i].onGround) continue;
-
-        if (blocks[i].falling) {
-            // Apply gravity based on mass
-            blocks[i].velocity.y += gravity * blocks[i].mass * deltaTime * 60.0f;
-
-            // Apply air resistance
-            blocks[i].velocity.x *= (1.0f - 0.02f * deltaTime * 60.0f);
-            blocks[i].velocity.y *= (1.0f - 0.01f * deltaTime * 60.0f);
-
-            // Update position
-            blocks[i].rect.x += blocks[i].velocity.x * deltaTime * 60.0f;
-            blocks[i].rect.y += blocks[i].velocity.y * deltaTime * 60.0f;
-
-            // Update rotation
-            blocks[i].rotation += blocks[i].angularVelocity * deltaTime * 60.0f;
-            blocks[i].angularVelocity *= (1.0f - 0.05f * deltaTime * 60.0f);
-
-            // Ground collision with bounce
-            if (blocks[i].rect.y + blocks[i].rect.height >= groundY) {
-                blocks[i].rect.y = groundY - blocks[i].rect.height;
-                blocks[i].velocity.y *= -blocks[i].bounciness;
-                blocks[i].velocity.x *= blocks[i].friction;
-                blocks[i].angularVelocity *= 0.7f;
-
-                // Stop if velocity is too low
-                if (fabs(blocks[i].velocity.y) < 1.0f && fabs(blocks[i].velocity.x) < 0.5f) {
-                    blocks[i].velocity = (Vector2){ 0.0f, 0.0f };
-                    blocks[i].angularVelocity = 0.0f;
-                    blocks[i].falling = false;
-                    blocks[i].onGround = true;
+        if (blocks[i].active && blocks[i].falling && !BodyDeferred(BODY_BLOCK, i)) {
+            pairsTested += enemyCount;
+            if (enemyTargets == 0) continue;
+
+            uint64_t enemyHit = RectVsCircles(PackedBlockRect(i), &enemyShapes, NULL) & enemyTargets;
+            for (int j = 0; j < enemyCount; j++) {
+                if (enemyHit >> j & 1) {
+                    enemyTargets &= ~((uint64_t)1 << j);
+                    enemies[j].hitCooldown = ScheduleTimer(&gameTimers, ENEMY_HIT_STEPS, TIMER_ENEMY_RECOVER, j);
+                    EmitEvent(&gameEvents, EVENT_DAMAGE, BODY_BLOCK, i, BODY_ENEMY, j, 1,
+                        enemies[j].position.x, enemies[j].position.y, fabsf(blocks[i].velocity.y));
                 }
             }
+        }
+    }
+
+    // Bird collisions
+    if (bird->launched) {
+        Vector2 birdCentre;
+        float birdRadius;
+        BirdCollisionCircle(bird, &birdCentre, &birdRadius);
+
+        // Bird-enemy collision
+        pairsTested += enemyCount + blockCount;
+        uint64_t enemyHit = CircleVsCircles(birdCentre, birdRadius, &enemyShapes, NULL);
+        for (int i = 0; i < enemyCount; i++) {
+            if (enemies[i].active && (enemyHit >> i & 1)) {
+                // Bird hits are an instant kill
+                EmitEvent(&gameEvents, EVENT_DAMAGE, BODY_BIRD, 0, BODY_ENEMY, i, enemies[i].maxHealth,
+                    enemies[i].position.x, enemies[i].position.y, 0.0f);
+            }
+        }
 
-            // Side boundary collision
-            if (blocks[i].rect.x < 0) {
-                blocks[i].rect.x = 0;
-                blocks[i].velocity.x *= -0.5f;
+        // Reset bird if stopped or out of bounds
+        if ((fabs(bird->velocity.x) < 0.5f && fabs(bird->velocity.y) < 0.5f) ||
+            bird->position.x > (float)screenWidth || bird->position.x < 0.0f || bird->position.y < 0.0f) {
+
+            if (*lives > 1) {
+                *bird = (Bird){ { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+                (*lives)--;
+
+                if (AllEnemiesDead()) {
+                    *victory = true;
+                }
             }
-            if (blocks[i].rect.x + blocks[i].rect.width > GetScreenWidth()) {
-                blocks[i].rect.x = GetScreenWidth() - blocks[i].rect.width;
-                blocks[i].velocity.x *= -0.5f;
+            else {
+                *gameOver = true;
+            }
+        }
+
+        // Bird-block collision with improved physics (after the reset above may have moved the bird)
+        BirdCollisionCircle(bird, &birdCentre, &birdRadius);
+        uint64_t blockHit = CircleVsRects(birdCentre, birdRadius, &blockShapes, NULL);
+        for (int i = 0; i < blockCount; i++) {
+            if (blocks[i].active && !blocks[i].falling && (blockHit >> i & 1)) {
+
+                blocks[i].falling = true;
+
+                // Calculate impact force based on bird velocity
+                float impactForce = sqrt(bird->velocity.x * bird->velocity.x + bird->velocity.y * bird->velocity.y);
+
+                blocks[i].velocity = (Vector2){
+                    bird->velocity.x * 0.3f + ((float)GameRandomValue(-2, 2)),
+                    -impactForce * 0.2f
+                };
+                blocks[i].angularVelocity = ((float)GameRandomValue(-30, 30)) / 10.0f;
+
+                EmitEvent(&gameEvents, EVENT_BLOCK_BROKEN, BODY_BIRD, 0, BODY_BLOCK, i, 0,
+                    bird->position.x, bird->position.y, impactForce);
+
+                // Reduce bird velocity after impact
+                bird->velocity.x *= 0.7f;
+                bird->velocity.y *= 0.7f;
             }
         }
     }
+
+    // Block-block collision with improved physics
+    for (int i = 0; i < blockCount; i++) {
+        if (!blocks[i].active || !blocks[i].falling || blocks[i].onGround || BodyDeferred(BODY_BLOCK, i)) continue;
+
+        pairsTested += blockCount - 1;
+
+        for (int j = 0; j < blockCount; j++) {
+            if (i == j || !blocks[j].active || blocks[j].falling || blocks[j].onGround) continue;
+
+            if (CheckCollisionRecs(PackedBlockRect(i), PackedBlockRect(j))) {
+                blocks[j].falling = true;
+
+                // Transfer some momentum
+                blocks[j].velocity = (Vector2){
+                    blocks[i].velocity.x * 0.5f + ((float)GameRandomValue(-1, 1)),
+                    -3.0f + ((float)GameRandomValue(-1, 1))
+                };
+                blocks[j].angularVelocity = ((float)GameRandomValue(-15, 15)) / 10.0f;
+
+                EmitEvent(&gameEvents, EVENT_BLOCK_BROKEN, BODY_BLOCK, i, BODY_BLOCK, j, 0,
+                    blocks[j].rect.x, blocks[j].rect.y, fabsf(blocks[i].velocity.y));
+
+                // Reduce original block's velocity
+                blocks[i].velocity.x *= 0.8f;
+                blocks[i].velocity.y *= 0.8f;
+            }
+        }
+    }
+
+    TelemetryCount(TELEMETRY_COLLISION_PAIRS, pairsTested);
+
+    // Consume this step's events: damage first, then scoring
+    DispatchEvents(&gameEvents);
+
+    // Crates knocked loose above go off now, and their damage is scored in the same step
+    if (ResolveExplosions(&gameEvents) > 0) {
+        DispatchEvents(&gameEvents);
+    }
+}
+
+// Function to copy the peer's newest frame into the view, if they are on this level
+void PublishGhost(RenderSnapshot* view) {
+    const GhostFrame* ghost = GhostLinkLatest(&ghostLink);
+    view->ghostVisible = ghost != NULL && ghost->level == currentLevel;
+    if (!view->ghostVisible) return;
+
+    view->ghostScore = ghost->score;
+    view->ghostBird = (Bird){ GhostCentre(&ghost->bird), { 0.0f, 0.0f },
+        (ghost->bird.flags & GHOST_LAUNCHED) != 0, GhostRect(&ghost->bird).width / 2.0f };
+
+    view->ghostBlockCount = (ghost->blockCount < MAX_BLOCKS) ? ghost->blockCount : MAX_BLOCKS;
+    for (int i = 0; i < view->ghostBlockCount; i++) {
+        const GhostBody* body = &ghost->blocks[i];
+        unsigned char sprite = (body->extra == MATERIAL_TNT) ? RENDER_SPRITE_TNT : (unsigned char)(i % 2);
+        view->ghostBlocks[i] = (RenderBlock){ GhostRect(body), GhostRotation(body), sprite, (body->flags & GHOST_ACTIVE) != 0 };
+    }
+
+    view->ghostEnemyCount = (ghost->enemyCount < MAX_ENEMIES) ? ghost->enemyCount : MAX_ENEMIES;
+    for (int i = 0; i < view->ghostEnemyCount; i++) {
+        const GhostBody* body = &ghost->enemies[i];
+        view->ghostEnemies[i] = (RenderEnemy){ GhostCentre(body), body->extra, 0, (body->flags & GHOST_ACTIVE) != 0, GhostRect(body).width / 2.0f };
+    }
+}
+
+// Function to send this world to the ghost peer
+void SendGhostFrame(void) {
+    static GhostFrame frame;
+
+    frame.step = session.simStep;
+    frame.score = session.score;
+    frame.level = (unsigned char)currentLevel;
+    frame.lives = (unsigned char)session.lives;
+    frame.shots = session.shots;
+    frame.pullX = session.pullX;
+    frame.pullY = session.pullY;
+    frame.bird = QuantizeCircle(session.bird.position, session.bird.radius,
+        GHOST_ACTIVE | (session.bird.launched ? GHOST_LAUNCHED : 0), 0);
+
+    frame.blockCount = blockCount;
+    for (int i = 0; i < blockCount; i++) {
+        unsigned char flags = (blocks[i].active ? GHOST_ACTIVE : 0) | (blocks[i].falling ? GHOST_FALLING : 0);
+        frame.blocks[i] = QuantizeRect(blocks[i].rect, blocks[i].rotation, flags, (unsigned char)blocks[i].material);
+    }
+
+    frame.enemyCount = enemyCount;
+    for (int i = 0; i < enemyCount; i++) {
+        unsigned char flags = (enemies[i].active ? GHOST_ACTIVE : 0) | (enemies[i].falling ? GHOST_FALLING : 0);
+        frame.enemies[i] = QuantizeCircle(enemies[i].position, enemies[i].radius, flags, (unsigned char)enemies[i].health);
+    }
+
+    GhostLinkSend(&ghostLink, &frame);
+}
+
+// Function to publish the current world for the main thread to draw
+void PublishRenderState(void) {
+    static unsigned int frame = 0;
+    RenderSnapshot* view = RenderBufferBack(&renderBuffer);
+
+    view->frame = ++frame;
+    view->bird = session.bird;
+    view->dragging = session.dragging;
+    view->aimHitTime = TRAJECTORY_DURATION;
+    if (session.dragging) {
+        // The preview stops at the first body in the way
+        Vector2 velocity = { (150.0f - session.bird.position.x) * 0.2f, (400.0f - session.bird.position.y) * 0.2f };
+        SpatialSync(&session.bird);
+        view->aimHitTime = TrajectoryHitTime((Vector2){ 150.0f, 400.0f }, velocity, TRAJECTORY_DURATION);
+    }
+
+    view->blockCount = blockCount;
+    for (int i = 0; i < blockCount; i++) {
+        Vector2 offset = BodyDrawOffset(BODY_BLOCK, i, (Vector2){ blocks[i].rect.x, blocks[i].rect.y });
+        Rectangle rect = { blocks[i].rect.x + offset.x, blocks[i].rect.y + offset.y, blocks[i].rect.width, blocks[i].rect.height };
+        unsigned char sprite = (blocks[i].material == MATERIAL_TNT) ? RENDER_SPRITE_TNT : (unsigned char)(i % 2);
+        view->blocks[i] = (RenderBlock){ rect, blocks[i].rotation, sprite, blocks[i].active };
+    }
+
+    view->enemyCount = enemyCount;
+    for (int i = 0; i < enemyCount; i++) {
+        Vector2 offset = BodyDrawOffset(BODY_ENEMY, i, enemies[i].position);
+        Vector2 position = { enemies[i].position.x + offset.x, enemies[i].position.y + offset.y };
+        view->enemies[i] = (RenderEnemy){ position, enemies[i].health, enemies[i].maxHealth, enemies[i].active, enemies[i].radius };
+    }
+    view->flashCount = RecentExplosions(view->flashes, MAX_EXPLOSION_FLASHES);
+
+    // Anchors only need each block's centre and rotation
+    JointBody placed[MAX_BLOCKS];
+    for (int i = 0; i < blockCount; i++) {
+        Rectangle rect = view->blocks[i].rect;
+        placed[i] = (JointBody){ { rect.x + rect.width / 2.0f, rect.y + rect.height / 2.0f }, { 0.0f, 0.0f }, blocks[i].rotation, 0.0f, 0.0f, 0.0f };
+    }
+    view->jointCount = 0;
+    for (int i = 0; i < jointCount; i++) {
+        if (joints[i].broken) continue;
+        view->joints[view->jointCount++] = (RenderJoint){ JointAnchorA(&joints[i], placed), JointAnchorB(&joints[i], placed), joints[i].type };
+    }
+
+    PublishGhost(view);
+
+    view->score = session.score;
+    view->lives = session.lives;
+    view->level = currentLevel;
+    view->simStep = session.simStep;
+    view->gameOver = session.gameOver;
+    view->victory = session.victory;
+    view->levelComplete = session.levelComplete;
+    view->scrubbing = session.scrubbing;
+
+    view->settled = !session.bird.launched && !session.dragging;
+    for (int i = 0; i < blockCount && view->settled; i++) {
+        if (blocks[i].active && blocks[i].falling && !blocks[i].onGround) view->settled = false;
+    }
+    for (int i = 0; i < enemyCount && view->settled; i++) {
+        if (enemies[i].active && enemies[i].falling) view->settled = false;
+    }
+
+    // Still waiting on a timer (the level complete delay among them) or a blast to fade
+    if (gameTimers.pending > 0 || view->flashCount > 0) view->settled = false;
+    if (session.victory && !session.levelComplete && currentLevel < totalLevels) view->settled = false;
+
+    // The peer's world can change at any time
+    if (ghostLink.open) view->settled = false;
+
+    RenderBufferPublish(&renderBuffer);
 }
 
-int main(void) {
-    const int screenWidth = 1536;
-    const int screenHeight = 800;
-    const float gravity = 0.41f;
+// Function to switch to the world prefetched for level (simulation idle); false if it isn't ready
+bool SwapInPrefetchedLevel(int level) {
+    static LevelData data;
+    if (!LevelPrefetchTake(level, &session.snapshot, &data)) return false;
+
+    // The cache gets the same data, so R restarts exactly this level
+    ReplaceLevelData(level, &data);
+    currentLevel = level;
+
+    // The score carries over, as in NextLevel()
+    int score = session.score;
+    RestoreWorld(&session.snapshot, &session.bird, &session.score, &session.lives, &session.gameOver, &session.simStep);
+    session.score = score;
+
+    SeedGameRandom((unsigned int)GetRandomValue(1, 0x7FFFFFFF));
+    SnapshotRingClear(&history);
+    ResetBodyLod();
+    ClearExplosions();
+#ifdef PHYSICS_FIXED_POINT
+    ResetFixedWorld();
+#endif
+    return true;
+}
+
+// Function to start the current level over, or the next one (simulation idle)
+void BeginLevel(bool advance) {
+    if (advance && currentLevel < totalLevels && SwapInPrefetchedLevel(currentLevel + 1)) {
+        // Swapped in without touching the disk
+    }
+    else if (advance) {
+        NextLevel(&session.bird, &session.score, &session.lives, &session.gameOver);
+    }
+    else {
+        ResetGame(&session.bird, &session.score, &session.lives, &session.gameOver);
+    }
+
+    EventQueueClear(&gameEvents);
+    session.dragging = false;
+    session.victory = false;
+    session.levelComplete = false;
+    session.scrubbing = false;
+    session.simStep = 0;
+
+    PublishRenderState();
+}
+
+// Screens and the moves between them. A move into a level waits, with the
+// old screen still drawn, until the level has been prepared in the
+// background; the next level starts preparing as soon as the current one
+// is won, so usually there is nothing left to wait for.
+typedef struct {
+    GameState current;
+    GameState target;
+    bool moving;  // a move to target is under way
+} ScreenFlow;
+
+// Function to ask for another screen; UpdateScreenFlow() makes the move
+void RequestScreen(ScreenFlow* flow, GameState target) {
+    flow->target = target;
+    flow->moving = target != flow->current;
+}
+
+// Function to start prefetching and finish any screen move that is ready (main thread)
+void UpdateScreenFlow(ScreenFlow* flow, const RenderSnapshot* view) {
+    int next = currentLevel + 1;
+
+    if (flow->current == GAME) {
+        if (view->victory && currentLevel < totalLevels && LevelPrefetchLevel() != next) {
+            LevelPrefetchStart(next);
+        }
+        if (view->levelComplete && !flow->moving) {
+            RequestScreen(flow, LEVEL_COMPLETE);
+        }
+    }
+
+    if (!flow->moving) return;
+
+    if (flow->current == LEVEL_COMPLETE && flow->target == GAME) {
+        // Dropped by a hot reload of that level, say
+        if (LevelPrefetchLevel() != next) LevelPrefetchStart(next);
+        if (!LevelPrefetchReady(next)) return;
+
+        SimThreadWaitIdle();
+        BeginLevel(true);
+    }
+    else if (flow->current == LEVEL_COMPLETE && flow->target == MENU) {
+        LevelPrefetchCancel();
+        SimThreadWaitIdle();
+        currentLevel = 1;
+        BeginLevel(false);
+    }
+    else if (flow->current == MENU && flow->target == GAME) {
+        SimThreadWaitIdle();
+        session.victory = false;
+    }
+
+    flow->current = flow->target;
+    flow->moving = false;
+}
+
+// Function to run one frame of gameplay; on the simulation thread when there is one
+void SimulateFrame(const SimInput* input, void* userData) {
+    AllocTrackerPushScope(ALLOC_PHYSICS);
+
+    // Undo the last shot: back to the moment before launch
+    if (input->undo && !session.dragging) {
+        int shot = SnapshotRingFindShotStart(&history, SnapshotRingNewest(&history));
+        if (shot >= 0 && SnapshotRingGet(&history, shot, &session.snapshot)) {
+            RestoreWorld(&session.snapshot, &session.bird, &session.score, &session.lives, &session.gameOver, &session.simStep);
+            ResetBodyLod();
+            ClearExplosions();
+            SnapshotRingTruncate(&history, shot - 1);
+            EventQueueClear(&gameEvents);
+            session.scrubbing = false;
+            session.victory = false;
+#ifdef PHYSICS_FIXED_POINT
+            // Snapshots hold the float copy, so a rewound run can't be replayed exactly
+            FixedWorldImport(&fixedWorld, &session.bird, session.score, session.lives, session.gameOver, session.simStep);
+            replay.tainted = true;
+#endif
+        }
+    }
+
+    // Scrub the timeline; the simulation is paused until SPACE
+    if (input->scrubLeft || input->scrubRight) {
+        if (!session.scrubbing) {
+            session.scrubbing = true;
+            session.scrubCursor = SnapshotRingNewest(&history);
+        }
+
+        session.scrubCursor += input->scrubLeft ? -1 : 1;
+        if (session.scrubCursor < SnapshotRingOldest(&history)) session.scrubCursor = SnapshotRingOldest(&history);
+        if (session.scrubCursor > SnapshotRingNewest(&history)) session.scrubCursor = SnapshotRingNewest(&history);
+
+        if (SnapshotRingGet(&history, session.scrubCursor, &session.snapshot)) {
+            RestoreWorld(&session.snapshot, &session.bird, &session.score, &session.lives, &session.gameOver, &session.simStep);
+            ResetBodyLod();
+            ClearExplosions();
+        }
+    }
+    if (session.scrubbing && input->resume) {
+        SnapshotRingTruncate(&history, session.scrubCursor);
+        EventQueueClear(&gameEvents);
+        session.scrubbing = false;
+        session.victory = false;
+#ifdef PHYSICS_FIXED_POINT
+        FixedWorldImport(&fixedWorld, &session.bird, session.score, session.lives, session.gameOver, session.simStep);
+        replay.tainted = true;
+#endif
+    }
+
+    // Mouse input for bird launching
+    if (!session.scrubbing && !session.bird.launched && input->mousePressed) {
+        if (CheckCollisionPointCircle(input->mouse, session.bird.position, session.bird.radius)) {
+            session.dragging = true;
+        }
+    }
+
+    if (session.dragging) {
+        session.bird.position = input->mouse;
+        if (input->mouseReleased) {
+            session.dragging = false;
+
+            // Remember the world with the bird still in the sling
+            Bird restingBird = { { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+            CaptureWorld(&session.snapshot, &restingBird, session.score, session.lives, session.gameOver, session.simStep);
+            SnapshotRingPush(&history, &session.snapshot, SNAPSHOT_SHOT_START);
+
+            // The launch input goes to the ghost peer with the next frame
+            session.shots++;
+            session.pullX = (short)floorf(session.bird.position.x + 0.5f);
+            session.pullY = (short)floorf(session.bird.position.y + 0.5f);
+
+#ifdef PHYSICS_FIXED_POINT
+            // Launch from whole pixels so the recorded shot reproduces exactly
+            int pullX = (int)floorf(session.bird.position.x + 0.5f);
+            int pullY = (int)floorf(session.bird.position.y + 0.5f);
+            FixedWorldLaunch(&fixedWorld, pullX, pullY);
+            RecordReplayShot(&replay, session.simStep, pullX, pullY);
+            FixedWorldExport(&fixedWorld, &session.bird, &session.lives, &session.gameOver);
+#else
+            session.bird.velocity = (Vector2){ (150.0f - session.bird.position.x) * 0.2f, (400.0f - session.bird.position.y) * 0.2f };
+            session.bird.launched = true;
+#endif
+            TelemetryCount(TELEMETRY_SHOTS_FIRED, 1);
+        }
+    }
+
+    if (!session.scrubbing) {
+        bool wasOver = session.gameOver;
+        long long stepStart = BenchNow();
+
+#ifdef PHYSICS_FIXED_POINT
+        // One fixed 1/60 s step per frame, whatever the frame time
+        FixedWorldStep(&fixedWorld, &gameEvents);
+        AdvanceTimers(&gameTimers);
+        FixedWorldExport(&fixedWorld, &session.bird, &session.lives, &session.gameOver);
+        ShowFixedBlasts();
+        if (session.dragging) session.bird.position = input->mouse;
+        DispatchEvents(&gameEvents);
+#else
+        UpdateWorld(&session.bird, &session.lives, &session.gameOver, &session.victory, input->deltaTime);
+#endif
+
+        TelemetryObserve(TELEMETRY_PHYSICS_STEP, (unsigned long long)((BenchNow() - stepStart) / 1000));
+        TelemetryObserve(TELEMETRY_LIVE_BODIES, (unsigned long long)CountLiveBodies());
+        if (session.gameOver && !wasOver) {
+            TelemetryCount(TELEMETRY_LEVELS_LOST, 1);
+        }
+
+        if (++session.simStep % SNAPSHOT_INTERVAL == 0) {
+            CaptureWorld(&session.snapshot, &session.bird, session.score, session.lives, session.gameOver, session.simStep);
+            SnapshotRingPush(&history, &session.snapshot, 0);
+        }
+        if (ghostLink.open && session.simStep % GHOST_SEND_INTERVAL == 0) {
+            SendGhostFrame();
+        }
+    }
+    if (ghostLink.open) {
+        GhostLinkReceive(&ghostLink);
+    }
+
+    // Check victory condition
+    if (AllEnemiesDead() && !session.victory) {
+        session.victory = true;
+        TelemetryCount(TELEMETRY_LEVELS_WON, 1);
+#ifdef PHYSICS_FIXED_POINT
+        if (!replay.tainted) {
+            replay.steps = session.simStep;
+            replay.claimedScore = fixedWorld.score;
+            replay.claimedHash = FixedWorldHash(&fixedWorld);
+            // Not TextFormat(): its buffers are shared with the drawing thread
+            char replayFile[32];
+            snprintf(replayFile, sizeof(replayFile), "replay_level%d.txt", currentLevel);
+            SaveReplay(replayFile, &replay);
+        }
+#endif
+        if (currentLevel < totalLevels) {
+            ScheduleTimer(&gameTimers, LEVEL_COMPLETE_DELAY_STEPS, TIMER_LEVEL_COMPLETE, currentLevel);
+        }
+    }
+
+    AllocTrackerPopScope();
+
+    PublishRenderState();
+}
+
+int main(int argc, char** argv) {
+    const int screenWidth = SCREEN_WIDTH;
+    const int screenHeight = SCREEN_HEIGHT;
     const int maxLives = 3;
 
+    // Metrics are only exported when a directory is given
+    const char* telemetryDirectory = NULL;
+
+    // Two-player mode: --ghost <local port>:<peer port>, the peer started with the ports swapped
+    int ghostPort = 0;
+    int ghostPeerPort = 0;
+
+    // Collision shapes traced from the sprites by --build-shapes; the headless
+    // modes below collide with them too, so they replay the game as it plays
+    LoadSpriteShapes(SHAPES_FILE);
+
+    // Headless modes: benchmarks, server-side replay verification, level regression
+    for (int i = 1; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--bench") == 0 && value) return RunBenchmark(value);
+        if (strcmp(argv[i], "--verify-replay") == 0 && value) return VerifyReplayFile(value);
+        if (strcmp(argv[i], "--regress") == 0) return RunRegression(value ? value : "regression_report.json", false);
+        if (strcmp(argv[i], "--regress-update") == 0) return RunRegression(REGRESSION_BASELINE_FILE, true);
+        if (strcmp(argv[i], "--build-shapes") == 0) return BuildSpriteShapes(SHAPES_FILE);
+        if (strcmp(argv[i], "--telemetry") == 0 && value) telemetryDirectory = value;
+        if (strcmp(argv[i], "--ghost") == 0 && value) sscanf(value, "%d:%d", &ghostPort, &ghostPeerPort);
+        if (strcmp(argv[i], "--integrator") == 0 && value) {
+            IntegratorKind kind;
+            if (IntegratorFromName(value, &kind)) SetBodyIntegrator(kind);
+            else TraceLog(LOG_WARNING, "PHYSICS: Unknown integrator %s, keeping %s", value, IntegratorName(GetBodyIntegrator()));
+        }
+    }
+
+    // raylib's allocations go to the scope they happen in, see AllocTrackerRecordInScope()
+    AllocTrackerPushScope(ALLOC_RENDER);
     InitWindow(screenWidth, screenHeight, "Angry Birds - Enhanced Edition");
     SetTargetFPS(60);
+    AllocTrackerPopScope();
 
     // Initialize audio
+    AllocTrackerPushScope(ALLOC_AUDIO);
     InitAudioDevice();
     SetMasterVolume(masterVolume);
+    AllocTrackerPopScope();
 
     // Load textures
-    Image bgImage = LoadImage("backpeace.jpg");
-    ImageResize(&bgImage, 1536, 1024);
-    Texture2D background = LoadTextureFromImage(bgImage);
-    UnloadImage(bgImage);
-
-    Texture2D ground = LoadTexture("ground.png");
+    AllocTrackerPushScope(ALLOC_ASSETS);
     Texture2D slingTexture = LoadTexture("sling.png");
     Texture2D blockTexture1 = LoadTexture("blockd.png");
     Texture2D blockTexture2 = LoadTexture("blocky.png");
     Texture2D enemyTexture = LoadTexture("enemy.png");
-    Texture2D menuBackground = LoadTexture("menu.png");
     Texture2D birdTexture = LoadTexture("angrybird.png");
 
     if (birdTexture.id == 0) {
         TraceLog(LOG_ERROR, "Bird texture failed to load!");
     }
 
+    // Graphics quality follows the measured frame time unless fixed in settings.
+    // The full-screen art is uploaded at every tier's resolution here, so a tier change only swaps textures.
+    Texture2D background, ground, menuBackground;
+    ScaledTexture backdrops[] = {
+        { "backpeace.jpg", &background, 1536, 1024, { { 0 } } },
+        { "ground.png", &ground, 0, 0, { { 0 } } },
+        { "menu.png", &menuBackground, 0, 0, { { 0 } } },
+    };
+    const int backdropCount = sizeof(backdrops) / sizeof(backdrops[0]);
+    LoadScaledTextures(backdrops, backdropCount);
+    QualityInit(&quality, QUALITY_HIGH, true);
+    QualityLevel textureTier = quality.tier;
+    SelectTextureTier(backdrops, backdropCount, textureTier);
+
+    // The HUD text is drawn into this texture and only redrawn every hudInterval frames
+    const int hudWidth = 520;
+    const int hudHeight = 220;
+    RenderTexture2D hud = LoadRenderTexture(hudWidth, hudHeight);
+    unsigned int hudFrame = 0;
+
+    // The game world is drawn at a resolution that adapts to the frame time and upscaled
+    DynamicResolution dynamicRes;
+    DynamicResInit(&dynamicRes, screenWidth, screenHeight);
+
+    // Static screens (menu, settings, level complete, a settled level) sleep until the next input event
+    IdleState idle = { 0 };
+
+    // Edited assets and level files are swapped in without restarting
+    if (HotReloadInit(".")) {
+        // Every tier's copy of the full-screen art, each at its own size
+        for (int i = 0; i < backdropCount; i++) {
+            for (int tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+                Texture2D* copy = &backdrops[i].tiers[tier];
+                HotReloadWatchTexture(backdrops[i].fileName, copy, copy->width, copy->height);
+            }
+        }
+        HotReloadWatchTexture("sling.png", &slingTexture, 0, 0);
+        HotReloadWatchTexture("blockd.png", &blockTexture1, 0, 0);
+        HotReloadWatchTexture("blocky.png", &blockTexture2, 0, 0);
+        HotReloadWatchTexture("enemy.png", &enemyTexture, 0, 0);
+        HotReloadWatchTexture("angrybird.png", &birdTexture, 0, 0);
+
+        for (int level = 1; level <= totalLevels; level++) {
+            HotReloadWatchLevel(LevelFileName(level), level);
+        }
+    }
+    AllocTrackerPopScope();
+
     // Initialize game state
-    GameState currentState = MENU;
-    Bird bird = { { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
-    int lives = maxLives;
-    int score = 0;
-    bool gameOver = false;
-    bool dragging = false;
-    bool victory = false;
+    ScreenFlow flow = { MENU, MENU, false };
+    session.bird = (Bird){ { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+    session.lives = maxLives;
+    session.scrubCursor = -1;
+
+    // Allocation tracking: GAME must not allocate once it has warmed up
+    const int allocWarmupFrames = 120;
+    int gameFrames = 0;
+    bool showAllocStats = false;
+    AllocFrameStats allocStats = { 0 };
 
     // Initialize first level
+    SeedGameRandom((unsigned int)GetRandomValue(1, 0x7FFFFFFF));
     InitializeEnemies(currentLevel);
     InitializeBlocks(currentLevel);
-
-    // Main game loop
+#ifdef PHYSICS_FIXED_POINT
+    ResetFixedWorld();
+#endif
+
+    // Damage must be resolved before scoring sees the resulting kills
+    EventQueueInit(&gameEvents);
+    AddEventListener(ResolveCombatEvents, NULL);
+    AddEventListener(ApplyScoreEvents, &session.score);
+#ifndef PHYSICS_FIXED_POINT
+    // The fixed-point world sets off its own crates inside FixedWorldStep
+    AddEventListener(TriggerExplosives, NULL);
+#endif
+    SetTimerHandler(TIMER_LEVEL_COMPLETE, CompleteLevel, NULL);
+
+    RenderBufferInit(&renderBuffer);
+    PublishRenderState();
+    if (telemetryDirectory) TelemetryStart(telemetryDirectory);
+    if (ghostPort > 0 && ghostPeerPort > 0) GhostLinkOpen(&ghostLink, ghostPort, ghostPeerPort);
+    SimThreadStart(SimulateFrame, NULL);
+
+    // Main game loop; allocations no inner scope claims are put down to it
+    AllocTrackerPushScope(ALLOC_CORE);
     while (!WindowShouldClose()) {
         float deltaTime = GetFrameTime();
+        double frameStart = GetTime();
+        AllocTrackerBeginFrame();
+
+        bool texturesChanged = false;
+        if (quality.tier != textureTier) {
+            textureTier = quality.tier;
+            SelectTextureTier(backdrops, backdropCount, textureTier);
+            texturesChanged = true;
+        }
+
+        // An edited current level is rebuilt in place, an edited next level prepared again.
+        // A reloaded backdrop may be a new texture rather than an update of the old one.
+        AllocTrackerPushScope(ALLOC_ASSETS);
+        int swappedAssets;
+        unsigned int changedLevels = HotReloadPoll(&swappedAssets);
+        if (swappedAssets > 0) SelectTextureTier(backdrops, backdropCount, textureTier);
+        AllocTrackerPopScope();
+        if (changedLevels & (1u << currentLevel)) {
+            AllocTrackerSetSteadyState(false);
+            gameFrames = 0;
+
+            SimThreadWaitIdle();
+            BeginLevel(false);
+        }
+        if (LevelPrefetchLevel() != 0 && (changedLevels & (1u << LevelPrefetchLevel()))) {
+            LevelPrefetchStart(LevelPrefetchLevel());
+        }
+
+        UpdateScreenFlow(&flow, RenderBufferLatest(&renderBuffer));
+        const GameState currentState = flow.current;
+
+        // A frame woken from idle took as long as the wait: step the game by a normal frame instead,
+        // and keep the wait out of the frame-time controllers
+        bool changing = IdleInputActive() || swappedAssets > 0 || texturesChanged ||
+            (currentState == GAME && !RenderBufferLatest(&renderBuffer)->settled);
+        bool wokeFromIdle = IdleUpdate(&idle, changing);
+        if (wokeFromIdle) {
+            deltaTime = 1.0f / 60.0f;
+        }
+        else {
+            TelemetryObserve(TELEMETRY_FRAME_TIME, (unsigned long long)(deltaTime * 1000000.0f));
+        }
+
+        if (currentState != GAME) {
+            AllocTrackerSetSteadyState(false);
+            gameFrames = 0;
+        }
+        else if (++gameFrames == allocWarmupFrames) {
+            AllocTrackerSetSteadyState(true);
+        }
 
         if (currentState == MENU) {
             BeginDrawing();
             ClearBackground(RAYWHITE);
 
-            DrawTexture(menuBackground, 0, 0, WHITE);
+            DrawScaledTexture(menuBackground, (Rectangle){ 0.0f, 0.0f, (float)screenWidth, (float)screenHeight });
 
             Rectangle playButton = { 800, 150, 300, 100 };
             Rectangle settingsButton = { 950 , 500, 300, 100 };
@@ -418,8 +1167,7 @@ int main(void) {
            
 
             if (CheckCollisionPointRec(mousePoint, playButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                currentState = GAME;
-                victory = false;
+                RequestScreen(&flow, GAME);
             }
             if (CheckCollisionPointRec(mousePoint, settingsButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
                 settingsWindowOpen = true;
@@ -439,10 +1187,10 @@ int main(void) {
             BeginDrawing();
             ClearBackground(RAYWHITE);
 
-            DrawTexture(background, 0, -200, WHITE);
+            DrawScaledTexture(background, (Rectangle){ 0.0f, -200.0f, 1536.0f, 1024.0f });
 
             DrawText("LEVEL COMPLETE!", screenWidth / 2 - 150, screenHeight / 2 - 100, 40, DARKGREEN);
-            DrawText(TextFormat("Final Score: %d", score), screenWidth / 2 - 100, screenHeight / 2 - 50, 24, DARKGRAY);
+            DrawText(TextFormat("Final Score: %d", RenderBufferLatest(&renderBuffer)->score), screenWidth / 2 - 100, screenHeight / 2 - 50, 24, DARKGRAY);
 
             Rectangle nextLevelBtn = { screenWidth / 2 - 100, screenHeight / 2, 200, 50 };
             Rectangle menuBtn = { screenWidth / 2 - 100, screenHeight / 2 + 70, 200, 50 };
@@ -455,200 +1203,71 @@ int main(void) {
 
             Vector2 mousePoint = GetMousePosition();
             if (CheckCollisionPointRec(mousePoint, nextLevelBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                NextLevel(&bird, &score, &lives, &gameOver);
-                currentState = GAME;
-                victory = false;
+                RequestScreen(&flow, GAME);
             }
             if (CheckCollisionPointRec(mousePoint, menuBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                currentState = MENU;
-                currentLevel = 1;
-                ResetGame(&bird, &score, &lives, &gameOver);
-                victory = false;
-            }
-
-            EndDrawing();
-            continue;
-        }
-
-        // Game logic (existing code with improvements)
-
-        // Update enemy hit timers
-        for (int i = 0; i < enemyCount; i++) {
-            if (enemies[i].hitTimer > 0.0f) {
-                enemies[i].hitTimer -= deltaTime;
-            }
-        }
-
-        // Improved block physics
-        UpdateBlockPhysics(deltaTime);
-
-        // Block-enemy collision
-        for (int i = 0; i < blockCount; i++) {
-            if (blocks[i].active && blocks[i].falling) {
-                for (int j = 0; j < enemyCount; j++) {
-                    if (enemies[j].active && !enemies[j].falling && enemies[j].hitTimer <= 0.0f &&
-                        CheckCollisionCircleRec(enemies[j].position, enemies[j].radius, blocks[i].rect)) {
-
-                        DamageEnemy(j, 1);
-                        enemies[j].hitTimer = 0.5f;
-
-                        if (enemies[j].active) {
-                            enemies[j].falling = true;
-                            enemies[j].velocity = (Vector2){ 0.0f, -4.0f };
-                        }
-                        else {
-                            score += 100;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Enemy falling physics
-        for (int i = 0; i < enemyCount; i++) {
-            if (enemies[i].active && enemies[i].falling) {
-                enemies[i].velocity.y += gravity;
-                enemies[i].position.y += enemies[i].velocity.y;
-
-                float groundY = screenHeight - 250.0f;
-                if (enemies[i].position.y + enemies[i].radius >= groundY) {
-                    enemies[i].position.y = groundY - enemies[i].radius;
-                    enemies[i].velocity.y = 0.0f;
-                    enemies[i].falling = false;
-                    enemies[i].landed = true;
-                }
-            }
-        }
-
-        // Mouse input for bird launching
-        if (!bird.launched && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            if (CheckCollisionPointCircle(GetMousePosition(), bird.position, bird.radius)) {
-                dragging = true;
-            }
-        }
-
-        if (dragging) {
-            bird.position = GetMousePosition();
-            if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-                dragging = false;
-                bird.velocity = (Vector2){ (150.0f - bird.position.x) * 0.2f, (400.0f - bird.position.y) * 0.2f };
-                bird.launched = true;
+                RequestScreen(&flow, MENU);
             }
-        }
 
-        // Bird physics
-        if (bird.launched) {
-            bird.velocity.y += gravity;
-            bird.position.x += bird.velocity.x;
-            bird.position.y += bird.velocity.y;
-
-            // Bird-enemy collision
-            for (int i = 0; i < enemyCount; i++) {
-                if (enemies[i].active &&
-                    CheckCollisionCircles(bird.position, bird.radius, enemies[i].position, enemies[i].radius)) {
-                    enemies[i].active = false;
-                    score += 150;
-                }
+            // Only shows if the next level is still being read when NEXT LEVEL is clicked
+            if (flow.moving && flow.target == GAME) {
+                DrawText("Loading...", nextLevelBtn.x + 210, nextLevelBtn.y + 15, 20, DARKGRAY);
             }
 
-            // Ground collision
-            float groundHeight = 250.0f;
-            float groundY = screenHeight - groundHeight;
-
-            if (bird.position.y + bird.radius >= groundY) {
-                bird.position.y = groundY - bird.radius;
-                bird.velocity.y *= -0.5f;
-
-                if (fabs(bird.velocity.y) < 1.0f) {
-                    bird.velocity.y = 0.0f;
-                }
-            }
-
-            // Reset bird if stopped or out of bounds
-            if ((fabs(bird.velocity.x) < 0.5f && fabs(bird.velocity.y) < 0.5f) ||
-                bird.position.x > (float)screenWidth || bird.position.x < 0.0f || bird.position.y < 0.0f) {
-
-                if (lives > 1) {
-                    bird = (Bird){ { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
-                    lives--;
-
-                    if (AllEnemiesDead()) {
-                        victory = true;
-                    }
-                }
-                else {
-                    gameOver = true;
-                }
-            }
-
-            // Bird-block collision with improved physics
-            for (int i = 0; i < blockCount; i++) {
-                if (blocks[i].active && !blocks[i].falling &&
-                    CheckCollisionCircleRec(bird.position, bird.radius, blocks[i].rect)) {
-
-                    blocks[i].falling = true;
-
-                    // Calculate impact force based on bird velocity
-                    float impactForce = sqrt(bird.velocity.x * bird.velocity.x + bird.velocity.y * bird.velocity.y);
-
-                    blocks[i].velocity = (Vector2){
-                        bird.velocity.x * 0.3f + ((float)GetRandomValue(-2, 2)),
-                        -impactForce * 0.2f
-                    };
-                    blocks[i].angularVelocity = ((float)GetRandomValue(-30, 30)) / 10.0f;
-
-                    score += 10;
-
-                    // Reduce bird velocity after impact
-                    bird.velocity.x *= 0.7f;
-                    bird.velocity.y *= 0.7f;
-                }
-            }
+            EndDrawing();
+            continue;
         }
 
-        // Check victory condition
-        if (AllEnemiesDead() && !victory) {
-            victory = true;
-            if (currentLevel < totalLevels) {
-                currentState = LEVEL_COMPLETE;
-            }
+        if (IsKeyPressed(KEY_F3)) {
+            showAllocStats = !showAllocStats;
         }
 
         // Reset game
         if (IsKeyPressed(KEY_R)) {
-            ResetGame(&bird, &score, &lives, &gameOver);
-            victory = false;
-        }
+            // Rebuilding the level may allocate, so warm up again afterwards
+            AllocTrackerSetSteadyState(false);
+            gameFrames = 0;
 
-        // Block-block collision with improved physics
-        for (int i = 0; i < blockCount; i++) {
-            if (!blocks[i].active || !blocks[i].falling || blocks[i].onGround) continue;
-
-            for (int j = 0; j < blockCount; j++) {
-                if (i == j || !blocks[j].active || blocks[j].falling || blocks[j].onGround) continue;
-
-                if (CheckCollisionRecs(blocks[i].rect, blocks[j].rect)) {
-                    blocks[j].falling = true;
-
-                    // Transfer some momentum
-                    blocks[j].velocity = (Vector2){
-                        blocks[i].velocity.x * 0.5f + ((float)GetRandomValue(-1, 1)),
-                        -3.0f + ((float)GetRandomValue(-1, 1))
-                    };
-                    blocks[j].angularVelocity = ((float)GetRandomValue(-15, 15)) / 10.0f;
+            SimThreadWaitIdle();
+            BeginLevel(false);
+        }
 
-                    // Reduce original block's velocity
-                    blocks[i].velocity.x *= 0.8f;
-                    blocks[i].velocity.y *= 0.8f;
-                }
-            }
+        // The simulation steps this frame's input while the newest finished
+        // frame is drawn below, so a frame costs max(simulation, drawing)
+        SimInput input = {
+            deltaTime, GetMousePosition(),
+            IsMouseButtonPressed(MOUSE_LEFT_BUTTON), IsMouseButtonReleased(MOUSE_LEFT_BUTTON),
+            IsKeyPressed(KEY_U), IsKeyDown(KEY_LEFT), IsKeyDown(KEY_RIGHT), IsKeyPressed(KEY_SPACE)
+        };
+        SimThreadPost(&input);
+
+        const RenderSnapshot* view = RenderBufferLatest(&renderBuffer);
+
+        // Drawing; draw calls are counted per sprite or shape, starting with the background,
+        // ground, bird, slingshot, world upscale and HUD
+        AllocTrackerPushScope(ALLOC_RENDER);
+        unsigned int drawCalls = 6;
+
+        if (hudFrame++ % (unsigned int)QualityCurrent(&quality)->hudInterval == 0) {
+            BeginTextureMode(hud);
+            ClearBackground(BLANK);
+            DrawText("Angry Birds - Enhanced Edition", 20, 20, 30, RED);
+            DrawText(TextFormat("Score: %i", view->score), 20, 60, 20, DARKGRAY);
+            DrawText(TextFormat("Lives: %d", view->lives), 20, 90, 20, DARKBLUE);
+            DrawText(TextFormat("Level: %d/%d", view->level, totalLevels), 20, 120, 20, DARKGREEN);
+            DrawText("R to reset", 20, 150, 20, GRAY);
+
+            // Game instructions
+            DrawText("Bird: Instant kill | Blocks: 3 hits to kill", 20, 180, 16, DARKGRAY);
+            DrawText("Use mouse to aim and shoot", 20, 200, 16, DARKGRAY);
+            EndTextureMode();
         }
 
-        // Drawing
-        BeginDrawing();
+        // The world goes through the dynamic-resolution target, the UI on top of it stays native
+        DynamicResBegin(&dynamicRes);
         ClearBackground(RAYWHITE);
 
-        DrawTexture(background, 0, -200, WHITE);
+        DrawScaledTexture(background, (Rectangle){ 0.0f, -200.0f, 1536.0f, 1024.0f });
 
         // Ground
         Rectangle sourceRec = { 0.0f, 0.0f, (float)ground.width, (float)ground.height };
@@ -656,21 +1275,26 @@ int main(void) {
         Vector2 groundOrigin = { 0.0f, 0.0f };
         DrawTexturePro(ground, sourceRec, destRec, groundOrigin, 0.0f, WHITE);
 
-        // UI
-        DrawText("Angry Birds - Enhanced Edition", 20, 20, 30, RED);
-        DrawText(TextFormat("Score: %i", score), 20, 60, 20, DARKGRAY);
-        DrawText(TextFormat("Lives: %d", lives), 20, 90, 20, DARKBLUE);
-        DrawText(TextFormat("Level: %d/%d", currentLevel, totalLevels), 20, 120, 20, DARKGREEN);
-        DrawText("R to reset", 20, 150, 20, GRAY);
-
-        if (gameOver && !victory) {
-            DrawText("GAME OVER!", screenWidth / 2 - 100, screenHeight / 2, 40, RED);
-            DrawText("R - Try again", screenWidth / 2 - 100, screenHeight / 2 + 50, 20, GRAY);
-        }
-
-        if (victory && currentLevel >= totalLevels) {
-            DrawText("ALL LEVELS COMPLETE!", screenWidth / 2 - 150, screenHeight / 2 - 40, 40, DARKGREEN);
-            DrawText("R - Play again", screenWidth / 2 - 100, screenHeight / 2 + 10, 20, GRAY);
+        // The other player's world, translucent and behind this one
+        if (view->ghostVisible) {
+            for (int i = 0; i < view->ghostBlockCount; i++) {
+                const RenderBlock* block = &view->ghostBlocks[i];
+                if (!block->active) continue;
+
+                Rectangle dest = { block->rect.x + block->rect.width / 2.0f, block->rect.y + block->rect.height / 2.0f,
+                    block->rect.width, block->rect.height };
+                Vector2 origin = { block->rect.width / 2.0f, block->rect.height / 2.0f };
+                DrawRectanglePro(dest, origin, block->rotation * RAD2DEG,
+                    Fade((block->sprite == RENDER_SPRITE_TNT) ? RED : SKYBLUE, 0.35f));
+                drawCalls++;
+            }
+            for (int i = 0; i < view->ghostEnemyCount; i++) {
+                if (!view->ghostEnemies[i].active) continue;
+                DrawCircleV(view->ghostEnemies[i].position, view->ghostEnemies[i].radius, Fade(GREEN, 0.35f));
+                drawCalls++;
+            }
+            DrawCircleV(view->ghostBird.position, view->ghostBird.radius, Fade(RED, 0.35f));
+            drawCalls++;
         }
 
         // Draw bird
@@ -680,21 +1304,20 @@ int main(void) {
             0.0f, 0.0f, (float)birdTexture.width, (float)birdTexture.height
         },
             (Rectangle) {
-            bird.position.x, bird.position.y, (float)birdTexture.width, (float)birdTexture.height
+            view->bird.position.x, view->bird.position.y, (float)birdTexture.width, (float)birdTexture.height
         },
             birdOrigin, 0.0f, WHITE);
 
         // Draw enemies with health indication
-        for (int i = 0; i < enemyCount; i++) {
-            if (enemies[i].active) {
-                float enemyScale = 0.05f;
-                float enemyWidth = enemyTexture.width * enemyScale;
-                float enemyHeight = enemyTexture.height * enemyScale;
+        for (int i = 0; i < view->enemyCount; i++) {
+            if (view->enemies[i].active) {
+                float enemyWidth = enemyTexture.width * ENEMY_SPRITE_SCALE;
+                float enemyHeight = enemyTexture.height * ENEMY_SPRITE_SCALE;
 
                 Rectangle source = { 0.0f, 0.0f, (float)enemyTexture.width, (float)enemyTexture.height };
                 Rectangle dest = {
-                    enemies[i].position.x - enemyWidth / 1.2f,
-                    enemies[i].position.y - enemyHeight / 2.0f,
+                    view->enemies[i].position.x - enemyWidth * ENEMY_SPRITE_ANCHOR_X,
+                    view->enemies[i].position.y - enemyHeight * ENEMY_SPRITE_ANCHOR_Y,
                     enemyWidth, enemyHeight
                 };
                 Vector2 origin = { 0.0f, 0.0f };
@@ -703,44 +1326,69 @@ int main(void) {
 
                 // Draw health bar
                 Rectangle healthBar = {
-                    enemies[i].position.x - 20,
-                    enemies[i].position.y - 25,
+                    view->enemies[i].position.x - 20,
+                    view->enemies[i].position.y - 25,
                     40, 6
                 };
                 DrawRectangleRec(healthBar, RED);
 
                 Rectangle healthFill = {
                     healthBar.x, healthBar.y,
-                    healthBar.width * ((float)enemies[i].health / (float)enemies[i].maxHealth),
+                    healthBar.width * ((float)view->enemies[i].health / (float)view->enemies[i].maxHealth),
                     healthBar.height
                 };
                 DrawRectangleRec(healthFill, GREEN);
                 DrawRectangleLinesEx(healthBar, 1.0f, BLACK);
+                drawCalls += 4;
             }
         }
 
         // Draw blocks with improved rotation
-        for (int i = 0; i < blockCount; i++) {
-            if (blocks[i].active) {
-                Texture2D textureToDraw = (i % 2 == 0) ? blockTexture1 : blockTexture2;
+        for (int i = 0; i < view->blockCount; i++) {
+            if (view->blocks[i].active) {
+                Texture2D textureToDraw = (view->blocks[i].sprite == 1) ? blockTexture2 : blockTexture1;
+                Color tint = (view->blocks[i].sprite == RENDER_SPRITE_TNT) ? RED : WHITE;
 
                 Rectangle source = { 0.0f, 0.0f, (float)textureToDraw.width, (float)textureToDraw.height };
                 Rectangle dest = {
-                    blocks[i].rect.x + blocks[i].rect.width / 2.0f,
-                    blocks[i].rect.y + blocks[i].rect.height / 2.0f,
-                    blocks[i].rect.width,
-                    blocks[i].rect.height
+                    view->blocks[i].rect.x + view->blocks[i].rect.width / 2.0f,
+                    view->blocks[i].rect.y + view->blocks[i].rect.height / 2.0f,
+                    view->blocks[i].rect.width,
+                    view->blocks[i].rect.height
                 };
 
-                Vector2 origin = { blocks[i].rect.width / 2.0f, blocks[i].rect.height / 2.0f };
+                Vector2 origin = { view->blocks[i].rect.width / 2.0f, view->blocks[i].rect.height / 2.0f };
+
+                DrawTexturePro(textureToDraw, source, dest, origin, view->blocks[i].rotation * RAD2DEG, tint);
+                drawCalls++;
+            }
+        }
 
-                DrawTexturePro(textureToDraw, source, dest, origin, blocks[i].rotation * RAD2DEG, WHITE);
+        // Rods and ropes as lines, hinges and welds as pins
+        for (int i = 0; i < view->jointCount; i++) {
+            const RenderJoint* joint = &view->joints[i];
+            if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+                DrawLineEx(joint->from, joint->to, (joint->type == JOINT_ROPE) ? 2.0f : 4.0f,
+                    (joint->type == JOINT_ROPE) ? BROWN : DARKGRAY);
+            }
+            else {
+                DrawCircleV(joint->from, 5.0f, (joint->type == JOINT_WELD) ? DARKGRAY : BLACK);
             }
+            drawCalls++;
+        }
+
+        // Blasts fade out over EXPLOSION_FLASH_STEPS
+        for (int i = 0; i < view->flashCount; i++) {
+            float fade = 1.0f - (float)view->flashes[i].age / (float)EXPLOSION_FLASH_STEPS;
+            float radius = EXPLOSION_RADIUS * (0.4f + 0.6f * (1.0f - fade));
+            DrawCircleV(view->flashes[i].centre, radius, Fade(ORANGE, 0.6f * fade));
+            drawCalls++;
         }
 
         // Draw slingshot rope
-        if (!bird.launched) {
-            DrawLineEx((Vector2) { 150.0f, 400.0f }, bird.position, 3.0f, GRAY);
+        if (!view->bird.launched) {
+            DrawLineEx((Vector2) { 150.0f, 400.0f }, view->bird.position, 3.0f, GRAY);
+            drawCalls++;
         }
 
         // Draw slingshot
@@ -766,21 +1414,55 @@ int main(void) {
         }, 0.0f, WHITE);
 
         // Draw trajectory if enabled
-        if (!bird.launched && dragging && showTrajectory) {
+        if (!view->bird.launched && view->dragging && showTrajectory) {
             Vector2 velocity = {
-                (slingPos.x - bird.position.x) * 0.2f,
-                (slingPos.y - bird.position.y) * 0.2f
+                (slingPos.x - view->bird.position.x) * 0.2f,
+                (slingPos.y - view->bird.position.y) * 0.2f
             };
-            TrajectoryPoints trajPoints = CalculateTrajectory(slingPos, velocity, 50, 0.9f);
-            for (int i = 0; i < trajPoints.count; i++) {
+            // Fewer dots on lower tiers, spread over the same arc
+            int dots = QualityCurrent(&quality)->trajectoryDots;
+            float timeStep = TRAJECTORY_DURATION / (float)dots;
+            TrajectoryPoints trajPoints = CalculateTrajectory(slingPos, velocity, dots, timeStep);
+            for (int i = 0; i < trajPoints.count && i * timeStep <= view->aimHitTime; i++) {
                 float alpha = 1.0f - ((float)i / (float)trajPoints.count);
                 DrawCircleV(trajPoints.points[i], 2.0f, Fade(YELLOW, alpha));
+                drawCalls++;
             }
         }
 
-        // Draw game instructions
-        DrawText("Bird: Instant kill | Blocks: 3 hits to kill", 20, 180, 16, DARKGRAY);
-        DrawText("Use mouse to aim and shoot", 20, 200, 16, DARKGRAY);
+        DynamicResEnd();
+
+        BeginDrawing();
+        DynamicResDraw(&dynamicRes);
+
+        // UI (render textures are stored upside down)
+        DrawTextureRec(hud.texture, (Rectangle){ 0.0f, 0.0f, (float)hudWidth, (float)-hudHeight }, (Vector2){ 0.0f, 0.0f }, WHITE);
+
+        if (view->ghostVisible) {
+            DrawText(TextFormat("Ghost: %i", view->ghostScore), screenWidth - 260, 28, 20, Fade(DARKBLUE, 0.6f));
+        }
+
+        if (view->scrubbing) {
+            DrawText(TextFormat("REWIND - step %u (SPACE to resume)", view->simStep), screenWidth / 2 - 180, 20, 24, MAROON);
+        }
+
+        if (view->gameOver && !view->victory) {
+            DrawText("GAME OVER!", screenWidth / 2 - 100, screenHeight / 2, 40, RED);
+            DrawText("R - Try again", screenWidth / 2 - 100, screenHeight / 2 + 50, 20, GRAY);
+        }
+
+        if (view->victory && view->level >= totalLevels) {
+            DrawText("ALL LEVELS COMPLETE!", screenWidth / 2 - 150, screenHeight / 2 - 40, 40, DARKGREEN);
+            DrawText("R - Play again", screenWidth / 2 - 100, screenHeight / 2 + 10, 20, GRAY);
+        }
+
+        // Allocation stats of the previous frame (F3)
+        if (showAllocStats) {
+            DrawText(TextFormat("Allocs: %u (%u bytes) physics %u, render %u%s",
+                allocStats.totalCount, (unsigned int)allocStats.totalBytes,
+                allocStats.count[ALLOC_PHYSICS], allocStats.count[ALLOC_RENDER],
+                AllocTrackerInSteadyState() ? " [steady]" : ""), 20, 220, 16, MAROON);
+        }
 
         // Draw settings button in game
         Rectangle settingsBtn = { screenWidth - 100, 20, 80, 30 };
@@ -794,20 +1476,38 @@ int main(void) {
         // Draw settings window if open
         DrawSettingsWindow();
 
+        TelemetryCount(TELEMETRY_DRAW_CALLS, drawCalls);
+
+        float busyTime = (float)(GetTime() - frameStart);
         EndDrawing();
+        AllocTrackerPopScope();
+        allocStats = AllocTrackerEndFrame();
+
+        if (!wokeFromIdle) {
+            QualityObserve(&quality, deltaTime, busyTime, DynamicResAtMin(&dynamicRes), DynamicResAtMax(&dynamicRes));
+            DynamicResObserve(&dynamicRes, deltaTime);
+        }
     }
+    AllocTrackerPopScope();
 
     // Cleanup
-    UnloadTexture(background);
-    UnloadTexture(ground);
+    SimThreadStop();
+    GhostLinkClose(&ghostLink);
+    LevelPrefetchCancel();
+    TelemetryStop();
+    HotReloadShutdown();
+    UnloadRenderTexture(hud);
+    DynamicResUnload(&dynamicRes);
+    UnloadScaledTextures(backdrops, backdropCount);
     UnloadTexture(birdTexture);
     UnloadTexture(slingTexture);
     UnloadTexture(blockTexture1);
     UnloadTexture(blockTexture2);
     UnloadTexture(enemyTexture);
-    UnloadTexture(menuBackground);
     CloseAudioDevice();
 
+    AllocTrackerReport();
+
     CloseWindow();
     return 0;
 } 
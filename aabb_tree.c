@@ -0,0 +1,347 @@
+#include "aabb_tree.h"
+#include <math.h>
+
+static AABB Union(AABB a, AABB b) {
+    return (AABB){ { fminf(a.min.x, b.min.x), fminf(a.min.y, b.min.y) },
+        { fmaxf(a.max.x, b.max.x), fmaxf(a.max.y, b.max.y) } };
+}
+
+static float Perimeter(AABB box) {
+    return 2.0f * ((box.max.x - box.min.x) + (box.max.y - box.min.y));
+}
+
+static bool Contains(AABB outer, AABB inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+        inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+}
+
+static bool Overlaps(AABB a, AABB b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+static bool IsLeaf(const AabbNode* node) {
+    return node->child1 == AABB_TREE_NULL;
+}
+
+void AabbTreeInit(AabbTree* tree, AabbNode* nodes, int capacity) {
+    tree->nodes = nodes;
+    tree->capacity = capacity;
+    tree->root = AABB_TREE_NULL;
+    tree->leafCount = 0;
+
+    for (int i = 0; i < capacity; i++) {
+        nodes[i].next = (i + 1 < capacity) ? i + 1 : AABB_TREE_NULL;
+        nodes[i].height = -1;
+    }
+    tree->freeList = (capacity > 0) ? 0 : AABB_TREE_NULL;
+}
+
+static int AllocateNode(AabbTree* tree) {
+    int index = tree->freeList;
+    if (index == AABB_TREE_NULL) return AABB_TREE_NULL;
+
+    AabbNode* node = &tree->nodes[index];
+    tree->freeList = node->next;
+    node->parent = AABB_TREE_NULL;
+    node->child1 = AABB_TREE_NULL;
+    node->child2 = AABB_TREE_NULL;
+    node->height = 0;
+    node->userData = -1;
+    return index;
+}
+
+static void FreeNode(AabbTree* tree, int index) {
+    tree->nodes[index].next = tree->freeList;
+    tree->nodes[index].height = -1;
+    tree->freeList = index;
+}
+
+static void ReplaceChild(AabbTree* tree, int parent, int oldChild, int newChild) {
+    if (parent == AABB_TREE_NULL) {
+        tree->root = newChild;
+    }
+    else if (tree->nodes[parent].child1 == oldChild) {
+        tree->nodes[parent].child1 = newChild;
+    }
+    else {
+        tree->nodes[parent].child2 = newChild;
+    }
+}
+
+static int MaxHeight(const AabbTree* tree, int a, int b) {
+    int heightA = tree->nodes[a].height;
+    int heightB = tree->nodes[b].height;
+    return heightA > heightB ? heightA : heightB;
+}
+
+// Function to rotate the taller grandchild of A up when A's subtrees differ in height by more than one.
+// Returns the node now at A's place.
+static int Balance(AabbTree* tree, int iA) {
+    AabbNode* nodes = tree->nodes;
+    AabbNode* A = &nodes[iA];
+    if (IsLeaf(A) || A->height < 2) return iA;
+
+    int iB = A->child1;
+    int iC = A->child2;
+    int balance = nodes[iC].height - nodes[iB].height;
+
+    if (balance > 1) {
+        // C goes up, A becomes its first child
+        AabbNode* C = &nodes[iC];
+        int iF = C->child1;
+        int iG = C->child2;
+
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+        ReplaceChild(tree, C->parent, iA, iC);
+
+        // A keeps B and the shorter of F and G
+        int iTall = (nodes[iF].height > nodes[iG].height) ? iF : iG;
+        int iShort = (iTall == iF) ? iG : iF;
+        C->child2 = iTall;
+        A->child2 = iShort;
+        nodes[iShort].parent = iA;
+
+        A->box = Union(nodes[iB].box, nodes[iShort].box);
+        A->height = 1 + MaxHeight(tree, iB, iShort);
+        C->box = Union(A->box, nodes[iTall].box);
+        C->height = 1 + MaxHeight(tree, iA, iTall);
+        return iC;
+    }
+
+    if (balance < -1) {
+        // B goes up, A becomes its first child
+        AabbNode* B = &nodes[iB];
+        int iD = B->child1;
+        int iE = B->child2;
+
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+        ReplaceChild(tree, B->parent, iA, iB);
+
+        // A keeps C and the shorter of D and E
+        int iTall = (nodes[iD].height > nodes[iE].height) ? iD : iE;
+        int iShort = (iTall == iD) ? iE : iD;
+        B->child2 = iTall;
+        A->child1 = iShort;
+        nodes[iShort].parent = iA;
+
+        A->box = Union(nodes[iC].box, nodes[iShort].box);
+        A->height = 1 + MaxHeight(tree, iC, iShort);
+        B->box = Union(A->box, nodes[iTall].box);
+        B->height = 1 + MaxHeight(tree, iA, iTall);
+        return iB;
+    }
+
+    return iA;
+}
+
+// Function to refit boxes and heights from index up to the root, rebalancing on the way
+static void Refit(AabbTree* tree, int index) {
+    while (index != AABB_TREE_NULL) {
+        index = Balance(tree, index);
+
+        AabbNode* node = &tree->nodes[index];
+        node->box = Union(tree->nodes[node->child1].box, tree->nodes[node->child2].box);
+        node->height = 1 + MaxHeight(tree, node->child1, node->child2);
+        index = node->parent;
+    }
+}
+
+// Function to pick the sibling that grows the tree's total perimeter least, then pair the leaf with it
+static bool InsertLeaf(AabbTree* tree, int leaf) {
+    AabbNode* nodes = tree->nodes;
+
+    if (tree->root == AABB_TREE_NULL) {
+        tree->root = leaf;
+        nodes[leaf].parent = AABB_TREE_NULL;
+        return true;
+    }
+
+    AABB leafBox = nodes[leaf].box;
+    int index = tree->root;
+    while (!IsLeaf(&nodes[index])) {
+        const AabbNode* node = &nodes[index];
+        float area = Perimeter(node->box);
+        float combinedArea = Perimeter(Union(node->box, leafBox));
+
+        // Making a new parent here, versus pushing the leaf further down
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCost[2];
+        int children[2] = { node->child1, node->child2 };
+        for (int i = 0; i < 2; i++) {
+            const AabbNode* child = &nodes[children[i]];
+            float grown = Perimeter(Union(leafBox, child->box));
+            childCost[i] = (IsLeaf(child) ? grown : grown - Perimeter(child->box)) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1]) break;
+        index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    int sibling = index;
+    int newParent = AllocateNode(tree);
+    if (newParent == AABB_TREE_NULL) return false;
+
+    int oldParent = nodes[sibling].parent;
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = Union(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    ReplaceChild(tree, oldParent, sibling, newParent);
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    Refit(tree, oldParent);
+    return true;
+}
+
+static void RemoveLeaf(AabbTree* tree, int leaf) {
+    AabbNode* nodes = tree->nodes;
+
+    if (leaf == tree->root) {
+        tree->root = AABB_TREE_NULL;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+    // The sibling takes the parent's place
+    ReplaceChild(tree, grandParent, parent, sibling);
+    nodes[sibling].parent = grandParent;
+    FreeNode(tree, parent);
+
+    Refit(tree, grandParent);
+}
+
+int AabbTreeInsert(AabbTree* tree, AABB box, int userData) {
+    int proxy = AllocateNode(tree);
+    if (proxy == AABB_TREE_NULL) return AABB_TREE_NULL;
+
+    AabbNode* node = &tree->nodes[proxy];
+    node->box = (AABB){ { box.min.x - AABB_TREE_MARGIN, box.min.y - AABB_TREE_MARGIN },
+        { box.max.x + AABB_TREE_MARGIN, box.max.y + AABB_TREE_MARGIN } };
+    node->userData = userData;
+
+    if (!InsertLeaf(tree, proxy)) {
+        FreeNode(tree, proxy);
+        return AABB_TREE_NULL;
+    }
+    tree->leafCount++;
+    return proxy;
+}
+
+void AabbTreeRemove(AabbTree* tree, int proxy) {
+    RemoveLeaf(tree, proxy);
+    FreeNode(tree, proxy);
+    tree->leafCount--;
+}
+
+bool AabbTreeMove(AabbTree* tree, int proxy, AABB box, Vector2 displacement) {
+    AabbNode* node = &tree->nodes[proxy];
+    if (Contains(node->box, box)) return false;
+
+    RemoveLeaf(tree, proxy);
+
+    // Fatten, and stretch the box the way the body is heading so it stays valid for a few steps
+    AABB fat = { { box.min.x - AABB_TREE_MARGIN, box.min.y - AABB_TREE_MARGIN },
+        { box.max.x + AABB_TREE_MARGIN, box.max.y + AABB_TREE_MARGIN } };
+    Vector2 ahead = { displacement.x * AABB_TREE_PREDICTION, displacement.y * AABB_TREE_PREDICTION };
+    if (ahead.x < 0.0f) fat.min.x += ahead.x; else fat.max.x += ahead.x;
+    if (ahead.y < 0.0f) fat.min.y += ahead.y; else fat.max.y += ahead.y;
+    node->box = fat;
+
+    // Removing freed a node, so there is always room to reinsert
+    InsertLeaf(tree, proxy);
+    return true;
+}
+
+// Depth-first walk over the nodes whose box passes test(); leaves go to the callback
+#define AABB_TREE_WALK(tree, test, callback, context)                                   \
+    do {                                                                                \
+        int stack[AABB_TREE_STACK];                                                     \
+        int count = 0;                                                                  \
+        if ((tree)->root != AABB_TREE_NULL) stack[count++] = (tree)->root;              \
+        while (count > 0) {                                                             \
+            const AabbNode* node = &(tree)->nodes[stack[--count]];                      \
+            if (!(test)) continue;                                                      \
+            if (IsLeaf(node)) {                                                         \
+                if (!(callback)(node->userData, (context))) return;                     \
+            }                                                                           \
+            else if (count + 2 <= AABB_TREE_STACK) {                                    \
+                stack[count++] = node->child1;                                          \
+                stack[count++] = node->child2;                                          \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+void AabbTreeQueryAABB(const AabbTree* tree, AABB box, AabbQueryCallback callback, void* context) {
+    AABB_TREE_WALK(tree, Overlaps(node->box, box), callback, context);
+}
+
+static bool OverlapsCircle(AABB box, Vector2 centre, float radius) {
+    float dx = centre.x - fmaxf(box.min.x, fminf(centre.x, box.max.x));
+    float dy = centre.y - fmaxf(box.min.y, fminf(centre.y, box.max.y));
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+void AabbTreeQueryCircle(const AabbTree* tree, Vector2 centre, float radius, AabbQueryCallback callback, void* context) {
+    AABB_TREE_WALK(tree, OverlapsCircle(node->box, centre, radius), callback, context);
+}
+
+void AabbTreeQueryPoint(const AabbTree* tree, Vector2 point, AabbQueryCallback callback, void* context) {
+    AABB_TREE_WALK(tree, (point.x >= node->box.min.x && point.x <= node->box.max.x &&
+        point.y >= node->box.min.y && point.y <= node->box.max.y), callback, context);
+}
+
+float AabbSegmentFraction(AABB box, Vector2 from, Vector2 to, float maxFraction) {
+    const Vector2 delta = { to.x - from.x, to.y - from.y };
+    float enter = 0.0f;
+    float leave = maxFraction;
+    const float start[2] = { from.x, from.y };
+    const float d[2] = { delta.x, delta.y };
+    const float low[2] = { box.min.x, box.min.y };
+    const float high[2] = { box.max.x, box.max.y };
+
+    for (int axis = 0; axis < 2; axis++) {
+        if (fabsf(d[axis]) < 1e-9f) {
+            if (start[axis] < low[axis] || start[axis] > high[axis]) return -1.0f;
+            continue;
+        }
+        float t1 = (low[axis] - start[axis]) / d[axis];
+        float t2 = (high[axis] - start[axis]) / d[axis];
+        enter = fmaxf(enter, fminf(t1, t2));
+        leave = fminf(leave, fmaxf(t1, t2));
+        if (enter > leave) return -1.0f;
+    }
+    return enter;
+}
+
+void AabbTreeRaycast(const AabbTree* tree, Vector2 from, Vector2 to, AabbRaycastCallback callback, void* context) {
+    float maxFraction = 1.0f;
+    int stack[AABB_TREE_STACK];
+    int count = 0;
+
+    if (tree->root != AABB_TREE_NULL) stack[count++] = tree->root;
+    while (count > 0) {
+        const AabbNode* node = &tree->nodes[stack[--count]];
+        if (AabbSegmentFraction(node->box, from, to, maxFraction) < 0.0f) continue;
+
+        if (IsLeaf(node)) {
+            float fraction = callback(node->userData, from, to, maxFraction, context);
+            if (fraction <= 0.0f) return;
+            if (fraction < maxFraction) maxFraction = fraction;
+        }
+        else if (count + 2 <= AABB_TREE_STACK) {
+            stack[count++] = node->child1;
+            stack[count++] = node->child2;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef AABB_TREE_H
+#define AABB_TREE_H
+
+#include "raylib.h"
+
+#define AABB_TREE_NULL -1
+#define AABB_TREE_MARGIN 4.0f        // leaves are fattened by this, so small moves need no refit
+#define AABB_TREE_PREDICTION 2.0f    // ... and stretched this many steps along their velocity
+#define AABB_TREE_STACK 256
+
+typedef struct {
+    Vector2 min;
+    Vector2 max;
+} AABB;
+
+typedef struct {
+    AABB box;        // fattened for leaves
+    int parent;
+    int child1;      // AABB_TREE_NULL for leaves
+    int child2;
+    int height;      // 0 for leaves, -1 while on the free list
+    int next;        // free list link
+    int userData;
+} AabbNode;
+
+// Dynamic bounding-volume hierarchy (Box2D style): leaves are inserted where
+// they grow the tree's perimeter least, and rotations keep it balanced.
+// Node storage is owned by the caller; inserts fail once it is full.
+typedef struct {
+    AabbNode* nodes;
+    int capacity;
+    int root;
+    int freeList;
+    int leafCount;
+} AabbTree;
+
+// A tree holding n leaves needs 2n - 1 nodes
+void AabbTreeInit(AabbTree* tree, AabbNode* nodes, int capacity);
+
+// Returns the new leaf (proxy), or AABB_TREE_NULL when the tree is full
+int AabbTreeInsert(AabbTree* tree, AABB box, int userData);
+void AabbTreeRemove(AabbTree* tree, int proxy);
+
+// Refits a leaf that moved. Nothing happens while box stays inside the fat
+// box; returns true when the leaf was reinserted.
+bool AabbTreeMove(AabbTree* tree, int proxy, AABB box, Vector2 displacement);
+
+// Query callbacks get the userData of each leaf whose fat box matches and
+// return false to stop the query early
+typedef bool (*AabbQueryCallback)(int userData, void* context);
+void AabbTreeQueryAABB(const AabbTree* tree, AABB box, AabbQueryCallback callback, void* context);
+void AabbTreeQueryCircle(const AabbTree* tree, Vector2 centre, float radius, AabbQueryCallback callback, void* context);
+void AabbTreeQueryPoint(const AabbTree* tree, Vector2 point, AabbQueryCallback callback, void* context);
+
+// Where the segment from -> to enters box, as a fraction of its length up
+// to maxFraction (0 when it starts inside); -1 when it misses
+float AabbSegmentFraction(AABB box, Vector2 from, Vector2 to, float maxFraction);
+
+// Raycast from -> to. The callback tests its leaf exactly and returns the
+// fraction of the segment to keep searching: 0 stops, the hit's fraction
+// clips the ray to it, and maxFraction ignores the leaf.
+typedef float (*AabbRaycastCallback)(int userData, Vector2 from, Vector2 to, float maxFraction, void* context);
+void AabbTreeRaycast(const AabbTree* tree, Vector2 from, Vector2 to, AabbRaycastCallback callback, void* context);
+
+#endif
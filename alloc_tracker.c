@@ -0,0 +1,246 @@
+#include "alloc_tracker.h"
+#include "raylib.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MAX_SCOPE_DEPTH 16
+
+// The simulation thread and raylib's audio mixer allocate too: scopes are
+// per thread, the shared tables are updated under a spin lock (recording is
+// rare once warmed up). The main thread switches steady state while the
+// other threads read it.
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define THREAD_LOCAL __declspec(thread)
+static volatile long recordLock = 0;
+#define LockRecords() while (_InterlockedExchange(&recordLock, 1)) {}
+#define UnlockRecords() _InterlockedExchange(&recordLock, 0)
+static volatile long steadyState = 0;
+#define LoadSteadyState() (_InterlockedOr(&steadyState, 0) != 0)
+#define StoreSteadyState(enabled) _InterlockedExchange(&steadyState, (enabled) ? 1 : 0)
+#else
+#include <stdatomic.h>
+#define THREAD_LOCAL _Thread_local
+static atomic_flag recordLock = ATOMIC_FLAG_INIT;
+#define LockRecords() while (atomic_flag_test_and_set_explicit(&recordLock, memory_order_acquire)) {}
+#define UnlockRecords() atomic_flag_clear_explicit(&recordLock, memory_order_release)
+static atomic_bool steadyState = false;
+#define LoadSteadyState() atomic_load(&steadyState)
+#define StoreSteadyState(enabled) atomic_store(&steadyState, (enabled))
+#endif
+
+// With malloc wrapped, the tracker's own blocks come straight from the C library
+#ifdef ALLOC_TRACKER_WRAP_MALLOC
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+#define RawMalloc __real_malloc
+#else
+#define RawMalloc malloc
+#endif
+
+// Prefix stored in front of every tracked block so frees know the size
+typedef union {
+    size_t size;
+    max_align_t align;
+} AllocHeader;
+
+static AllocSite sites[MAX_ALLOC_SITES];
+static int siteCount = 0;
+static unsigned int droppedSites = 0;
+
+static AllocFrameStats frameStats;
+
+typedef struct {
+    AllocSubsystem subsystem;
+    const char* file;
+    int line;
+} AllocScope;
+
+static THREAD_LOCAL AllocScope scopeStack[MAX_SCOPE_DEPTH];
+static THREAD_LOCAL int scopeDepth = 0;
+static THREAD_LOCAL bool loaderThread = false;
+static THREAD_LOCAL bool recording = false;  // set while the tracker itself may call into malloc
+
+static const char* subsystemNames[ALLOC_SUBSYSTEM_COUNT] = {
+    "core", "physics", "render", "assets", "ui", "audio"
+};
+
+// Function to find or insert the site entry for file:line (open addressing)
+static AllocSite* FindSite(const char* file, int line, AllocSubsystem subsystem) {
+    uintptr_t hash = ((uintptr_t)file >> 3) * 31u + (uintptr_t)line;
+    int slot = (int)(hash % MAX_ALLOC_SITES);
+
+    for (int probe = 0; probe < MAX_ALLOC_SITES; probe++) {
+        AllocSite* site = &sites[(slot + probe) % MAX_ALLOC_SITES];
+
+        if (site->file == file && site->line == line && site->subsystem == subsystem) {
+            return site;
+        }
+        if (site->file == NULL) {
+            site->file = file;
+            site->line = line;
+            site->subsystem = subsystem;
+            siteCount++;
+            return site;
+        }
+    }
+
+    droppedSites++;
+    return NULL;
+}
+
+void AllocTrackerRecord(size_t size, AllocSubsystem subsystem, const char* file, int line) {
+    if (subsystem < 0 || subsystem >= ALLOC_SUBSYSTEM_COUNT) subsystem = ALLOC_CORE;
+    if (file == NULL) file = "<unknown>";
+
+    const bool steady = LoadSteadyState() && !loaderThread;
+    bool firstSteadyHit = steady;
+
+    LockRecords();
+    frameStats.count[subsystem]++;
+    frameStats.bytes[subsystem] += size;
+    frameStats.totalCount++;
+    frameStats.totalBytes += size;
+
+    AllocSite* site = FindSite(file, line, subsystem);
+    if (site != NULL) {
+        site->count++;
+        site->bytes += size;
+        // A site that also allocated while warming up is still reported on its first steady-state hit
+        if (steady) firstSteadyHit = (++site->steadyCount == 1);
+    }
+    UnlockRecords();
+
+    if (steady) {
+        recording = true;
+#if ALLOC_TRACKER_FAIL_FAST
+        (void)firstSteadyHit;  // the first hit is already fatal
+        TraceLog(LOG_FATAL, "ALLOC: %zu bytes allocated in steady state at %s:%d (%s)",
+            size, file, line, subsystemNames[subsystem]);
+        abort();
+#else
+        if (firstSteadyHit) {
+            TraceLog(LOG_WARNING, "ALLOC: %zu bytes allocated in steady state at %s:%d (%s)",
+                size, file, line, subsystemNames[subsystem]);
+        }
+#endif
+        recording = false;
+    }
+}
+
+void AllocTrackerRecordInScope(size_t size) {
+    if (recording) return;
+
+    if (scopeDepth == 0) {
+        AllocTrackerRecord(size, ALLOC_CORE, "<no scope>", 0);
+        return;
+    }
+    const AllocScope* scope = &scopeStack[(scopeDepth > MAX_SCOPE_DEPTH) ? MAX_SCOPE_DEPTH - 1 : scopeDepth - 1];
+    AllocTrackerRecord(size, scope->subsystem, scope->file, scope->line);
+}
+
+void AllocTrackerSetLoaderThread(void) {
+    loaderThread = true;
+}
+
+void* TrackedAlloc(size_t size, AllocSubsystem subsystem, const char* file, int line) {
+    AllocHeader* header = (AllocHeader*)RawMalloc(sizeof(AllocHeader) + size);
+    if (header == NULL) return NULL;
+
+    header->size = size;
+    AllocTrackerRecord(size, subsystem, file, line);
+    return header + 1;
+}
+
+void TrackedFree(void* ptr) {
+    if (ptr == NULL) return;
+    free((AllocHeader*)ptr - 1);
+}
+
+void AllocTrackerPushScopeAt(AllocSubsystem subsystem, const char* file, int line) {
+    if (scopeDepth < MAX_SCOPE_DEPTH) {
+        scopeStack[scopeDepth] = (AllocScope){ subsystem, file, line };
+    }
+    scopeDepth++;
+}
+
+void AllocTrackerPopScope(void) {
+    if (scopeDepth > 0) scopeDepth--;
+}
+
+AllocSubsystem AllocTrackerCurrentScope(void) {
+    if (scopeDepth == 0) return ALLOC_CORE;
+    if (scopeDepth > MAX_SCOPE_DEPTH) return scopeStack[MAX_SCOPE_DEPTH - 1].subsystem;
+    return scopeStack[scopeDepth - 1].subsystem;
+}
+
+void AllocTrackerBeginFrame(void) {
+    LockRecords();
+    frameStats = (AllocFrameStats){ 0 };
+    UnlockRecords();
+}
+
+AllocFrameStats AllocTrackerEndFrame(void) {
+    LockRecords();
+    AllocFrameStats stats = frameStats;
+    UnlockRecords();
+    return stats;
+}
+
+void AllocTrackerSetSteadyState(bool enabled) {
+    if (enabled && !LoadSteadyState()) {
+        TraceLog(LOG_INFO, "ALLOC: entering steady state, further allocations are errors");
+    }
+    StoreSteadyState(enabled);
+}
+
+bool AllocTrackerInSteadyState(void) {
+    return LoadSteadyState();
+}
+
+int AllocTrackerGetSites(const AllocSite** outSites) {
+    *outSites = sites;
+    return MAX_ALLOC_SITES;
+}
+
+const char* AllocSubsystemName(AllocSubsystem subsystem) {
+    if (subsystem < 0 || subsystem >= ALLOC_SUBSYSTEM_COUNT) return "?";
+    return subsystemNames[subsystem];
+}
+
+// Function to log every call site that has allocated so far
+void AllocTrackerReport(void) {
+    TraceLog(LOG_INFO, "ALLOC: %d call sites", siteCount);
+
+    for (int i = 0; i < MAX_ALLOC_SITES; i++) {
+        if (sites[i].file == NULL) continue;
+        TraceLog(LOG_INFO, "ALLOC:   %-8s %6u allocs %10zu bytes  %s:%d",
+            subsystemNames[sites[i].subsystem], sites[i].count, sites[i].bytes,
+            sites[i].file, sites[i].line);
+    }
+
+    if (droppedSites > 0) {
+        TraceLog(LOG_WARNING, "ALLOC: %u allocations had no free site slot", droppedSites);
+    }
+}
+
+#ifdef ALLOC_TRACKER_WRAP_MALLOC
+
+// The linker sends every other malloc, calloc and realloc call here
+void* __wrap_malloc(size_t size) {
+    AllocTrackerRecordInScope(size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    AllocTrackerRecordInScope(count * size);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    AllocTrackerRecordInScope(size);
+    return __real_realloc(ptr, size);
+}
+
+#endif
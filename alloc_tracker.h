@@ -0,0 +1,93 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_ALLOC_SITES 128
+
+// In fail-fast mode an allocation during steady state aborts the game,
+// otherwise it is logged once per call site
+#ifndef ALLOC_TRACKER_FAIL_FAST
+#ifdef NDEBUG
+#define ALLOC_TRACKER_FAIL_FAST 0
+#else
+#define ALLOC_TRACKER_FAIL_FAST 1
+#endif
+#endif
+
+typedef enum {
+    ALLOC_CORE,
+    ALLOC_PHYSICS,
+    ALLOC_RENDER,
+    ALLOC_ASSETS,
+    ALLOC_UI,
+    ALLOC_AUDIO,
+    ALLOC_SUBSYSTEM_COUNT
+} AllocSubsystem;
+
+typedef struct {
+    const char* file;
+    int line;
+    AllocSubsystem subsystem;
+    unsigned int count;        // allocations since startup
+    unsigned int steadyCount;  // of those, made in steady state
+    size_t bytes;
+} AllocSite;
+
+typedef struct {
+    unsigned int count[ALLOC_SUBSYSTEM_COUNT];
+    size_t bytes[ALLOC_SUBSYSTEM_COUNT];
+    unsigned int totalCount;
+    size_t totalBytes;
+} AllocFrameStats;
+
+// Allocations made through these are counted and attributed to their call site
+#define GAME_ALLOC(subsystem, size) TrackedAlloc((size), (subsystem), __FILE__, __LINE__)
+#define GAME_FREE(ptr) TrackedFree(ptr)
+
+void* TrackedAlloc(size_t size, AllocSubsystem subsystem, const char* file, int line);
+void TrackedFree(void* ptr);
+
+// Records an allocation made by another allocator (e.g. operator new)
+void AllocTrackerRecord(size_t size, AllocSubsystem subsystem, const char* file, int line);
+
+// Subsystem and call site for allocations that can't name one: raylib's,
+// the C library's and operator new. They are attributed to the line that
+// pushed the innermost scope.
+#define AllocTrackerPushScope(subsystem) AllocTrackerPushScopeAt((subsystem), __FILE__, __LINE__)
+void AllocTrackerPushScopeAt(AllocSubsystem subsystem, const char* file, int line);
+void AllocTrackerPopScope(void);
+AllocSubsystem AllocTrackerCurrentScope(void);
+
+// Builds linked with -DALLOC_TRACKER_WRAP_MALLOC and
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (the Makefile's default)
+// send every malloc in the program, raylib's included when it is linked
+// statically, through the current scope. This records one.
+void AllocTrackerRecordInScope(size_t size);
+
+// Marks the calling thread as a loader (asset decoding, level prefetch):
+// its allocations are counted but never steady-state errors, as they
+// don't run on the frame
+void AllocTrackerSetLoaderThread(void);
+
+void AllocTrackerBeginFrame(void);
+AllocFrameStats AllocTrackerEndFrame(void);
+
+// While enabled, every allocation is a regression
+void AllocTrackerSetSteadyState(bool enabled);
+bool AllocTrackerInSteadyState(void);
+
+int AllocTrackerGetSites(const AllocSite** sites);
+const char* AllocSubsystemName(AllocSubsystem subsystem);
+void AllocTrackerReport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
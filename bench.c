@@ -0,0 +1,862 @@
+#include "bench.h"
+#include "game.h"
+#include "fixed_physics.h"
+#include "aabb_tree.h"
+#include "narrow_phase.h"
+#include "explosion.h"
+#include "joints.h"
+#include "ghost.h"
+#include "env_batch.h"
+#include "occupancy.h"
+#include "integrator.h"
+#include "materials.h"
+#include "spatial.h"
+#include "level.h"
+#include "alloc_tracker.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define PHYSICS_BENCH_RUNS 200
+#define PHYSICS_BENCH_STEPS 600 // one 10 s shot per run
+
+#define TREE_BENCH_STEPS 30
+#define TREE_BENCH_RAYS 512
+
+#define NARROW_BENCH_REPEATS 2000
+
+#define BLAST_BENCH_RUNS 2000
+
+#define JOINT_BENCH_STEPS 300
+#define JOINT_BENCH_LINKS 10      // planks per chain
+#define JOINT_BENCH_PLANK 30.0f
+#define JOINT_BENCH_GRAVITY 0.3f
+
+#define GHOST_BENCH_STEPS 600
+#define GHOST_BENCH_BLOCKS 80
+#define GHOST_BENCH_ENEMIES 20
+#define GHOST_BENCH_PORT 47301    // and the next one, on 127.0.0.1
+
+#define ENV_BENCH_WORLDS 256
+#define ENV_BENCH_STEPS 4000
+
+#define OCCUPANCY_BENCH_FRAMES 20000
+#define OCCUPANCY_BENCH_BLOCKS 100
+
+#define INTEGRATOR_BENCH_FLIGHT 120.0f  // 60 Hz steps of flight, 2 s
+#define INTEGRATOR_BENCH_BODIES 4096
+#define INTEGRATOR_BENCH_STEPS 1000
+
+// Eight crates in a row under three enemies; the first one is set off
+#define BLAST_BENCH_LEVEL \
+    "block 700 500 40 40 tnt\nblock 780 500 40 40 tnt\nblock 860 500 40 40 tnt\nblock 940 500 40 40 tnt\n" \
+    "block 1020 500 40 40 tnt\nblock 1100 500 40 40 tnt\nblock 1180 500 40 40 tnt\nblock 1260 500 40 40 tnt\n" \
+    "block 820 430 120 30 wood\nblock 1060 430 120 30 stone\n" \
+    "enemy 880 400 15\nenemy 1120 400 15\nenemy 1280 470 15\n"
+
+// Game-side state and listeners from FileName.c, so the float path resolves
+// damage and score exactly as it does in the game
+extern EventQueue gameEvents;
+void ResolveCombatEvents(const GameEvent* events, int count, void* userData);
+void ApplyScoreEvents(const GameEvent* events, int count, void* userData);
+
+typedef struct {
+    const char* name;
+    const char* description;
+    void (*run)(void);
+} Benchmark;
+
+long long BenchNow(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Same level and shot on both paths: a launch into the level 1 tower
+static void BenchPhysics(void) {
+    const int pullX = 70;
+    const int pullY = 430;
+    long long floatTime = 0;
+    long long fixedTime = 0;
+    int floatScore = 0;
+    FixedWorld world;
+
+    // Both worlds set off the level's TNT, the float one through this listener
+    EventQueueInit(&gameEvents);
+    ClearEventListeners();
+    AddEventListener(ResolveCombatEvents, NULL);
+    AddEventListener(ApplyScoreEvents, &floatScore);
+    AddEventListener(TriggerExplosives, NULL);
+
+    for (int run = 0; run < PHYSICS_BENCH_RUNS; run++) {
+        Bird bird = { { (float)pullX, (float)pullY }, { 0.0f, 0.0f }, true, 15.0f };
+        bird.velocity = (Vector2){ (150.0f - bird.position.x) * 0.2f, (400.0f - bird.position.y) * 0.2f };
+        int lives = 3;
+        bool gameOver = false;
+        bool victory = false;
+        floatScore = 0;
+
+        InitializeEnemies(1);
+        InitializeBlocks(1);
+        ClearExplosions();
+        SeedGameRandom(12345);
+
+        long long start = BenchNow();
+        for (int step = 0; step < PHYSICS_BENCH_STEPS; step++) {
+            UpdateWorld(&bird, &lives, &gameOver, &victory, 1.0f / 60.0f);
+        }
+        floatTime += BenchNow() - start;
+    }
+    ClearEventListeners();
+
+    for (int run = 0; run < PHYSICS_BENCH_RUNS; run++) {
+        InitializeEnemies(1);
+        InitializeBlocks(1);
+        FixedWorldReset(&world, 12345);
+        FixedWorldLaunch(&world, pullX, pullY);
+
+        long long start = BenchNow();
+        for (int step = 0; step < PHYSICS_BENCH_STEPS; step++) {
+            FixedWorldStep(&world, NULL);
+        }
+        fixedTime += BenchNow() - start;
+    }
+
+    const double steps = (double)PHYSICS_BENCH_RUNS * PHYSICS_BENCH_STEPS;
+    printf("physics: %d runs x %d steps\n", PHYSICS_BENCH_RUNS, PHYSICS_BENCH_STEPS);
+    printf("  float  %8.1f ns/step (score %d)\n", floatTime / steps, floatScore);
+    printf("  fixed  %8.1f ns/step (score %d, hash %016llx)\n", fixedTime / steps,
+        world.score, FixedWorldHash(&world));
+    printf("  fixed/float %.2fx\n", (double)fixedTime / (double)(floatTime > 0 ? floatTime : 1));
+}
+
+// Small xorshift so the benchmarks don't disturb the game's random stream
+static unsigned int benchRandom = 2463534242u;
+
+static float BenchRandom(float low, float high) {
+    benchRandom ^= benchRandom << 13;
+    benchRandom ^= benchRandom >> 17;
+    benchRandom ^= benchRandom << 5;
+    return low + (high - low) * (float)(benchRandom & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+typedef struct {
+    const AABB* boxes;
+    int self;
+    int hits;
+    float closest;
+} TreeBenchQuery;
+
+static bool BoxesOverlap(AABB a, AABB b) {
+    return a.min.x < b.max.x && b.min.x < a.max.x && a.min.y < b.max.y && b.min.y < a.max.y;
+}
+
+static bool CountOverlap(int userData, void* context) {
+    TreeBenchQuery* query = (TreeBenchQuery*)context;
+    if (userData != query->self && BoxesOverlap(query->boxes[userData], query->boxes[query->self])) query->hits++;
+    return true;
+}
+
+static float ClosestHit(int userData, Vector2 from, Vector2 to, float maxFraction, void* context) {
+    TreeBenchQuery* query = (TreeBenchQuery*)context;
+    float fraction = AabbSegmentFraction(query->boxes[userData], from, to, maxFraction);
+    if (fraction < 0.0f) return maxFraction;
+
+    query->closest = fraction;
+    return fraction;
+}
+
+// Moving boxes at constant density: every box looks for its overlaps each step, then
+// random rays look for their first hit, through the tree and by scanning every box
+static void BenchAabbTree(void) {
+    const int sizes[] = { 64, 256, 1024, 4096 };
+
+    printf("aabbtree: %d steps of moving boxes, then %d rays\n", TREE_BENCH_STEPS, TREE_BENCH_RAYS);
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        const int count = sizes[s];
+        const float side = sqrtf((float)count) * 60.0f;
+
+        AABB* boxes = (AABB*)GAME_ALLOC(ALLOC_CORE, sizeof(AABB) * count);
+        Vector2* velocity = (Vector2*)GAME_ALLOC(ALLOC_CORE, sizeof(Vector2) * count);
+        int* proxies = (int*)GAME_ALLOC(ALLOC_CORE, sizeof(int) * count);
+        AabbNode* nodes = (AabbNode*)GAME_ALLOC(ALLOC_CORE, sizeof(AabbNode) * 2 * count);
+        if (!boxes || !velocity || !proxies || !nodes) {
+            GAME_FREE(boxes);
+            GAME_FREE(velocity);
+            GAME_FREE(proxies);
+            GAME_FREE(nodes);
+            return;
+        }
+
+        AabbTree tree;
+        AabbTreeInit(&tree, nodes, 2 * count);
+        for (int i = 0; i < count; i++) {
+            Vector2 position = { BenchRandom(0.0f, side), BenchRandom(0.0f, side) };
+            Vector2 size = { BenchRandom(10.0f, 40.0f), BenchRandom(10.0f, 40.0f) };
+            boxes[i] = (AABB){ position, { position.x + size.x, position.y + size.y } };
+            velocity[i] = (Vector2){ BenchRandom(-3.0f, 3.0f), BenchRandom(-3.0f, 3.0f) };
+            proxies[i] = AabbTreeInsert(&tree, boxes[i], i);
+        }
+
+        long long treeTime = 0;
+        long long scanTime = 0;
+        long long treePairs = 0;
+        long long scanPairs = 0;
+
+        for (int step = 0; step < TREE_BENCH_STEPS; step++) {
+            for (int i = 0; i < count; i++) {
+                if (boxes[i].min.x < 0.0f || boxes[i].max.x > side) velocity[i].x = -velocity[i].x;
+                if (boxes[i].min.y < 0.0f || boxes[i].max.y > side) velocity[i].y = -velocity[i].y;
+                boxes[i].min.x += velocity[i].x;
+                boxes[i].max.x += velocity[i].x;
+                boxes[i].min.y += velocity[i].y;
+                boxes[i].max.y += velocity[i].y;
+            }
+
+            long long start = BenchNow();
+            for (int i = 0; i < count; i++) {
+                AabbTreeMove(&tree, proxies[i], boxes[i], velocity[i]);
+            }
+            for (int i = 0; i < count; i++) {
+                TreeBenchQuery query = { boxes, i, 0, 0.0f };
+                AabbTreeQueryAABB(&tree, boxes[i], CountOverlap, &query);
+                treePairs += query.hits;
+            }
+            treeTime += BenchNow() - start;
+
+            start = BenchNow();
+            for (int i = 0; i < count; i++) {
+                for (int j = 0; j < count; j++) {
+                    if (j != i && BoxesOverlap(boxes[i], boxes[j])) scanPairs++;
+                }
+            }
+            scanTime += BenchNow() - start;
+        }
+
+        long long treeRayTime = 0;
+        long long scanRayTime = 0;
+        int mismatches = 0;
+        for (int r = 0; r < TREE_BENCH_RAYS; r++) {
+            Vector2 from = { BenchRandom(0.0f, side), BenchRandom(0.0f, side) };
+            Vector2 to = { BenchRandom(0.0f, side), BenchRandom(0.0f, side) };
+
+            long long start = BenchNow();
+            TreeBenchQuery query = { boxes, -1, 0, 1.0f };
+            AabbTreeRaycast(&tree, from, to, ClosestHit, &query);
+            treeRayTime += BenchNow() - start;
+
+            start = BenchNow();
+            float closest = 1.0f;
+            for (int i = 0; i < count; i++) {
+                float fraction = AabbSegmentFraction(boxes[i], from, to, closest);
+                if (fraction >= 0.0f) closest = fraction;
+            }
+            scanRayTime += BenchNow() - start;
+
+            if (closest != query.closest) mismatches++;
+        }
+
+        printf("  %5d boxes  pairs %10.0f ns/step tree, %10.0f scan (%.1fx)  rays %7.0f ns tree, %7.0f scan (%.1fx)%s\n",
+            count, (double)treeTime / TREE_BENCH_STEPS, (double)scanTime / TREE_BENCH_STEPS,
+            (double)scanTime / (double)(treeTime > 0 ? treeTime : 1),
+            (double)treeRayTime / TREE_BENCH_RAYS, (double)scanRayTime / TREE_BENCH_RAYS,
+            (double)scanRayTime / (double)(treeRayTime > 0 ? treeRayTime : 1),
+            (treePairs == scanPairs && mismatches == 0) ? "" : "  MISMATCH");
+
+        GAME_FREE(boxes);
+        GAME_FREE(velocity);
+        GAME_FREE(proxies);
+        GAME_FREE(nodes);
+    }
+}
+
+// Function to fill a batch of rects and one of circles over a level-sized area
+static void FillNarrowBench(PackedRects* rects, PackedCircles* circles, int count) {
+    rects->count = 0;
+    circles->count = 0;
+    for (int i = 0; i < count; i++) {
+        Rectangle rect = { BenchRandom(0.0f, 400.0f), BenchRandom(0.0f, 400.0f), BenchRandom(20.0f, 80.0f), BenchRandom(20.0f, 80.0f) };
+        PackRect(rects, rect);
+        PackCircle(circles, (Vector2){ BenchRandom(0.0f, 450.0f), BenchRandom(0.0f, 450.0f) }, BenchRandom(10.0f, 30.0f));
+    }
+}
+
+// Every circle against every rect and every other circle, per pair and batched
+static void BenchNarrowPhase(void) {
+    const int sizes[] = { 5, 16, 64 };
+    static PackedRects rects;
+    static PackedCircles circles;
+    uint64_t scalarHits[NARROW_MAX_BODIES];
+    uint64_t batchHits[NARROW_MAX_BODIES];
+
+#if defined(__AVX2__)
+    printf("narrowphase: %d repeats, AVX2 kernels\n", NARROW_BENCH_REPEATS);
+#else
+    printf("narrowphase: %d repeats, scalar kernels\n", NARROW_BENCH_REPEATS);
+#endif
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        const int count = sizes[s];
+        FillNarrowBench(&rects, &circles, count);
+
+        long long pairTime = 0;
+        long long batchTime = 0;
+        int mismatches = 0;
+
+        for (int repeat = 0; repeat < NARROW_BENCH_REPEATS; repeat++) {
+            long long start = BenchNow();
+            for (int c = 0; c < count; c++) {
+                Vector2 centre = { circles.x[c], circles.y[c] };
+                uint64_t mask = 0;
+                for (int r = 0; r < count; r++) {
+                    Rectangle rect = { rects.x[r], rects.y[r], rects.width[r], rects.height[r] };
+                    if (CheckCollisionCircleRec(centre, circles.radius[c], rect)) mask |= (uint64_t)1 << r;
+                }
+                for (int o = 0; o < count; o++) {
+                    Vector2 other = { circles.x[o], circles.y[o] };
+                    if (CheckCollisionCircles(centre, circles.radius[c], other, circles.radius[o])) mask ^= (uint64_t)1 << o;
+                }
+                scalarHits[c] = mask;
+            }
+            pairTime += BenchNow() - start;
+
+            start = BenchNow();
+            CirclesVsRects(&circles, &rects, batchHits, NULL);
+            for (int c = 0; c < count; c++) {
+                batchHits[c] ^= CircleVsCircles((Vector2){ circles.x[c], circles.y[c] }, circles.radius[c], &circles, NULL);
+            }
+            batchTime += BenchNow() - start;
+
+            if (memcmp(scalarHits, batchHits, sizeof(uint64_t) * count) != 0) mismatches++;
+        }
+
+        const double pairs = 2.0 * count * count * NARROW_BENCH_REPEATS;
+        printf("  %3d bodies  %6.2f ns/pair per call, %6.2f batched (%.1fx)%s\n", count,
+            (double)pairTime / pairs, (double)batchTime / pairs,
+            (double)pairTime / (double)(batchTime > 0 ? batchTime : 1), mismatches == 0 ? "" : "  MISMATCH");
+    }
+}
+
+// The game's own chain on a TNT level, through both shipped paths: the
+// float world's ResolveExplosions(), which finds bodies with the spatial
+// tree (its refit included), and the fixed-point world's, which scans
+static void BenchExplosions(void) {
+    LevelData level;
+    FixedWorld world;
+    int score = 0;
+    int floatCrates = 0;
+    int floatKilled = 0;
+    int fixedCrates = 0;
+    long long floatTime = 0;
+    long long floatWorst = 0;
+    long long fixedTime = 0;
+    long long fixedWorst = 0;
+
+    if (!ParseLevelText(BLAST_BENCH_LEVEL, &level)) return;
+
+    EventQueueInit(&gameEvents);
+    ClearEventListeners();
+    AddEventListener(ResolveCombatEvents, NULL);
+    AddEventListener(ApplyScoreEvents, &score);
+    AddEventListener(TriggerExplosives, NULL);
+
+    for (int run = 0; run < BLAST_BENCH_RUNS; run++) {
+        Bird bird = { { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+        blockCount = level.blockCount;
+        memcpy(blocks, level.blocks, sizeof(Block) * level.blockCount);
+        enemyCount = level.enemyCount;
+        memcpy(enemies, level.enemies, sizeof(Enemy) * level.enemyCount);
+        ClearExplosions();
+        SeedGameRandom(12345);
+        score = 0;
+
+        long long start = BenchNow();
+        SpatialSync(&bird);
+        QueueExplosion(0);
+        floatCrates = ResolveExplosions(&gameEvents);
+        DispatchEvents(&gameEvents);
+        long long elapsed = BenchNow() - start;
+
+        floatTime += elapsed;
+        if (elapsed > floatWorst) floatWorst = elapsed;
+    }
+    ClearEventListeners();
+
+    for (int i = 0; i < enemyCount; i++) {
+        if (!enemies[i].active) floatKilled++;
+    }
+
+    for (int run = 0; run < BLAST_BENCH_RUNS; run++) {
+        FixedWorldLoadLevel(&world, &level, 12345);
+
+        long long start = BenchNow();
+        fixedCrates = FixedWorldDetonate(&world, 0, NULL);
+        long long elapsed = BenchNow() - start;
+
+        fixedTime += elapsed;
+        if (elapsed > fixedWorst) fixedWorst = elapsed;
+    }
+
+    bool matches = floatCrates == fixedCrates && floatKilled == world.enemiesKilled && score == world.score;
+    printf("explosions: crate 0 of %d set off, %d runs\n", level.blockCount, BLAST_BENCH_RUNS);
+    printf("  float  %6.0f ns per chain, worst %6lld ns (%d crates, %d of %d enemies killed, score %d)\n",
+        (double)floatTime / BLAST_BENCH_RUNS, floatWorst, floatCrates, floatKilled, level.enemyCount, score);
+    printf("  fixed  %6.0f ns per chain, worst %6lld ns (%d crates, %d of %d enemies killed, score %d)%s\n",
+        (double)fixedTime / BLAST_BENCH_RUNS, fixedWorst, fixedCrates, world.enemiesKilled, level.enemyCount, world.score,
+        matches ? "" : "  MISMATCH");
+}
+
+// Chains of hinged planks, each pinned to the world at one end and let go
+// level so they swing down. Reports the solver's cost per step and how far
+// apart the two halves of any hinge ended up.
+static void BenchJoints(void) {
+    const int sizes[] = { 100, 300, 1000 };
+
+    printf("joints: %d steps of %d-plank hinged chains swinging from rest\n", JOINT_BENCH_STEPS, JOINT_BENCH_LINKS);
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        const int count = sizes[s];
+
+        JointBody* bodies = (JointBody*)GAME_ALLOC(ALLOC_CORE, sizeof(JointBody) * count);
+        Joint* chain = (Joint*)GAME_ALLOC(ALLOC_CORE, sizeof(Joint) * count);
+        JointFrame* frames = (JointFrame*)GAME_ALLOC(ALLOC_CORE, sizeof(JointFrame) * count);
+        if (!bodies || !chain || !frames) {
+            GAME_FREE(bodies);
+            GAME_FREE(chain);
+            GAME_FREE(frames);
+            return;
+        }
+
+        // One body per joint: plank i hangs from plank i - 1, or from the world at the top of its chain
+        for (int i = 0; i < count; i++) {
+            int link = i % JOINT_BENCH_LINKS;
+            Vector2 pin = { (float)(i / JOINT_BENCH_LINKS) * 40.0f, 0.0f };
+            Vector2 centre = { pin.x + (link + 0.5f) * JOINT_BENCH_PLANK, pin.y };
+
+            bodies[i] = MakeJointBody(centre, JOINT_BENCH_PLANK, 8.0f, 1.0f);
+            chain[i] = (Joint){ 0 };
+            chain[i].type = JOINT_REVOLUTE;
+            chain[i].bodyA = (short)i;
+            chain[i].bodyB = (link == 0) ? JOINT_WORLD : (short)(i - 1);
+            chain[i].anchorA = (Vector2){ -JOINT_BENCH_PLANK / 2.0f, 0.0f };
+            chain[i].anchorB = (link == 0) ? pin : (Vector2){ JOINT_BENCH_PLANK / 2.0f, 0.0f };
+        }
+
+        long long total = 0;
+        long long worst = 0;
+        for (int step = 0; step < JOINT_BENCH_STEPS; step++) {
+            for (int i = 0; i < count; i++) {
+                bodies[i].velocity.y += JOINT_BENCH_GRAVITY;
+                bodies[i].centre.x += bodies[i].velocity.x;
+                bodies[i].centre.y += bodies[i].velocity.y;
+                bodies[i].rotation += bodies[i].angularVelocity;
+            }
+
+            long long start = BenchNow();
+            SolveJoints(chain, count, bodies, frames, 1.0f);
+            long long elapsed = BenchNow() - start;
+
+            total += elapsed;
+            if (elapsed > worst) worst = elapsed;
+        }
+
+        float drift = 0.0f;
+        for (int i = 0; i < count; i++) {
+            Vector2 a = JointAnchorA(&chain[i], bodies);
+            Vector2 b = JointAnchorB(&chain[i], bodies);
+            drift = fmaxf(drift, hypotf(b.x - a.x, b.y - a.y));
+        }
+
+        printf("  %5d joints  %8.1f us/step, worst %8.1f us  hinge drift %.2f px\n", count,
+            (double)total / JOINT_BENCH_STEPS / 1000.0, worst / 1000.0, drift);
+
+        GAME_FREE(bodies);
+        GAME_FREE(chain);
+        GAME_FREE(frames);
+    }
+}
+
+// Function to compare the parts of two frames that go over the wire
+static bool SameGhostFrame(const GhostFrame* a, const GhostFrame* b) {
+    if (a->step != b->step || a->score != b->score || a->level != b->level || a->lives != b->lives ||
+        a->shots != b->shots || a->pullX != b->pullX || a->pullY != b->pullY ||
+        a->blockCount != b->blockCount || a->enemyCount != b->enemyCount) return false;
+
+    return memcmp(&a->bird, &b->bird, sizeof(GhostBody)) == 0 &&
+        memcmp(a->blocks, b->blocks, sizeof(GhostBody) * a->blockCount) == 0 &&
+        memcmp(a->enemies, b->enemies, sizeof(GhostBody) * a->enemyCount) == 0;
+}
+
+// A 100-body world collapsing a few bodies at a time: each one is knocked
+// loose in turn, tumbles down and comes to rest on the ground. Every
+// GHOST_SEND_INTERVAL steps it is quantized, delta-encoded against the
+// previous snapshot and decoded again; the same frames then go between
+// two GhostLinks over loopback, which only use baselines the other side
+// has acknowledged.
+static void BenchGhost(void) {
+    static GhostFrame frame;
+    static GhostFrame previous;
+    static GhostFrame decoded;
+    static GhostLink sender;
+    static GhostLink receiver;
+    unsigned char packet[GHOST_MAX_PACKET];
+
+    const int count = GHOST_BENCH_BLOCKS + GHOST_BENCH_ENEMIES;
+    Vector2 position[GHOST_BENCH_BLOCKS + GHOST_BENCH_ENEMIES];
+    Vector2 velocity[GHOST_BENCH_BLOCKS + GHOST_BENCH_ENEMIES];
+    float rotation[GHOST_BENCH_BLOCKS + GHOST_BENCH_ENEMIES];
+    float spin[GHOST_BENCH_BLOCKS + GHOST_BENCH_ENEMIES];
+
+    benchRandom = 2463534242u;
+    for (int i = 0; i < count; i++) {
+        position[i] = (Vector2){ 600.0f + (float)(i % 10) * 60.0f, 600.0f - (float)(i / 10) * 45.0f };
+        velocity[i] = (Vector2){ 0.0f, 0.0f };
+        rotation[i] = 0.0f;
+        spin[i] = 0.0f;
+    }
+
+    bool linked = GhostLinkOpen(&sender, GHOST_BENCH_PORT, GHOST_BENCH_PORT + 1) &&
+        GhostLinkOpen(&receiver, GHOST_BENCH_PORT + 1, GHOST_BENCH_PORT);
+
+    int frames = 0;
+    int fullSize = 0;
+    long long bytes = 0;
+    int largest = 0;
+    long long encodeTime = 0;
+    long long decodeTime = 0;
+    long long worstCodec = 0;
+    int mismatches = 0;
+    int linkFrames = 0;
+
+    for (int step = 1; step <= GHOST_BENCH_STEPS; step++) {
+        for (int i = 0; i < count; i++) {
+            // One body knocked loose every four steps, highest rows first
+            if (step == 4 * (count - i)) {
+                velocity[i] = (Vector2){ BenchRandom(-3.0f, 3.0f), BenchRandom(-4.0f, 0.0f) };
+                spin[i] = BenchRandom(-0.1f, 0.1f);
+            }
+            if (velocity[i].x == 0.0f && velocity[i].y == 0.0f && spin[i] == 0.0f) continue;
+
+            velocity[i].y += 0.5f;
+            position[i].x += velocity[i].x;
+            position[i].y += velocity[i].y;
+            rotation[i] += spin[i];
+            if (position[i].y > 640.0f) {
+                // Settles after a couple of bounces
+                position[i].y = 640.0f;
+                velocity[i] = (fabsf(velocity[i].y) < 2.0f) ? (Vector2){ 0.0f, 0.0f } : (Vector2){ velocity[i].x * 0.5f, -velocity[i].y * 0.3f };
+                spin[i] = (velocity[i].y == 0.0f) ? 0.0f : spin[i] * 0.5f;
+            }
+        }
+        if (step % GHOST_SEND_INTERVAL != 0) continue;
+
+        frame.step = (unsigned int)step;
+        frame.score = step * 10;
+        frame.level = 1;
+        frame.lives = 3;
+        frame.shots = 1;
+        frame.pullX = 90;
+        frame.pullY = 430;
+        frame.bird = QuantizeCircle((Vector2){ 150.0f + (float)step * 2.0f, 400.0f }, 15.0f, GHOST_ACTIVE | GHOST_LAUNCHED, 0);
+        frame.blockCount = GHOST_BENCH_BLOCKS;
+        frame.enemyCount = GHOST_BENCH_ENEMIES;
+        for (int i = 0; i < GHOST_BENCH_BLOCKS; i++) {
+            Rectangle rect = { position[i].x, position[i].y - 40.0f, 50.0f, 40.0f };
+            frame.blocks[i] = QuantizeRect(rect, rotation[i], GHOST_ACTIVE, MATERIAL_WOOD);
+        }
+        for (int i = 0; i < GHOST_BENCH_ENEMIES; i++) {
+            int body = GHOST_BENCH_BLOCKS + i;
+            frame.enemies[i] = QuantizeCircle(position[body], 15.0f, GHOST_ACTIVE, 3);
+        }
+
+        const GhostFrame* base = (frames > 0) ? &previous : NULL;
+        long long start = BenchNow();
+        int size = EncodeGhostFrame(&frame, base, packet, sizeof(packet));
+        long long encoded = BenchNow();
+        bool ok = DecodeGhostFrame(packet, size, base, &decoded);
+        long long end = BenchNow();
+
+        if (frames == 0) fullSize = size;
+        else {
+            bytes += size;
+            if (size > largest) largest = size;
+            encodeTime += encoded - start;
+            decodeTime += end - encoded;
+            if (end - start > worstCodec) worstCodec = end - start;
+        }
+        if (size == 0 || !ok || !SameGhostFrame(&decoded, &frame)) mismatches++;
+        previous = frame;
+        frames++;
+
+        // Both sides send, so each acknowledges the other
+        if (linked) {
+            GhostLinkSend(&sender, &frame);
+            GhostLinkSend(&receiver, &frame);
+            GhostLinkReceive(&sender);
+            if (GhostLinkReceive(&receiver) > 0) {
+                linkFrames++;
+                if (!SameGhostFrame(GhostLinkLatest(&receiver), &frame)) mismatches++;
+            }
+        }
+    }
+
+    const int deltas = frames - 1;
+    printf("ghost: %d bodies, %d steps, a snapshot every %d steps\n", count + 1, GHOST_BENCH_STEPS, GHOST_SEND_INTERVAL);
+    printf("  full frame %d bytes, deltas avg %.0f bytes, max %d bytes\n", fullSize, (double)bytes / deltas, largest);
+    printf("  encode %.1f us, decode %.1f us avg, worst both %.1f us (frame budget 16667 us)\n",
+        (double)encodeTime / deltas / 1000.0, (double)decodeTime / deltas / 1000.0, worstCodec / 1000.0);
+    if (linked) {
+        printf("  loopback: %d/%d frames decoded, %.0f bytes/packet, %u dropped\n", linkFrames, frames,
+            (double)sender.bytesSent / (sender.packetsSent > 0 ? sender.packetsSent : 1), receiver.packetsDropped);
+    }
+    else {
+        printf("  loopback: sockets unavailable, codec only\n");
+    }
+    printf("  %s\n", mismatches == 0 ? "decoded frames match" : "MISMATCH");
+
+    GhostLinkClose(&sender);
+    GhostLinkClose(&receiver);
+}
+
+// A batch of worlds played by a random agent: every world whose bird is
+// in the sling launches it at a random pull, and finished worlds start
+// over on the other level. Reports environment steps per second on this
+// core, with every observation field written.
+static void BenchEnv(void) {
+    // The caller's side of the API: plain arrays, one per field
+    static struct {
+        float birdX[ENV_BENCH_WORLDS], birdY[ENV_BENCH_WORLDS];
+        float birdVelocityX[ENV_BENCH_WORLDS], birdVelocityY[ENV_BENCH_WORLDS];
+        unsigned char ready[ENV_BENCH_WORLDS];
+        float blockX[ENV_BENCH_WORLDS * MAX_BLOCKS], blockY[ENV_BENCH_WORLDS * MAX_BLOCKS];
+        float blockRotation[ENV_BENCH_WORLDS * MAX_BLOCKS];
+        unsigned char blockState[ENV_BENCH_WORLDS * MAX_BLOCKS];
+        float enemyX[ENV_BENCH_WORLDS * MAX_ENEMIES], enemyY[ENV_BENCH_WORLDS * MAX_ENEMIES];
+        unsigned char enemyState[ENV_BENCH_WORLDS * MAX_ENEMIES], enemyHealth[ENV_BENCH_WORLDS * MAX_ENEMIES];
+        int score[ENV_BENCH_WORLDS], lives[ENV_BENCH_WORLDS];
+        float reward[ENV_BENCH_WORLDS];
+        unsigned char done[ENV_BENCH_WORLDS];
+    } buffers;
+    static EnvAction actions[ENV_BENCH_WORLDS];
+    const int count = ENV_BENCH_WORLDS;
+
+    const EnvObservations out = {
+        buffers.birdX, buffers.birdY, buffers.birdVelocityX, buffers.birdVelocityY, buffers.ready,
+        buffers.blockX, buffers.blockY, buffers.blockRotation, buffers.blockState,
+        buffers.enemyX, buffers.enemyY, buffers.enemyState, buffers.enemyHealth,
+        buffers.score, buffers.lives, buffers.reward, buffers.done, NULL
+    };
+
+    EnvBatch batch;
+    if (!EnvBatchInit(&batch, count, &out)) return;
+
+    benchRandom = 2463534242u;
+    for (int i = 0; i < count; i++) {
+        EnvReset(&batch, i, 1 + i % 2, (unsigned int)(i + 1));
+    }
+
+    long long shots = 0;
+    long long episodes = 0;
+    double totalReward = 0.0;
+    long long stepTime = 0;
+
+    for (int step = 0; step < ENV_BENCH_STEPS; step++) {
+        for (int i = 0; i < count; i++) {
+            actions[i] = (EnvAction){ buffers.ready[i] != 0, (int)BenchRandom(60.0f, 150.0f), (int)BenchRandom(400.0f, 480.0f) };
+            shots += actions[i].launch ? 1 : 0;
+        }
+
+        long long start = BenchNow();
+        EnvStep(&batch, actions);
+        stepTime += BenchNow() - start;
+
+        for (int i = 0; i < count; i++) {
+            totalReward += buffers.reward[i];
+            if (buffers.done[i]) {
+                episodes++;
+                EnvReset(&batch, i, 1 + (batch.levels[i] % 2), (unsigned int)(step * count + i + 1));
+            }
+        }
+    }
+
+    const double envSteps = (double)ENV_BENCH_STEPS * count;
+    printf("env: %d worlds, %d lockstep steps, random launches\n", count, ENV_BENCH_STEPS);
+    printf("  %.0f env-steps/s on one core (%.1f ns each)\n", envSteps / ((double)stepTime / 1e9), (double)stepTime / envSteps);
+    printf("  %lld shots, %lld episodes, %.0f mean reward per episode\n", shots, episodes,
+        totalReward / (double)(episodes > 0 ? episodes : 1));
+
+    EnvBatchFree(&batch);
+}
+
+// Function to time RasterizeWorld() on one world; returns ns per frame
+static double TimeOccupancy(OccupancyGrid* grid, const Bird* bird, const Block* bodies, int bodyCount,
+    const Enemy* targets, int targetCount) {
+    long long start = BenchNow();
+    for (int frame = 0; frame < OCCUPANCY_BENCH_FRAMES; frame++) {
+        RasterizeWorld(grid, bird, bodies, bodyCount, targets, targetCount);
+    }
+    return (double)(BenchNow() - start) / OCCUPANCY_BENCH_FRAMES;
+}
+
+// Draws each level into an occupancy grid, then a crowd of randomly
+// turned planks, and prints the last level as text
+static void BenchOccupancy(void) {
+    static OccupancyGrid grid;
+    static Block crowd[OCCUPANCY_BENCH_BLOCKS];
+    const Bird bird = { { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+    const LevelData* level = NULL;
+
+    printf("occupancy: %dx%d cells, %d channels, %d frames each\n", OCCUPANCY_WIDTH, OCCUPANCY_HEIGHT,
+        OCCUPANCY_CHANNELS, OCCUPANCY_BENCH_FRAMES);
+    for (int n = 1; n <= 2; n++) {
+        level = GetLevelData(n);
+        double time = TimeOccupancy(&grid, &bird, level->blocks, level->blockCount, level->enemies, level->enemyCount);
+        printf("  level %d: %2d blocks, %d enemies  %6.2f us/frame\n", n, level->blockCount, level->enemyCount, time / 1000.0);
+    }
+
+    benchRandom = 2463534242u;
+    for (int i = 0; i < OCCUPANCY_BENCH_BLOCKS; i++) {
+        crowd[i] = (Block){ 0 };
+        crowd[i].rect = (Rectangle){ BenchRandom(0.0f, 1450.0f), BenchRandom(100.0f, 520.0f), BenchRandom(20.0f, 120.0f), BenchRandom(20.0f, 60.0f) };
+        crowd[i].rotation = BenchRandom(-PI, PI);
+        crowd[i].material = (unsigned char)(i % MATERIAL_COUNT);
+        crowd[i].active = true;
+    }
+    double time = TimeOccupancy(&grid, &bird, crowd, OCCUPANCY_BENCH_BLOCKS, NULL, 0);
+    printf("  %d turned blocks           %6.2f us/frame\n", OCCUPANCY_BENCH_BLOCKS, time / 1000.0);
+
+    // Level 2 above the ground: '#' blocks, 'o' enemies, '@' the bird
+    RasterizeWorld(&grid, &bird, level->blocks, level->blockCount, level->enemies, level->enemyCount);
+    const char glyphs[] = " =#o@";
+    for (int y = 0; y < OCCUPANCY_HEIGHT; y++) {
+        const unsigned char* row = grid.cells[OCCUPANCY_KIND][y];
+        if (row[0] == OCCUPANCY_GROUND) break;
+        if (memchr(row, OCCUPANCY_BLOCK, OCCUPANCY_WIDTH) == NULL && memchr(row, OCCUPANCY_ENEMY, OCCUPANCY_WIDTH) == NULL &&
+            memchr(row, OCCUPANCY_BIRD, OCCUPANCY_WIDTH) == NULL) continue;
+
+        char line[OCCUPANCY_WIDTH + 1];
+        for (int x = 0; x < OCCUPANCY_WIDTH; x++) line[x] = glyphs[row[x]];
+        line[OCCUPANCY_WIDTH] = '\0';
+        printf("  |%s|\n", line);
+    }
+}
+
+// One body flown for INTEGRATOR_BENCH_FLIGHT at the given tick scale.
+// Returns the largest distance from the analytic path, and the largest
+// change of energy (per unit mass) as a share of the launch's kinetic energy.
+static float FlyIntegrator(IntegratorKind kind, Motion motion, float scale, float* energyDrift) {
+    const Vector2 start = { 150.0f, 400.0f };
+    const Vector2 launch = { 12.0f, -14.0f };
+    Transform transform = { start, 0.0f, 0.0f };
+    Vector2 velocity = launch;
+    const TickRate tick = { scale };
+    const double g = motion.gravity;
+    const double kinetic = 0.5 * ((double)launch.x * launch.x + (double)launch.y * launch.y);
+    const double energy = kinetic - g * start.y;
+
+    float worst = 0.0f;
+    *energyDrift = 0.0f;
+    const int steps = (int)(INTEGRATOR_BENCH_FLIGHT / scale);
+    for (int step = 1; step <= steps; step++) {
+        IntegrateRows(kind, &transform, &velocity, &motion, &tick, 1);
+        const double t = step * (double)scale;
+
+        // Without drag the path is the parabola; with it, velocity decays towards g / dragY
+        double x, y;
+        if (motion.dragX > 0.0f) x = start.x + launch.x * (1.0 - exp(-motion.dragX * t)) / motion.dragX;
+        else x = start.x + launch.x * t;
+        if (motion.dragY > 0.0f) {
+            const double terminal = g / motion.dragY;
+            y = start.y + terminal * t + (launch.y - terminal) * (1.0 - exp(-motion.dragY * t)) / motion.dragY;
+        }
+        else y = start.y + launch.y * t + 0.5 * g * t * t;
+
+        const float error = (float)hypot(transform.position.x - x, transform.position.y - y);
+        if (error > worst) worst = error;
+
+        const double now = 0.5 * ((double)velocity.x * velocity.x + (double)velocity.y * velocity.y) - g * transform.position.y;
+        const float drift = (float)(fabs(now - energy) / kinetic);
+        if (drift > *energyDrift) *energyDrift = drift;
+    }
+    return worst;
+}
+
+// Accuracy of each integrator at 120, 60, 30 and 15 Hz, for the bird's
+// drag-free arc and a wooden block's dragged one, then its cost per body
+static void BenchIntegrators(void) {
+    static Transform transforms[INTEGRATOR_BENCH_BODIES];
+    static Vector2 velocities[INTEGRATOR_BENCH_BODIES];
+    static Motion motions[INTEGRATOR_BENCH_BODIES];
+    static TickRate ticks[INTEGRATOR_BENCH_BODIES];
+    const float scales[] = { 0.5f, 1.0f, 2.0f, 4.0f };
+    const Motion birdMotion = { 0.41f, 0.0f, 0.0f };
+    const Motion blockMotion = { 0.5f * materialTable[MATERIAL_WOOD].mass, 0.02f, 0.01f };
+
+    printf("integrators: %.0f s flight, largest error from the analytic path in px\n", INTEGRATOR_BENCH_FLIGHT / 60.0f);
+    printf("  %-7s %6s %10s %12s %10s\n", "", "tick", "parabola", "energy drift", "drag");
+    for (int kind = 0; kind < INTEGRATOR_COUNT; kind++) {
+        for (int i = 0; i < (int)(sizeof(scales) / sizeof(scales[0])); i++) {
+            float drift, unused;
+            float parabola = FlyIntegrator((IntegratorKind)kind, birdMotion, scales[i], &drift);
+            float drag = FlyIntegrator((IntegratorKind)kind, blockMotion, scales[i], &unused);
+            printf("  %-7s %3.0f Hz %10.4f %11.4f%% %10.4f\n", IntegratorName((IntegratorKind)kind), 60.0f / scales[i],
+                parabola, drift * 100.0f, drag);
+        }
+    }
+
+    printf("  cost, %d bodies x %d steps:\n", INTEGRATOR_BENCH_BODIES, INTEGRATOR_BENCH_STEPS);
+    for (int kind = 0; kind < INTEGRATOR_COUNT; kind++) {
+        benchRandom = 2463534242u;
+        for (int i = 0; i < INTEGRATOR_BENCH_BODIES; i++) {
+            transforms[i] = (Transform){ { BenchRandom(0.0f, 1500.0f), BenchRandom(0.0f, 600.0f) }, 0.0f, 0.0f };
+            velocities[i] = (Vector2){ BenchRandom(-10.0f, 10.0f), BenchRandom(-10.0f, 10.0f) };
+            motions[i] = (i & 1) ? blockMotion : birdMotion;
+            ticks[i] = (TickRate){ 1.0f };
+        }
+
+        long long start = BenchNow();
+        for (int step = 0; step < INTEGRATOR_BENCH_STEPS; step++) {
+            IntegrateRows((IntegratorKind)kind, transforms, velocities, motions, ticks, INTEGRATOR_BENCH_BODIES);
+        }
+        double time = (double)(BenchNow() - start) / ((double)INTEGRATOR_BENCH_BODIES * INTEGRATOR_BENCH_STEPS);
+
+        // Keeps the stepping from being optimized away
+        float sink = 0.0f;
+        for (int i = 0; i < INTEGRATOR_BENCH_BODIES; i++) sink += transforms[i].position.y;
+        printf("  %-7s %6.2f ns/body/step  (checksum %.0f)\n", IntegratorName((IntegratorKind)kind), time, sink);
+    }
+}
+
+static const Benchmark benchmarks[] = {
+    { "physics", "float vs fixed-point world step", BenchPhysics },
+    { "aabbtree", "AABB tree queries vs linear scan", BenchAabbTree },
+    { "narrowphase", "batched circle-rect and circle-circle tests vs per pair", BenchNarrowPhase },
+    { "explosions", "TNT chain reaction, float and fixed-point paths", BenchExplosions },
+    { "joints", "joint solver cost as chains grow", BenchJoints },
+    { "ghost", "ghost snapshot size and codec time for 100 bodies", BenchGhost },
+    { "env", "batched headless worlds stepped in lockstep", BenchEnv },
+    { "occupancy", "CPU occupancy grid rasterizer", BenchOccupancy },
+    { "integrators", "integrator accuracy and cost per tick rate", BenchIntegrators },
+};
+
+#define BENCHMARK_COUNT (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+int RunBenchmark(const char* name) {
+    bool all = strcmp(name, "all") == 0;
+    bool found = false;
+
+    for (int i = 0; i < BENCHMARK_COUNT; i++) {
+        if (all || strcmp(benchmarks[i].name, name) == 0) {
+            benchmarks[i].run();
+            found = true;
+        }
+    }
+
+    if (!found) {
+        printf("Unknown benchmark '%s'. Available:\n", name);
+        for (int i = 0; i < BENCHMARK_COUNT; i++) {
+            printf("  %-12s %s\n", benchmarks[i].name, benchmarks[i].description);
+        }
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Headless benchmarks, run with --bench <name> (or --bench all)
+int RunBenchmark(const char* name);
+
+// Monotonic-enough wall clock for timing loops, in nanoseconds
+long long BenchNow(void);
+
+#endif
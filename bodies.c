@@ -0,0 +1,458 @@
+#include "bodies.h"
+#include "ecs.h"
+#include "materials.h"
+#include "sprite_shapes.h"
+#include <float.h>
+#include <math.h>
+
+#define MOVING_BODY (COMPONENT_BIT(COMPONENT_BODY) | COMPONENT_BIT(COMPONENT_TRANSFORM) | \
+    COMPONENT_BIT(COMPONENT_VELOCITY) | COMPONENT_BIT(COMPONENT_TICK) | COMPONENT_BIT(COMPONENT_RESTING))
+#define ROUND_BODY (MOVING_BODY | COMPONENT_BIT(COMPONENT_MOTION) | COMPONENT_BIT(COMPONENT_GROUND))
+
+// Blocks of each material get an archetype of their own. Their rows carry
+// no Motion or GroundContact: the material's systems below have its mass,
+// friction and bounciness built in as constants.
+#define BLOCK_BODY(material) (MOVING_BODY | COMPONENT_BIT(COMPONENT_SPIN) | COMPONENT_BIT(COMPONENT_WALLS) | \
+    COMPONENT_MATERIAL_BIT(material))
+
+// Shared by every material
+#define BLOCK_GRAVITY 0.5f  // scaled by the material's mass
+#define BLOCK_DRAG_X 0.02f
+#define BLOCK_DRAG_Y 0.01f
+#define BLOCK_SPIN_DAMPING 0.05f
+
+typedef struct {
+    EventQueue* events;
+    float scale; // deltaTime * 60
+} StepContext;
+
+typedef struct {
+    unsigned char interval;  // steps between updates, 1 at full rate
+    unsigned char sinceStep; // steps since the last update
+    bool deferred;           // skipped this step
+    float pending;           // time owed to the body, in 60 Hz steps
+    Vector2 previous;        // position before the last update
+} BodyLod;
+
+static BodyLod blockLod[MAX_BLOCKS];
+static BodyLod enemyLod[MAX_ENEMIES];
+
+// Joint scratch, and how long each jointed block has hung still
+static JointBody jointBodies[MAX_BLOCKS];
+static JointFrame jointFrames[MAX_JOINTS];
+static int stillSteps[MAX_BLOCKS];
+
+// The awake bodies are gathered into this world every step and written
+// back afterwards; the structs in blocks[] / enemies[] stay authoritative
+static EcsWorld bodyWorld;
+static int roundArchetype = -1;
+static int blockArchetypes[MATERIAL_COUNT];
+
+static void SpawnRound(BodyKind kind, int index, Vector2 position, Vector2 velocity, float radius,
+    float gravity, GroundContact ground, float scale) {
+    Archetype* archetype = &bodyWorld.archetypes[roundArchetype];
+    int row = EcsSpawn(&bodyWorld, roundArchetype);
+    if (row < 0) return;
+
+    ECS_COLUMN(archetype, COMPONENT_BODY, BodyLink)[row] = (BodyLink){ kind, index };
+    ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform)[row] = (Transform){ position, radius, radius * 2.0f };
+    ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2)[row] = velocity;
+    ECS_COLUMN(archetype, COMPONENT_TICK, TickRate)[row] = (TickRate){ scale };
+    ECS_COLUMN(archetype, COMPONENT_MOTION, Motion)[row] = (Motion){ gravity, 0.0f, 0.0f };
+    ECS_COLUMN(archetype, COMPONENT_GROUND, GroundContact)[row] = ground;
+}
+
+static void SpawnBlock(int index, float scale) {
+    const Block* block = &blocks[index];
+    int archetypeIndex = blockArchetypes[block->material];
+    Archetype* archetype = &bodyWorld.archetypes[archetypeIndex];
+    int row = EcsSpawn(&bodyWorld, archetypeIndex);
+    if (row < 0) return;
+
+    ECS_COLUMN(archetype, COMPONENT_BODY, BodyLink)[row] = (BodyLink){ BODY_BLOCK, index };
+    ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform)[row] =
+        (Transform){ { block->rect.x, block->rect.y }, block->rect.height, block->rect.width };
+    ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2)[row] = block->velocity;
+    ECS_COLUMN(archetype, COMPONENT_TICK, TickRate)[row] = (TickRate){ scale };
+    ECS_COLUMN(archetype, COMPONENT_SPIN, Spin)[row] = (Spin){ block->rotation, block->angularVelocity };
+}
+
+void ResetBodyLod(void) {
+    for (int i = 0; i < MAX_BLOCKS; i++) blockLod[i] = (BodyLod){ 1, 0, false, 0.0f, { 0.0f, 0.0f } };
+    for (int i = 0; i < MAX_ENEMIES; i++) enemyLod[i] = (BodyLod){ 1, 0, false, 0.0f, { 0.0f, 0.0f } };
+}
+
+static BodyLod* FindLod(BodyKind kind, int index) {
+    if (kind == BODY_BLOCK && index >= 0 && index < MAX_BLOCKS) return &blockLod[index];
+    if (kind == BODY_ENEMY && index >= 0 && index < MAX_ENEMIES) return &enemyLod[index];
+    return NULL;
+}
+
+bool BodyDeferred(BodyKind kind, int index) {
+    const BodyLod* lod = FindLod(kind, index);
+    return lod != NULL && lod->deferred;
+}
+
+Vector2 BodyDrawOffset(BodyKind kind, int index, Vector2 position) {
+    const BodyLod* lod = FindLod(kind, index);
+    if (lod == NULL || lod->interval <= 1) return (Vector2){ 0.0f, 0.0f };
+
+    // Drawn one update behind, sliding from previous toward the current position
+    float remaining = 1.0f - (float)lod->sinceStep / (float)lod->interval;
+    return (Vector2){ (lod->previous.x - position.x) * remaining, (lod->previous.y - position.y) * remaining };
+}
+
+// Function to pick a body's update interval from where it is relative to the bird and the screen
+static int LodInterval(const Bird* bird, Rectangle bounds) {
+    Vector2 centre = { bounds.x + bounds.width / 2.0f, bounds.y + bounds.height / 2.0f };
+    float dx = centre.x - bird->position.x;
+    float dy = centre.y - bird->position.y;
+
+    if (dx * dx + dy * dy <= LOD_NEAR_DISTANCE * LOD_NEAR_DISTANCE) return 1;
+    if (!CheckCollisionRecs(bounds, (Rectangle){ 0.0f, 0.0f, SCREEN_WIDTH, SCREEN_HEIGHT })) return LOD_OFFSCREEN_INTERVAL;
+    return LOD_REDUCED_INTERVAL;
+}
+
+// Function to decide whether an awake body steps now, and over how much time
+static bool TakeLodStep(BodyLod* lod, int interval, Vector2 position, float scale, float* owed) {
+    lod->pending += scale;
+    lod->sinceStep++;
+
+    // Promotion takes effect at once, demotion only after the current interval runs out
+    if (interval < lod->interval || lod->sinceStep >= lod->interval) {
+        *owed = lod->pending;
+        lod->interval = (unsigned char)interval;
+        lod->sinceStep = 0;
+        lod->pending = 0.0f;
+        lod->previous = position;
+        lod->deferred = false;
+        return true;
+    }
+
+    lod->deferred = true;
+    return false;
+}
+
+// Jointed blocks always step at full rate: a partner left for a later step would hold them in place
+static bool BlockJointed(int index) {
+    for (int j = 0; j < jointCount; j++) {
+        if (!joints[j].broken && (joints[j].bodyA == index || joints[j].bodyB == index)) return true;
+    }
+    return false;
+}
+
+static void GatherBodies(const Bird* bird, float scale) {
+    if (roundArchetype < 0) {
+        EcsInit(&bodyWorld);
+        roundArchetype = EcsArchetype(&bodyWorld, ROUND_BODY);
+        for (int m = 0; m < MATERIAL_COUNT; m++) blockArchetypes[m] = EcsArchetype(&bodyWorld, BLOCK_BODY(m));
+    }
+    EcsClear(&bodyWorld);
+
+    if (bird->launched) {
+        // Bounces keep half their speed; the bird never rests, it is reset
+        SpawnRound(BODY_BIRD, 0, bird->position, bird->velocity, bird->radius, 0.41f,
+            (GroundContact){ 0.5f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f }, scale);
+    }
+
+    for (int i = 0; i < enemyCount; i++) {
+        BodyLod* lod = &enemyLod[i];
+        if (!enemies[i].active || !enemies[i].falling) {
+            *lod = (BodyLod){ 1, 0, false, 0.0f, enemies[i].position };
+            continue;
+        }
+
+        // Enemies move as the circle they collide with, so they land on its edge
+        Vector2 centre;
+        float radius;
+        EnemyCollisionCircle(&enemies[i], &centre, &radius);
+        Rectangle bounds = { centre.x - radius, centre.y - radius, radius * 2.0f, radius * 2.0f };
+        float owed;
+        if (TakeLodStep(lod, LodInterval(bird, bounds), enemies[i].position, scale, &owed)) {
+            // Enemies land dead still
+            SpawnRound(BODY_ENEMY, i, centre, enemies[i].velocity, radius, 0.41f,
+                (GroundContact){ 0.0f, 0.0f, 0.0f, 0.0f, FLT_MAX, FLT_MAX }, owed);
+        }
+    }
+
+    for (int i = 0; i < blockCount; i++) {
+        BodyLod* lod = &blockLod[i];
+        if (!blocks[i].active || !blocks[i].falling || blocks[i].onGround) {
+            *lod = (BodyLod){ 1, 0, false, 0.0f, { blocks[i].rect.x, blocks[i].rect.y } };
+            continue;
+        }
+
+        Vector2 position = { blocks[i].rect.x, blocks[i].rect.y };
+        float owed;
+        int interval = BlockJointed(i) ? 1 : LodInterval(bird, blocks[i].rect);
+        if (TakeLodStep(lod, interval, position, scale, &owed)) SpawnBlock(i, owed);
+    }
+}
+
+static void ScatterRows(Archetype* archetype, void* userData) {
+    Bird* bird = (Bird*)userData;
+    const BodyLink* link = ECS_COLUMN(archetype, COMPONENT_BODY, BodyLink);
+    const Transform* transform = ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform);
+    const Vector2* velocity = ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2);
+    const bool* resting = ECS_COLUMN(archetype, COMPONENT_RESTING, bool);
+    const Spin* spin = ECS_COLUMN(archetype, COMPONENT_SPIN, Spin);
+
+    for (int row = 0; row < archetype->count; row++) {
+        switch (link[row].kind) {
+        case BODY_BIRD:
+            bird->position = transform[row].position;
+            bird->velocity = velocity[row];
+            break;
+        case BODY_ENEMY: {
+            // Back from the collision circle's centre to the enemy's own position
+            Enemy* enemy = &enemies[link[row].index];
+            Vector2 centre;
+            float radius;
+            EnemyCollisionCircle(enemy, &centre, &radius);
+            enemy->position.x = transform[row].position.x - (centre.x - enemy->position.x);
+            enemy->position.y = transform[row].position.y - (centre.y - enemy->position.y);
+            enemy->velocity = velocity[row];
+            if (resting[row]) {
+                enemy->falling = false;
+                enemy->landed = true;
+            }
+            break;
+        }
+        case BODY_BLOCK: {
+            Block* block = &blocks[link[row].index];
+            block->rect.x = transform[row].position.x;
+            block->rect.y = transform[row].position.y;
+            block->velocity = velocity[row];
+            if (spin != NULL) {
+                block->rotation = spin[row].rotation;
+                block->angularVelocity = spin[row].angularVelocity;
+            }
+            if (resting[row]) {
+                block->falling = false;
+                block->onGround = true;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+static IntegratorKind bodyIntegrator = INTEGRATOR_SEMI_IMPLICIT_EULER;
+
+void SetBodyIntegrator(IntegratorKind kind) {
+    bodyIntegrator = kind;
+}
+
+IntegratorKind GetBodyIntegrator(void) {
+    return bodyIntegrator;
+}
+
+// Gravity and air drag of round bodies, advanced by the selected integrator
+static void IntegrateSystem(Archetype* archetype, void* userData) {
+    const TickRate* tick = ECS_COLUMN(archetype, COMPONENT_TICK, TickRate);
+    const Motion* motion = ECS_COLUMN(archetype, COMPONENT_MOTION, Motion);
+    Transform* transform = ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform);
+    Vector2* velocity = ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2);
+
+    IntegrateRows(bodyIntegrator, transform, velocity, motion, tick, archetype->count);
+}
+
+static inline void SpinRows(Archetype* archetype) {
+    const TickRate* tick = ECS_COLUMN(archetype, COMPONENT_TICK, TickRate);
+    Spin* spin = ECS_COLUMN(archetype, COMPONENT_SPIN, Spin);
+
+    for (int row = 0; row < archetype->count; row++) {
+        const float scale = tick[row].scale;
+        spin[row].rotation += spin[row].angularVelocity * scale;
+        spin[row].angularVelocity *= (1.0f - BLOCK_SPIN_DAMPING * scale);
+    }
+}
+
+// Function to bounce every row that reached the ground; inlined with a
+// constant contact into the block systems, so their material is folded in
+static inline void GroundRows(Archetype* archetype, EventQueue* events, const GroundContact* contacts, GroundContact shared) {
+    const float groundY = SCREEN_HEIGHT - GROUND_HEIGHT;
+    const BodyLink* link = ECS_COLUMN(archetype, COMPONENT_BODY, BodyLink);
+    Transform* transform = ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform);
+    Vector2* velocity = ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2);
+    bool* resting = ECS_COLUMN(archetype, COMPONENT_RESTING, bool);
+    Spin* spin = ECS_COLUMN(archetype, COMPONENT_SPIN, Spin);
+
+    for (int row = 0; row < archetype->count; row++) {
+        Transform* t = &transform[row];
+        if (t->position.y + t->bottom < groundY) continue;
+
+        const GroundContact ground = (contacts != NULL) ? contacts[row] : shared;
+        t->position.y = groundY - t->bottom;
+
+        // Rectangles report their bottom centre, circles their centre
+        float contactX = (link[row].kind == BODY_BLOCK) ? t->position.x + t->width / 2.0f : t->position.x;
+        EmitEvent(events, EVENT_CONTACT, link[row].kind, link[row].index, BODY_GROUND, -1, 0,
+            contactX, groundY, fabsf(velocity[row].y));
+
+        velocity[row].y *= -ground.bounciness;
+        velocity[row].x *= ground.friction;
+        if (spin != NULL) spin[row].angularVelocity *= ground.spinKept;
+
+        if (fabsf(velocity[row].y) < ground.stopSpeedY) {
+            velocity[row].y = 0.0f;
+        }
+
+        if (fabsf(velocity[row].y) < ground.restSpeedY && fabsf(velocity[row].x) < ground.restSpeedX) {
+            velocity[row] = (Vector2){ 0.0f, 0.0f };
+            if (spin != NULL) spin[row].angularVelocity = 0.0f;
+            resting[row] = true;
+        }
+    }
+}
+
+// Round bodies carry their own contact: the bird bounces, enemies land dead still
+static void GroundSystem(Archetype* archetype, void* userData) {
+    GroundRows(archetype, ((const StepContext*)userData)->events,
+        ECS_COLUMN(archetype, COMPONENT_GROUND, GroundContact), (GroundContact){ 0 });
+}
+
+static inline void WallRows(Archetype* archetype) {
+    Transform* transform = ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform);
+    Vector2* velocity = ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2);
+
+    for (int row = 0; row < archetype->count; row++) {
+        if (transform[row].position.x < 0.0f) {
+            transform[row].position.x = 0.0f;
+            velocity[row].x *= -0.5f;
+        }
+        if (transform[row].position.x + transform[row].width > SCREEN_WIDTH) {
+            transform[row].position.x = SCREEN_WIDTH - transform[row].width;
+            velocity[row].x *= -0.5f;
+        }
+    }
+}
+
+// One system per material, generated from materials.h, so its mass,
+// friction and bounciness are constants. Each row is moved, spun, grounded
+// and kept inside the walls; rows do not interact, so one pass does it all.
+#define DEFINE_BLOCK_SYSTEM(id, name, mass, friction, bounciness) \
+static void BlockSystem_##id(Archetype* archetype, const StepContext* context) { \
+    IntegrateUniformRows(bodyIntegrator, ECS_COLUMN(archetype, COMPONENT_TRANSFORM, Transform), \
+        ECS_COLUMN(archetype, COMPONENT_VELOCITY, Vector2), (Motion){ BLOCK_GRAVITY * (mass), BLOCK_DRAG_X, BLOCK_DRAG_Y }, \
+        ECS_COLUMN(archetype, COMPONENT_TICK, TickRate), archetype->count); \
+    SpinRows(archetype); \
+    GroundRows(archetype, context->events, NULL, (GroundContact){ bounciness, friction, 0.7f, 0.0f, 0.5f, 1.0f }); \
+    WallRows(archetype); \
+}
+MATERIAL_LIST(DEFINE_BLOCK_SYSTEM)
+#undef DEFINE_BLOCK_SYSTEM
+
+
+static bool BlockAwake(int index) {
+    const Block* block = &blocks[index];
+    return block->active && block->falling && !block->onGround && !BodyDeferred(BODY_BLOCK, index);
+}
+
+// Function to hold jointed blocks together after they have moved. Blocks at
+// rest or left for a later step count as fixed anchors; a moving block wakes
+// whatever it is joined to, and a block hanging still goes back to rest.
+static void StepJoints(EventQueue* events, float scale) {
+    if (jointCount == 0) return;
+
+    for (int i = 0; i < blockCount; i++) {
+        const Block* block = &blocks[i];
+        Vector2 centre = { block->rect.x + block->rect.width / 2.0f, block->rect.y + block->rect.height / 2.0f };
+        jointBodies[i] = MakeJointBody(centre, block->rect.width, block->rect.height, materialTable[block->material].mass);
+        jointBodies[i].velocity = block->velocity;
+        jointBodies[i].rotation = block->rotation;
+        jointBodies[i].angularVelocity = block->angularVelocity;
+    }
+
+    bool wasBroken[MAX_JOINTS];
+    for (int j = 0; j < jointCount; j++) {
+        Joint* joint = &joints[j];
+        bool hasB = joint->bodyB != JOINT_WORLD;
+        wasBroken[j] = joint->broken;
+
+        // Destroyed blocks take their joints with them
+        if (!blocks[joint->bodyA].active || (hasB && !blocks[joint->bodyB].active)) joint->broken = true;
+        if (joint->broken || !hasB) continue;
+
+        // Woken blocks join in from the next step
+        Block* a = &blocks[joint->bodyA];
+        Block* b = &blocks[joint->bodyB];
+        if (BlockAwake(joint->bodyA) && !b->falling) b->falling = true;
+        if (BlockAwake(joint->bodyB) && !a->falling) a->falling = true;
+    }
+
+    bool awake[MAX_BLOCKS];
+    for (int i = 0; i < blockCount; i++) {
+        awake[i] = BlockAwake(i);
+        if (!awake[i]) {
+            jointBodies[i].invMass = 0.0f;
+            jointBodies[i].invInertia = 0.0f;
+        }
+    }
+
+    SolveJoints(joints, jointCount, jointBodies, jointFrames, scale);
+
+    for (int i = 0; i < blockCount; i++) {
+        if (!awake[i]) continue;
+
+        Block* block = &blocks[i];
+        block->rect.x = jointBodies[i].centre.x - block->rect.width / 2.0f;
+        block->rect.y = jointBodies[i].centre.y - block->rect.height / 2.0f;
+        block->velocity = jointBodies[i].velocity;
+        block->rotation = jointBodies[i].rotation;
+        block->angularVelocity = jointBodies[i].angularVelocity;
+    }
+
+    for (int j = 0; j < jointCount; j++) {
+        const Joint* joint = &joints[j];
+        if (joint->broken && !wasBroken[j]) {
+            Vector2 at = JointAnchorA(joint, jointBodies);
+            EmitEvent(events, EVENT_JOINT_BROKEN, BODY_BLOCK, joint->bodyA,
+                joint->bodyB == JOINT_WORLD ? BODY_NONE : BODY_BLOCK, joint->bodyB, 0, at.x, at.y, 0.0f);
+        }
+    }
+
+    // A block only sleeps once everything holding it has stopped too
+    for (int i = 0; i < blockCount; i++) {
+        Block* block = &blocks[i];
+        bool still = awake[i] && fabsf(block->velocity.x) < JOINT_SLEEP_SPEED &&
+            fabsf(block->velocity.y) < JOINT_SLEEP_SPEED && fabsf(block->angularVelocity) < JOINT_SLEEP_SPEED / 100.0f;
+        stillSteps[i] = still ? stillSteps[i] + 1 : 0;
+    }
+    for (int j = 0; j < jointCount; j++) {
+        const Joint* joint = &joints[j];
+        if (joint->broken) continue;
+
+        int a = joint->bodyA;
+        int b = joint->bodyB;
+        if (stillSteps[a] >= JOINT_SLEEP_STEPS && (b == JOINT_WORLD || !awake[b] || stillSteps[b] >= JOINT_SLEEP_STEPS)) {
+            blocks[a].falling = false;
+            blocks[a].velocity = (Vector2){ 0.0f, 0.0f };
+            blocks[a].angularVelocity = 0.0f;
+            stillSteps[a] = 0;
+        }
+    }
+}
+
+void StepBodies(Bird* bird, EventQueue* events, float deltaTime) {
+    StepContext context = { events, deltaTime * 60.0f };
+
+    GatherBodies(bird, context.scale);
+
+    EcsRun(&bodyWorld, COMPONENT_BIT(COMPONENT_TRANSFORM) | COMPONENT_BIT(COMPONENT_VELOCITY) |
+        COMPONENT_BIT(COMPONENT_TICK) | COMPONENT_BIT(COMPONENT_MOTION), IntegrateSystem, &context);
+    EcsRun(&bodyWorld, COMPONENT_BIT(COMPONENT_GROUND) | COMPONENT_BIT(COMPONENT_RESTING), GroundSystem, &context);
+
+    // Each material has exactly one archetype, so its system is called on it directly
+#define RUN_BLOCK_SYSTEM(id, name, mass, friction, bounciness) \
+    if (bodyWorld.archetypes[blockArchetypes[MATERIAL_##id]].count > 0) \
+        BlockSystem_##id(&bodyWorld.archetypes[blockArchetypes[MATERIAL_##id]], &context);
+    MATERIAL_LIST(RUN_BLOCK_SYSTEM)
+#undef RUN_BLOCK_SYSTEM
+
+    EcsRun(&bodyWorld, COMPONENT_BIT(COMPONENT_BODY), ScatterRows, bird);
+
+    StepJoints(events, context.scale);
+}
@@ -0,0 +1,45 @@
+#ifndef BODIES_H
+#define BODIES_H
+
+#include "game.h"
+#include "events.h"
+#include "integrator.h"
+
+// Moves every awake body one step: the launched bird, falling blocks and
+// falling enemies go through the same gravity, integration, spin, wall and
+// ground systems. Ground contacts are pushed to events.
+// Jointed blocks are then pulled back together (see joints.h), and joints
+// that snap are pushed as EVENT_JOINT_BROKEN.
+void StepBodies(Bird* bird, EventQueue* events, float deltaTime);
+
+// Integrator the bodies move with, semi-implicit Euler unless changed
+// (--integrator). Set it before the simulation starts.
+void SetBodyIntegrator(IntegratorKind kind);
+IntegratorKind GetBodyIntegrator(void);
+
+// A jointed block whose speed stays under JOINT_SLEEP_SPEED for
+// JOINT_SLEEP_STEPS steps goes back to rest, so hanging blocks settle
+#define JOINT_SLEEP_SPEED 0.05f
+#define JOINT_SLEEP_STEPS 30
+
+// Physics level of detail. Blocks and enemies further than LOD_NEAR_DISTANCE
+// from the bird step every LOD_REDUCED_INTERVAL steps, and bodies outside the
+// screen every LOD_OFFSCREEN_INTERVAL, with the skipped time folded into
+// their next step. Coming within range of the bird promotes a body straight
+// back to full rate. The bird itself always steps at full rate.
+#define LOD_NEAR_DISTANCE 300.0f
+#define LOD_REDUCED_INTERVAL 2
+#define LOD_OFFSCREEN_INTERVAL 4
+
+// Forgets every body's LOD state (after a level load or a rewind)
+void ResetBodyLod(void);
+
+// True when the body was left for a later step this time; collision skips
+// it until it moves again
+bool BodyDeferred(BodyKind kind, int index);
+
+// Offset from the body's simulated position to where it should be drawn,
+// interpolating between its last two steps while it runs at reduced rate
+Vector2 BodyDrawOffset(BodyKind kind, int index, Vector2 position);
+
+#endif
@@ -0,0 +1,133 @@
+#include "dynamic_res.h"
+#include <stddef.h>
+#include <math.h>
+
+// 4-neighbour unsharp mask; taps are clamped to the rendered part of the texture
+static const char* sharpenShader =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec4 colDiffuse;\n"
+    "uniform vec2 texelSize;\n"
+    "uniform float sharpness;\n"
+    "uniform vec2 uvMin;\n"
+    "uniform vec2 uvMax;\n"
+    "out vec4 finalColor;\n"
+    "vec3 Fetch(vec2 uv) { return texture(texture0, clamp(uv, uvMin, uvMax)).rgb; }\n"
+    "void main() {\n"
+    "    vec3 centre = Fetch(fragTexCoord);\n"
+    "    vec3 around = Fetch(fragTexCoord + vec2(texelSize.x, 0.0)) + Fetch(fragTexCoord - vec2(texelSize.x, 0.0)) +\n"
+    "        Fetch(fragTexCoord + vec2(0.0, texelSize.y)) + Fetch(fragTexCoord - vec2(0.0, texelSize.y));\n"
+    "    vec3 color = clamp(centre + sharpness * (4.0 * centre - around), 0.0, 1.0);\n"
+    "    finalColor = vec4(color, 1.0) * fragColor * colDiffuse;\n"
+    "}\n";
+
+bool DynamicResInit(DynamicResolution* dr, int width, int height) {
+    *dr = (DynamicResolution){ 0 };
+    dr->scale = DYNRES_MAX_SCALE;
+    dr->averageFrame = 1.0f / DYNRES_TARGET_FPS;
+    dr->probeFrames = DYNRES_PROBE_FRAMES;
+    dr->sinceProbe = DYNRES_MAX_PROBE_FRAMES;
+
+    dr->target = LoadRenderTexture(width, height);
+    if (dr->target.id == 0) {
+        TraceLog(LOG_WARNING, "DYNRES: Failed to create a %dx%d render target", width, height);
+        return false;
+    }
+    SetTextureFilter(dr->target.texture, TEXTURE_FILTER_BILINEAR);
+
+    // A shader that fails to compile comes back as raylib's default one, which is a plain bilinear blit
+    dr->sharpen = LoadShaderFromMemory(NULL, sharpenShader);
+    dr->texelSizeLoc = GetShaderLocation(dr->sharpen, "texelSize");
+    dr->sharpnessLoc = GetShaderLocation(dr->sharpen, "sharpness");
+    dr->uvMinLoc = GetShaderLocation(dr->sharpen, "uvMin");
+    dr->uvMaxLoc = GetShaderLocation(dr->sharpen, "uvMax");
+    return true;
+}
+
+void DynamicResUnload(DynamicResolution* dr) {
+    UnloadShader(dr->sharpen);
+    UnloadRenderTexture(dr->target);
+}
+
+void DynamicResBegin(const DynamicResolution* dr) {
+    Camera2D camera = { { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, dr->scale };
+
+    BeginTextureMode(dr->target);
+    BeginMode2D(camera);
+}
+
+void DynamicResEnd(void) {
+    EndMode2D();
+    EndTextureMode();
+}
+
+void DynamicResDraw(const DynamicResolution* dr) {
+    const float textureWidth = (float)dr->target.texture.width;
+    const float textureHeight = (float)dr->target.texture.height;
+    const float width = textureWidth * dr->scale;
+    const float height = textureHeight * dr->scale;
+
+    // Render textures are stored upside down: the drawn region is the top rows of the image
+    Rectangle source = { 0.0f, textureHeight - height, width, -height };
+    Rectangle dest = { 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight() };
+
+    float texelSize[2] = { 1.0f / textureWidth, 1.0f / textureHeight };
+    float uvMin[2] = { 0.5f / textureWidth, (textureHeight - height + 0.5f) / textureHeight };
+    float uvMax[2] = { (width - 0.5f) / textureWidth, (textureHeight - 0.5f) / textureHeight };
+    float sharpness = DYNRES_MAX_SHARPNESS * (DYNRES_MAX_SCALE - dr->scale) / (DYNRES_MAX_SCALE - DYNRES_MIN_SCALE);
+
+    SetShaderValue(dr->sharpen, dr->texelSizeLoc, texelSize, SHADER_UNIFORM_VEC2);
+    SetShaderValue(dr->sharpen, dr->sharpnessLoc, &sharpness, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(dr->sharpen, dr->uvMinLoc, uvMin, SHADER_UNIFORM_VEC2);
+    SetShaderValue(dr->sharpen, dr->uvMaxLoc, uvMax, SHADER_UNIFORM_VEC2);
+
+    BeginShaderMode(dr->sharpen);
+    DrawTexturePro(dr->target.texture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndShaderMode();
+}
+
+void DynamicResObserve(DynamicResolution* dr, float frameTime) {
+    const float budget = 1.0f / DYNRES_TARGET_FPS;
+
+    dr->averageFrame += (frameTime - dr->averageFrame) * DYNRES_SMOOTHING;
+    dr->sinceProbe++;
+    if (dr->settleFrames > 0) {
+        dr->settleFrames--;
+        return;
+    }
+
+    if (dr->averageFrame > budget * 1.05f) {
+        dr->framesOnBudget = 0;
+        if (dr->scale <= DYNRES_MIN_SCALE) return;
+
+        // A probe that costs frames straight away is backed off
+        if (dr->sinceProbe < dr->probeFrames / 2 && dr->probeFrames < DYNRES_MAX_PROBE_FRAMES) {
+            dr->probeFrames *= 2;
+        }
+
+        // Fill cost follows the pixel count, the square of the scale
+        float scale = dr->scale * sqrtf(budget / dr->averageFrame);
+        dr->scale = fmaxf(DYNRES_MIN_SCALE, fminf(scale, dr->scale - 0.01f));
+        dr->settleFrames = DYNRES_SETTLE_FRAMES;
+        TraceLog(LOG_DEBUG, "DYNRES: Frame %.2f ms, scale down to %.2f", dr->averageFrame * 1000.0f, dr->scale);
+        return;
+    }
+
+    if (++dr->framesOnBudget >= dr->probeFrames && dr->scale < DYNRES_MAX_SCALE) {
+        dr->scale = fminf(DYNRES_MAX_SCALE, dr->scale + DYNRES_PROBE_STEP);
+        dr->framesOnBudget = 0;
+        dr->sinceProbe = 0;
+        dr->settleFrames = DYNRES_SETTLE_FRAMES;
+        TraceLog(LOG_DEBUG, "DYNRES: On budget, probing scale %.2f", dr->scale);
+    }
+}
+
+bool DynamicResAtMin(const DynamicResolution* dr) {
+    return dr->target.id == 0 || dr->scale <= DYNRES_MIN_SCALE;
+}
+
+bool DynamicResAtMax(const DynamicResolution* dr) {
+    return dr->target.id == 0 || dr->scale >= DYNRES_MAX_SCALE;
+}
@@ -0,0 +1,57 @@
+#ifndef DYNAMIC_RES_H
+#define DYNAMIC_RES_H
+
+#include "raylib.h"
+
+#define DYNRES_TARGET_FPS 60
+#define DYNRES_MIN_SCALE 0.5f
+#define DYNRES_MAX_SCALE 1.0f
+#define DYNRES_SMOOTHING 0.1f        // weight of the newest frame in the running average
+#define DYNRES_SETTLE_FRAMES 10      // frames after a change before the average is trusted again
+#define DYNRES_PROBE_FRAMES 120      // frames on budget before trying a higher scale
+#define DYNRES_MAX_PROBE_FRAMES 1920 // ... doubled each time a probe has to be taken back
+#define DYNRES_PROBE_STEP 0.05f
+#define DYNRES_MAX_SHARPNESS 0.6f    // sharpening at DYNRES_MIN_SCALE, none at full scale
+
+// The world is drawn into the top-left scale x scale part of a full-size
+// render texture, then stretched over the screen through a sharpening
+// shader. The scale follows the frame time: raylib has no GPU timer
+// queries, so a missed budget is read as fill-rate pressure, and spare
+// headroom (hidden by the target-FPS wait) is found by probing upwards.
+typedef struct {
+    RenderTexture2D target;
+    Shader sharpen;
+    int texelSizeLoc;
+    int sharpnessLoc;
+    int uvMinLoc;
+    int uvMaxLoc;
+
+    float scale;
+    float averageFrame;      // seconds
+    int settleFrames;
+    int framesOnBudget;
+    int probeFrames;
+    int sinceProbe;          // frames since the last step up
+} DynamicResolution;
+
+bool DynamicResInit(DynamicResolution* dr, int width, int height);
+void DynamicResUnload(DynamicResolution* dr);
+
+// Everything drawn between these lands in the scaled render texture;
+// draw in screen coordinates as usual
+void DynamicResBegin(const DynamicResolution* dr);
+void DynamicResEnd(void);
+
+// Upscales the world over the whole screen; call inside BeginDrawing()
+void DynamicResDraw(const DynamicResolution* dr);
+
+// Feeds the last frame's time and picks the scale for the next one
+void DynamicResObserve(DynamicResolution* dr, float frameTime);
+
+// Whether the scale is pinned at DYNRES_MIN_SCALE / back at DYNRES_MAX_SCALE,
+// for the quality tiers, which only move once resolution can't. Both are
+// true without a render target, as nothing is scaled then.
+bool DynamicResAtMin(const DynamicResolution* dr);
+bool DynamicResAtMax(const DynamicResolution* dr);
+
+#endif
@@ -0,0 +1,88 @@
+#include "ecs.h"
+#include <string.h>
+
+#define COLUMN_ALIGNMENT 16
+
+static const unsigned int componentSize[COMPONENT_COUNT] = {
+    [COMPONENT_BODY] = sizeof(BodyLink),
+    [COMPONENT_TRANSFORM] = sizeof(Transform),
+    [COMPONENT_VELOCITY] = sizeof(Vector2),
+    [COMPONENT_TICK] = sizeof(TickRate),
+    [COMPONENT_MOTION] = sizeof(Motion),
+    [COMPONENT_SPIN] = sizeof(Spin),
+    [COMPONENT_GROUND] = sizeof(GroundContact),
+    [COMPONENT_RESTING] = sizeof(bool),
+    [COMPONENT_WALLS] = 0,  // tags, like the material ones after it, have no column
+};
+
+void EcsInit(EcsWorld* world) {
+    world->archetypeCount = 0;
+    world->arenaUsed = 0;
+}
+
+void EcsClear(EcsWorld* world) {
+    for (int i = 0; i < world->archetypeCount; i++) {
+        world->archetypes[i].count = 0;
+    }
+}
+
+int EcsArchetype(EcsWorld* world, ComponentMask mask) {
+    for (int i = 0; i < world->archetypeCount; i++) {
+        if (world->archetypes[i].mask == mask) return i;
+    }
+
+    if (world->archetypeCount >= ECS_MAX_ARCHETYPES) {
+        TraceLog(LOG_WARNING, "ECS: Too many archetypes");
+        return -1;
+    }
+
+    // Size the columns up front so rows never move
+    unsigned int needed = 0;
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        if (mask & COMPONENT_BIT(c)) {
+            needed += (componentSize[c] * ECS_MAX_ROWS + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+        }
+    }
+    if (world->arenaUsed + needed > ECS_ARENA_SIZE) {
+        TraceLog(LOG_WARNING, "ECS: Column arena full");
+        return -1;
+    }
+
+    Archetype* archetype = &world->archetypes[world->archetypeCount];
+    archetype->mask = mask;
+    archetype->count = 0;
+
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        archetype->columns[c] = NULL;
+        if ((mask & COMPONENT_BIT(c)) && componentSize[c] > 0) {
+            archetype->columns[c] = world->arena + world->arenaUsed;
+            world->arenaUsed += (componentSize[c] * ECS_MAX_ROWS + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+        }
+    }
+
+    return world->archetypeCount++;
+}
+
+int EcsSpawn(EcsWorld* world, int archetypeIndex) {
+    if (archetypeIndex < 0) return -1;
+
+    Archetype* archetype = &world->archetypes[archetypeIndex];
+    if (archetype->count >= ECS_MAX_ROWS) return -1;
+
+    int row = archetype->count++;
+    for (int c = 0; c < COMPONENT_COUNT; c++) {
+        if (archetype->columns[c] != NULL) {
+            memset((unsigned char*)archetype->columns[c] + componentSize[c] * row, 0, componentSize[c]);
+        }
+    }
+    return row;
+}
+
+void EcsRun(EcsWorld* world, ComponentMask required, EcsSystem system, void* userData) {
+    for (int i = 0; i < world->archetypeCount; i++) {
+        Archetype* archetype = &world->archetypes[i];
+        if (archetype->count > 0 && (archetype->mask & required) == required) {
+            system(archetype, userData);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include "game.h"
+#include "events.h"
+#include "materials.h"
+
+#define ECS_MAX_ARCHETYPES 16
+#define ECS_MAX_ROWS 64              // entities per archetype
+#define ECS_ARENA_SIZE (96 * 1024)   // column storage for every archetype
+
+// Components. Position is the top-left corner for rectangles and the
+// centre for circles; bottom/width give the extent the ground and walls see.
+typedef struct {
+    BodyKind kind;
+    int index;      // into blocks[] / enemies[], 0 for the bird
+} BodyLink;
+
+typedef struct {
+    Vector2 position;
+    float bottom;
+    float width;
+} Transform;
+
+typedef struct {
+    float scale;    // time simulated this step, in 60 Hz steps
+} TickRate;
+
+typedef struct {
+    float gravity;  // per 60 Hz step
+    float dragX;    // share of speed lost per step
+    float dragY;
+} Motion;
+
+typedef struct {
+    float rotation;
+    float angularVelocity;
+} Spin;
+
+typedef struct {
+    float bounciness;  // share of vertical speed kept on a bounce
+    float friction;    // share of horizontal speed kept on a bounce
+    float spinKept;    // share of angular speed kept on a bounce
+    float stopSpeedY;  // slower bounces are flattened to zero
+    float restSpeedX;  // below both rest speeds the body comes to rest
+    float restSpeedY;
+} GroundContact;
+
+typedef enum {
+    COMPONENT_BODY,
+    COMPONENT_TRANSFORM,
+    COMPONENT_VELOCITY,  // Vector2
+    COMPONENT_TICK,
+    COMPONENT_MOTION,
+    COMPONENT_SPIN,
+    COMPONENT_GROUND,
+    COMPONENT_RESTING,   // bool: a ground contact brought the body to rest
+    COMPONENT_WALLS,     // tag: kept inside the screen edges
+    COMPONENT_MATERIAL,  // tags from here on, one per MaterialId
+    COMPONENT_COUNT = COMPONENT_MATERIAL + MATERIAL_COUNT
+} ComponentId;
+
+typedef unsigned int ComponentMask;
+#define COMPONENT_BIT(id) (1u << (id))
+#define COMPONENT_MATERIAL_BIT(material) COMPONENT_BIT(COMPONENT_MATERIAL + (material))
+
+// All entities with exactly the same component set share an archetype;
+// each component is one contiguous column indexed by row
+typedef struct {
+    ComponentMask mask;
+    int count;
+    void* columns[COMPONENT_COUNT];
+} Archetype;
+
+typedef struct {
+    Archetype archetypes[ECS_MAX_ARCHETYPES];
+    int archetypeCount;
+    unsigned char arena[ECS_ARENA_SIZE];
+    unsigned int arenaUsed;
+} EcsWorld;
+
+typedef void (*EcsSystem)(Archetype* archetype, void* userData);
+
+void EcsInit(EcsWorld* world);
+
+// Empties every archetype but keeps them (and their columns) for reuse
+void EcsClear(EcsWorld* world);
+
+// Finds or creates the archetype for mask, -1 when out of room
+int EcsArchetype(EcsWorld* world, ComponentMask mask);
+
+// Appends a zeroed row to an archetype, -1 when it is full
+int EcsSpawn(EcsWorld* world, int archetype);
+
+// Runs system once per non-empty archetype that has every required component
+void EcsRun(EcsWorld* world, ComponentMask required, EcsSystem system, void* userData);
+
+#define ECS_COLUMN(archetype, id, type) ((type*)(archetype)->columns[id])
+
+#endif
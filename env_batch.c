@@ -0,0 +1,129 @@
+#include "env_batch.h"
+#include "level.h"
+#include "alloc_tracker.h"
+#include <string.h>
+
+bool EnvBatchInit(EnvBatch* batch, int count, const EnvObservations* out) {
+    memset(batch, 0, sizeof(*batch));
+    if (count <= 0) return false;
+
+    batch->worlds = (FixedWorld*)GAME_ALLOC(ALLOC_CORE, sizeof(FixedWorld) * count);
+    batch->levels = (int*)GAME_ALLOC(ALLOC_CORE, sizeof(int) * count);
+    batch->done = (bool*)GAME_ALLOC(ALLOC_CORE, sizeof(bool) * count);
+    if (!batch->worlds || !batch->levels || !batch->done) {
+        EnvBatchFree(batch);
+        return false;
+    }
+
+    memset(batch->worlds, 0, sizeof(FixedWorld) * count);
+    memset(batch->levels, 0, sizeof(int) * count);
+    for (int i = 0; i < count; i++) batch->done[i] = true;
+
+    batch->count = count;
+    batch->out = *out;
+    return true;
+}
+
+void EnvBatchFree(EnvBatch* batch) {
+    GAME_FREE(batch->worlds);
+    GAME_FREE(batch->levels);
+    GAME_FREE(batch->done);
+    memset(batch, 0, sizeof(*batch));
+}
+
+// Function to draw a fixed-point world into an occupancy grid
+static void RasterizeFixedWorld(OccupancyGrid* grid, const FixedWorld* world) {
+    ClearOccupancy(grid);
+
+    for (int i = 0; i < world->blockCount; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        if (!block->active) continue;
+
+        Rectangle rect = { FixToFloat(block->position.x), FixToFloat(block->position.y), FixToFloat(block->size.x), FixToFloat(block->size.y) };
+        RasterizeRect(grid, rect, FixToFloat(block->rotation), OCCUPANCY_BLOCK, (unsigned char)(block->material + 1));
+    }
+    for (int i = 0; i < world->enemyCount; i++) {
+        const FixedEnemy* enemy = &world->enemies[i];
+        if (!enemy->active) continue;
+
+        Vector2 centre = { FixToFloat(enemy->position.x), FixToFloat(enemy->position.y) };
+        RasterizeCircle(grid, centre, FixToFloat(enemy->radius), OCCUPANCY_ENEMY, (unsigned char)enemy->health);
+    }
+
+    Vector2 bird = { FixToFloat(world->bird.position.x), FixToFloat(world->bird.position.y) };
+    RasterizeCircle(grid, bird, FixToFloat(world->bird.radius), OCCUPANCY_BIRD, 0);
+}
+
+static unsigned char BodyState(bool active, bool moving) {
+    if (!active) return ENV_BODY_GONE;
+    return moving ? ENV_BODY_MOVING : ENV_BODY_RESTING;
+}
+
+// Function to write world index into the caller's buffers
+static void WriteObservation(EnvBatch* batch, int index, float reward) {
+    const EnvObservations* out = &batch->out;
+    const FixedWorld* world = &batch->worlds[index];
+
+    if (out->birdX) out->birdX[index] = FixToFloat(world->bird.position.x);
+    if (out->birdY) out->birdY[index] = FixToFloat(world->bird.position.y);
+    if (out->birdVelocityX) out->birdVelocityX[index] = FixToFloat(world->bird.velocity.x);
+    if (out->birdVelocityY) out->birdVelocityY[index] = FixToFloat(world->bird.velocity.y);
+    if (out->ready) out->ready[index] = !world->bird.launched && !batch->done[index];
+
+    const int blockRow = index * MAX_BLOCKS;
+    for (int i = 0; i < MAX_BLOCKS; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        bool present = i < world->blockCount && block->active;
+
+        if (out->blockX) out->blockX[blockRow + i] = present ? FixToFloat(block->position.x) : 0.0f;
+        if (out->blockY) out->blockY[blockRow + i] = present ? FixToFloat(block->position.y) : 0.0f;
+        if (out->blockRotation) out->blockRotation[blockRow + i] = present ? FixToFloat(block->rotation) : 0.0f;
+        if (out->blockState) out->blockState[blockRow + i] = BodyState(present, block->falling && !block->onGround);
+    }
+
+    const int enemyRow = index * MAX_ENEMIES;
+    for (int i = 0; i < MAX_ENEMIES; i++) {
+        const FixedEnemy* enemy = &world->enemies[i];
+        bool present = i < world->enemyCount && enemy->active;
+
+        if (out->enemyX) out->enemyX[enemyRow + i] = present ? FixToFloat(enemy->position.x) : 0.0f;
+        if (out->enemyY) out->enemyY[enemyRow + i] = present ? FixToFloat(enemy->position.y) : 0.0f;
+        if (out->enemyState) out->enemyState[enemyRow + i] = BodyState(present, enemy->falling);
+        if (out->enemyHealth) out->enemyHealth[enemyRow + i] = present ? (unsigned char)enemy->health : 0;
+    }
+
+    if (out->score) out->score[index] = world->score;
+    if (out->lives) out->lives[index] = world->lives;
+    if (out->reward) out->reward[index] = reward;
+    if (out->done) out->done[index] = batch->done[index];
+    if (out->occupancy) RasterizeFixedWorld(&out->occupancy[index], world);
+}
+
+bool EnvReset(EnvBatch* batch, int index, int level, unsigned int seed) {
+    if (index < 0 || index >= batch->count || level < 1 || level > MAX_LEVELS) return false;
+
+    const LevelData* data = GetLevelData(level);
+    FixedWorldLoadLevel(&batch->worlds[index], data, seed);
+    batch->levels[index] = level;
+    batch->done[index] = data->enemyCount == 0;
+
+    WriteObservation(batch, index, 0.0f);
+    return !batch->done[index];
+}
+
+void EnvStep(EnvBatch* batch, const EnvAction* actions) {
+    for (int i = 0; i < batch->count; i++) {
+        FixedWorld* world = &batch->worlds[i];
+        int scoreBefore = world->score;
+
+        if (!batch->done[i]) {
+            if (actions && actions[i].launch && !world->bird.launched) {
+                FixedWorldLaunch(world, actions[i].pullX, actions[i].pullY);
+            }
+            FixedWorldStep(world, NULL);
+            batch->done[i] = world->gameOver || AllFixedEnemiesDead(world);
+        }
+
+        WriteObservation(batch, i, (float)(world->score - scoreBefore));
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef ENV_BATCH_H
+#define ENV_BATCH_H
+
+#include "fixed_physics.h"
+#include "occupancy.h"
+
+// Headless batch of independent worlds for training shot-selection agents.
+// Every world runs on the deterministic fixed-point path, so an episode
+// can be replayed and verified exactly like a recorded game. EnvStep()
+// moves all of them one 60 Hz step in lockstep, in one pass over the
+// batch, and writes what changed straight into buffers owned by the
+// caller. A batch belongs to one thread; run one batch per core to scale.
+
+// What an agent does this step. The launch is ignored while the bird is
+// in flight; pullX/pullY is where it lets go of the bird, in pixels.
+typedef struct {
+    bool launch;
+    int pullX;
+    int pullY;
+} EnvAction;
+
+// Caller-owned observation buffers, one array per field (structure of
+// arrays). Per-world fields hold count entries; per-body fields hold
+// count * MAX_BLOCKS or count * MAX_ENEMIES, world w's bodies starting at
+// w * MAX_BLOCKS. Any pointer may be NULL to skip that field.
+typedef struct {
+    float* birdX;
+    float* birdY;
+    float* birdVelocityX;
+    float* birdVelocityY;
+    unsigned char* ready;         // the bird is in the sling and can be launched
+
+    float* blockX;                // top-left corner
+    float* blockY;
+    float* blockRotation;         // radians
+    unsigned char* blockState;    // ENV_BODY_GONE, ENV_BODY_RESTING, ENV_BODY_MOVING
+
+    float* enemyX;                // centre of the circle it collides with
+    float* enemyY;
+    unsigned char* enemyState;
+    unsigned char* enemyHealth;
+
+    int* score;
+    int* lives;
+    float* reward;                // score gained this step
+    unsigned char* done;          // won or out of birds; stepping stops until EnvReset()
+
+    OccupancyGrid* occupancy;     // count grids, see occupancy.h
+} EnvObservations;
+
+#define ENV_BODY_GONE 0      // destroyed, or past the level's body count
+#define ENV_BODY_RESTING 1
+#define ENV_BODY_MOVING 2
+
+typedef struct {
+    int count;
+    FixedWorld* worlds;
+    int* levels;
+    bool* done;
+    EnvObservations out;
+} EnvBatch;
+
+// Allocates count worlds, all done until they are reset. out is copied;
+// the buffers it points to must outlive the batch.
+bool EnvBatchInit(EnvBatch* batch, int count, const EnvObservations* out);
+void EnvBatchFree(EnvBatch* batch);
+
+// Starts world index on level with the given random seed and writes its
+// first observation. Level data is read from disk on first use, so the
+// first reset of each level must not race with another batch's. Returns
+// false if the level has nothing to play.
+bool EnvReset(EnvBatch* batch, int index, int level, unsigned int seed);
+
+// Applies actions[i] to world i (actions may be NULL for no launches),
+// steps every world that isn't done and writes all observations
+void EnvStep(EnvBatch* batch, const EnvAction* actions);
+
+#endif
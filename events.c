@@ -0,0 +1,104 @@
+#include "events.h"
+
+typedef struct {
+    EventListener callback;
+    void* userData;
+} ListenerSlot;
+
+static ListenerSlot listeners[MAX_EVENT_LISTENERS];
+static int listenerCount = 0;
+
+// Events raised by listeners; only the dispatching thread touches it
+static EventQueue followUps;
+
+void EventQueueInit(EventQueue* queue) {
+    atomic_init(&queue->head, 0u);
+    atomic_init(&queue->tail, 0u);
+    queue->dropped = 0;
+}
+
+// Function to discard pending events (consumer side)
+void EventQueueClear(EventQueue* queue) {
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    atomic_store_explicit(&queue->tail, head, memory_order_release);
+}
+
+bool EventQueuePush(EventQueue* queue, GameEvent event) {
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (head - tail >= EVENT_QUEUE_CAPACITY) {
+        queue->dropped++;
+        return false;
+    }
+
+    queue->events[head & (EVENT_QUEUE_CAPACITY - 1)] = event;
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+int EventQueuePopBatch(EventQueue* queue, GameEvent* out, int maxCount) {
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    int count = (int)(head - tail);
+    if (count > maxCount) count = maxCount;
+
+    for (int i = 0; i < count; i++) {
+        out[i] = queue->events[(tail + i) & (EVENT_QUEUE_CAPACITY - 1)];
+    }
+
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+    return count;
+}
+
+bool EmitEvent(EventQueue* queue, GameEventType type, BodyKind kindA, int indexA,
+    BodyKind kindB, int indexB, int amount, float x, float y, float impact) {
+    GameEvent event = {
+        (unsigned char)type, (unsigned char)kindA, (unsigned char)kindB, (unsigned char)amount,
+        (short)indexA, (short)indexB, (short)x, (short)y, impact
+    };
+    return EventQueuePush(queue, event);
+}
+
+bool AddEventListener(EventListener listener, void* userData) {
+    if (listenerCount >= MAX_EVENT_LISTENERS) return false;
+
+    listeners[listenerCount].callback = listener;
+    listeners[listenerCount].userData = userData;
+    listenerCount++;
+    return true;
+}
+
+void ClearEventListeners(void) {
+    listenerCount = 0;
+}
+
+bool EmitFollowUpEvent(GameEventType type, BodyKind kindA, int indexA,
+    BodyKind kindB, int indexB, int amount, float x, float y, float impact) {
+    return EmitEvent(&followUps, type, kindA, indexA, kindB, indexB, amount, x, y, impact);
+}
+
+static void DeliverBatch(const GameEvent* batch, int count) {
+    for (int i = 0; i < listenerCount; i++) {
+        listeners[i].callback(batch, count, listeners[i].userData);
+    }
+}
+
+int DispatchEvents(EventQueue* queue) {
+    GameEvent batch[EVENT_BATCH_SIZE];
+    int total = 0;
+    int count;
+
+    while ((count = EventQueuePopBatch(queue, batch, EVENT_BATCH_SIZE)) > 0) {
+        DeliverBatch(batch, count);
+        total += count;
+
+        // Follow-ups go out right after the batch that caused them
+        while ((count = EventQueuePopBatch(&followUps, batch, EVENT_BATCH_SIZE)) > 0) {
+            DeliverBatch(batch, count);
+            total += count;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,74 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define EVENT_QUEUE_CAPACITY 256 // must be a power of two
+#define EVENT_BATCH_SIZE 64
+#define MAX_EVENT_LISTENERS 8
+
+typedef enum {
+    EVENT_CONTACT,      // two bodies touched (bounces, landings)
+    EVENT_DAMAGE,       // an enemy should take damage
+    EVENT_KILL,         // an enemy was destroyed
+    EVENT_BLOCK_BROKEN, // a resting block was knocked loose
+    EVENT_JOINT_BROKEN  // a joint snapped; kindB is BODY_NONE for world joints
+} GameEventType;
+
+typedef enum {
+    BODY_NONE,
+    BODY_BIRD,
+    BODY_BLOCK,
+    BODY_ENEMY,
+    BODY_GROUND
+} BodyKind;
+
+// Compact gameplay event (16 bytes) emitted by the physics passes
+typedef struct {
+    unsigned char type;   // GameEventType
+    unsigned char kindA;  // BodyKind that caused the event
+    unsigned char kindB;  // BodyKind that received it
+    unsigned char amount; // damage dealt
+    short indexA;
+    short indexB;
+    short x;              // contact point, in screen pixels
+    short y;
+    float impact;         // relative speed at contact
+} GameEvent;
+
+// Single-producer single-consumer ring buffer. The simulation pushes,
+// one consumer (possibly on another thread) pops.
+typedef struct {
+    GameEvent events[EVENT_QUEUE_CAPACITY];
+    atomic_uint head;      // next slot to write, owned by the producer
+    atomic_uint tail;      // next slot to read, owned by the consumer
+    unsigned int dropped;  // pushes rejected because the ring was full
+} EventQueue;
+
+// Receives events in batches, in the order they were emitted
+typedef void (*EventListener)(const GameEvent* events, int count, void* userData);
+
+void EventQueueInit(EventQueue* queue);
+void EventQueueClear(EventQueue* queue);
+bool EventQueuePush(EventQueue* queue, GameEvent event);
+int EventQueuePopBatch(EventQueue* queue, GameEvent* out, int maxCount);
+
+bool EmitEvent(EventQueue* queue, GameEventType type, BodyKind kindA, int indexA,
+    BodyKind kindB, int indexB, int amount, float x, float y, float impact);
+
+// Listeners are called in registration order for every batch
+bool AddEventListener(EventListener listener, void* userData);
+void ClearEventListeners(void);
+
+// Raises an event from inside a listener, e.g. the kill a damage event
+// caused. The queue being dispatched has the simulation as its only
+// producer, so follow-ups go to one owned by the dispatching thread.
+bool EmitFollowUpEvent(GameEventType type, BodyKind kindA, int indexA,
+    BodyKind kindB, int indexB, int amount, float x, float y, float impact);
+
+// Drains the queue in batches and hands each batch to the listeners,
+// followed by the follow-up events the batch raised
+int DispatchEvents(EventQueue* queue);
+
+#endif
@@ -0,0 +1,147 @@
+#include "explosion.h"
+#include "materials.h"
+#include "spatial.h"
+#include "sprite_shapes.h"
+#include <math.h>
+
+// Crates waiting to go off, in the order they were set off; each block is queued at most once
+static int pending[MAX_BLOCKS];
+static bool queued[MAX_BLOCKS];
+static int pendingCount = 0;
+
+static ExplosionFlash flashes[MAX_EXPLOSION_FLASHES];
+static int flashCount = 0;
+
+void QueueExplosion(int blockIndex) {
+    if (blockIndex < 0 || blockIndex >= blockCount || queued[blockIndex]) return;
+    if (!blocks[blockIndex].active || blocks[blockIndex].material != MATERIAL_TNT) return;
+
+    queued[blockIndex] = true;
+    pending[pendingCount++] = blockIndex;
+}
+
+void TriggerExplosives(const GameEvent* events, int count, void* userData) {
+    for (int i = 0; i < count; i++) {
+        if (events[i].type == EVENT_BLOCK_BROKEN && events[i].kindB == BODY_BLOCK) {
+            QueueExplosion(events[i].indexB);
+        }
+    }
+}
+
+static void AddFlash(Vector2 centre) {
+    // Oldest flash makes room
+    if (flashCount == MAX_EXPLOSION_FLASHES) {
+        for (int i = 1; i < flashCount; i++) flashes[i - 1] = flashes[i];
+        flashCount--;
+    }
+    flashes[flashCount++] = (ExplosionFlash){ centre, 0 };
+}
+
+// Function to push one block away from the blast
+static void PushBlock(int index, Vector2 centre, int source, EventQueue* events) {
+    Block* block = &blocks[index];
+    Vector2 middle = { block->rect.x + block->rect.width / 2.0f, block->rect.y + block->rect.height / 2.0f };
+    Vector2 away = { middle.x - centre.x, middle.y - centre.y };
+    float distance = sqrtf(away.x * away.x + away.y * away.y);
+    float falloff = fmaxf(1.0f - distance / EXPLOSION_RADIUS, 0.1f);
+    float speed = EXPLOSION_IMPULSE * falloff / materialTable[block->material].mass;
+
+    if (distance > 0.0f) {
+        away.x /= distance;
+        away.y /= distance;
+    }
+    else {
+        away = (Vector2){ 0.0f, -1.0f };
+    }
+
+    bool wasResting = !block->falling;
+    block->velocity.x += away.x * speed;
+    block->velocity.y += away.y * speed;
+    block->angularVelocity += ((float)GameRandomValue(-30, 30)) / 10.0f * falloff;
+    block->falling = true;
+    block->onGround = false;
+
+    if (wasResting) {
+        EmitEvent(events, EVENT_BLOCK_BROKEN, BODY_BLOCK, source, BODY_BLOCK, index, 0, middle.x, middle.y, speed);
+    }
+}
+
+static void AgeFlashes(void) {
+    for (int i = 0; i < flashCount; i++) {
+        flashes[i].age++;
+    }
+    while (flashCount > 0 && flashes[0].age >= EXPLOSION_FLASH_STEPS) {
+        for (int i = 1; i < flashCount; i++) flashes[i - 1] = flashes[i];
+        flashCount--;
+    }
+}
+
+int ResolveExplosions(EventQueue* events) {
+    int detonated = 0;
+
+    AgeFlashes();
+
+    // Chained crates are appended while the queue is walked
+    for (int n = 0; n < pendingCount; n++) {
+        int source = pending[n];
+        Block* crate = &blocks[source];
+        Vector2 centre = { crate->rect.x + crate->rect.width / 2.0f, crate->rect.y + crate->rect.height / 2.0f };
+
+        crate->active = false;
+        AddFlash(centre);
+        detonated++;
+
+        BodyRef caught[MAX_BLOCKS + MAX_ENEMIES + 1];
+        int count = SpatialQueryCircle(centre, EXPLOSION_RADIUS, caught, MAX_BLOCKS + MAX_ENEMIES + 1);
+
+        for (int i = 0; i < count; i++) {
+            int index = caught[i].index;
+
+            if (caught[i].kind == BODY_BLOCK && blocks[index].active) {
+                if (blocks[index].material == MATERIAL_TNT) QueueExplosion(index);
+                else PushBlock(index, centre, source, events);
+            }
+            else if (caught[i].kind == BODY_ENEMY && enemies[index].active) {
+                // Measured to the circle the blast caught, as the fixed world does
+                Vector2 position;
+                float radius;
+                EnemyCollisionCircle(&enemies[index], &position, &radius);
+                float distance = hypotf(position.x - centre.x, position.y - centre.y);
+                float falloff = fmaxf(1.0f - distance / EXPLOSION_RADIUS, 0.0f);
+                int damage = (int)ceilf(EXPLOSION_DAMAGE * falloff);
+
+                EmitEvent(events, EVENT_DAMAGE, BODY_BLOCK, source, BODY_ENEMY, index, damage > 0 ? damage : 1,
+                    position.x, position.y, EXPLOSION_IMPULSE * falloff);
+            }
+        }
+    }
+
+    for (int n = 0; n < pendingCount; n++) {
+        queued[pending[n]] = false;
+    }
+    pendingCount = 0;
+    return detonated;
+}
+
+void ShowExplosions(const Vector2* centres, int count) {
+    AgeFlashes();
+    for (int i = 0; i < count; i++) {
+        AddFlash(centres[i]);
+    }
+}
+
+void ClearExplosions(void) {
+    for (int i = 0; i < MAX_BLOCKS; i++) {
+        queued[i] = false;
+    }
+    pendingCount = 0;
+    flashCount = 0;
+}
+
+int RecentExplosions(ExplosionFlash* out, int capacity) {
+    int count = (flashCount < capacity) ? flashCount : capacity;
+    for (int i = 0; i < count; i++) {
+        out[i] = flashes[i];
+    }
+    return count;
+}
@@ -0,0 +1,44 @@
+#ifndef EXPLOSION_H
+#define EXPLOSION_H
+
+#include "game.h"
+#include "events.h"
+
+#define EXPLOSION_RADIUS 110.0f
+#define EXPLOSION_IMPULSE 24.0f  // speed given to a mass-1 body at the centre, falling off to 0 at the radius
+#define EXPLOSION_DAMAGE 3       // at the centre; anything caught takes at least 1
+#define EXPLOSION_FLASH_STEPS 20 // how long a blast stays on screen
+#define MAX_EXPLOSION_FLASHES 8
+
+// A recent blast, for drawing
+typedef struct {
+    Vector2 centre;
+    int age;  // steps since it went off
+} ExplosionFlash;
+
+// Queues TNT block blockIndex to go off in the next ResolveExplosions().
+// Anything else, or a crate already queued or gone, is ignored.
+void QueueExplosion(int blockIndex);
+
+// Event listener that queues TNT blocks knocked loose by the bird or
+// another block
+void TriggerExplosives(const GameEvent* events, int count, void* userData);
+
+// Detonates every queued crate. Blocks within EXPLOSION_RADIUS are pushed
+// away from the centre, enemies get EVENT_DAMAGE (resolved through
+// DamageEnemy), and TNT caught in the blast is queued behind it, so a
+// whole chain goes off in one step. Bodies are found with a spatial query.
+// Returns the number of crates that went off.
+int ResolveExplosions(EventQueue* events);
+
+// For fixed-point builds, whose world sets off its own crates: ages the
+// flashes by a step, as ResolveExplosions() does, and adds the blasts at
+// centres
+void ShowExplosions(const Vector2* centres, int count);
+
+// Drops queued crates and flashes (level loads, rewinds)
+void ClearExplosions(void);
+
+int RecentExplosions(ExplosionFlash* flashes, int capacity);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+// Q16.16 fixed point: integer arithmetic only, so results are bit-identical
+// on every compiler and CPU
+typedef int32_t fixed;
+
+typedef struct {
+    fixed x;
+    fixed y;
+} FixVec2;
+
+#define FIX_SHIFT 16
+#define FIX_ONE (1 << FIX_SHIFT)
+
+// Only for compile-time constants and exact inputs (integers, halves...)
+#define FIX(value) ((fixed)((value) * 65536.0))
+
+static inline fixed FixFromInt(int value) {
+    return (fixed)((uint32_t)value << FIX_SHIFT);
+}
+
+static inline float FixToFloat(fixed value) {
+    return (float)value / 65536.0f;
+}
+
+static inline fixed FixFromFloat(float value) {
+    return (fixed)(value * 65536.0f);
+}
+
+static inline fixed FixMul(fixed a, fixed b) {
+    return (fixed)(((int64_t)a * b) >> FIX_SHIFT);
+}
+
+static inline fixed FixDiv(fixed a, fixed b) {
+    return (fixed)(((int64_t)a << FIX_SHIFT) / b);
+}
+
+static inline fixed FixAbs(fixed value) {
+    return value < 0 ? -value : value;
+}
+
+// Function to compute floor(sqrt(n)) by integer Newton iteration (no FPU)
+static inline uint64_t FixIsqrt64(uint64_t n) {
+    if (n < 2) return n;
+
+    // Start from the power of two just above the root, so Newton takes a few
+    // steps rather than one per halving of n
+    int bits = 0;
+    for (uint64_t m = n; m != 0; m >>= 2) bits++;
+    uint64_t x = (uint64_t)1 << bits;
+    uint64_t y = (x + n / x) >> 1;
+    while (y < x) {
+        x = y;
+        y = (x + n / x) >> 1;
+    }
+    return x;
+}
+
+static inline fixed FixSqrt(fixed value) {
+    if (value <= 0) return 0;
+    return (fixed)FixIsqrt64((uint64_t)value << FIX_SHIFT);
+}
+
+// Length of (x, y); the squares are summed in 64 bits so fast birds don't overflow
+static inline fixed FixLength(fixed x, fixed y) {
+    uint64_t squared = (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y);
+    return (fixed)FixIsqrt64(squared);
+}
+
+#define FIX_PI FIX(3.14159265358979)
+#define FIX_HALF_PI FIX(1.57079632679490)
+
+// Function to compute sin(angle) in radians: the angle is folded into
+// [-pi/2, pi/2], then a Taylor series to x^9 (error under 1e-5)
+static inline fixed FixSin(fixed angle) {
+    fixed a = angle % (2 * FIX_PI);
+    if (a > FIX_PI) a -= 2 * FIX_PI;
+    if (a < -FIX_PI) a += 2 * FIX_PI;
+    if (a > FIX_HALF_PI) a = FIX_PI - a;
+    if (a < -FIX_HALF_PI) a = -FIX_PI - a;
+
+    fixed squared = FixMul(a, a);
+    fixed series = FIX_ONE - FixMul(squared, FIX_ONE) / 72;
+    series = FIX_ONE - FixMul(squared, series) / 42;
+    series = FIX_ONE - FixMul(squared, series) / 20;
+    series = FIX_ONE - FixMul(squared, series) / 6;
+    return FixMul(a, series);
+}
+
+static inline fixed FixCos(fixed angle) {
+    return FixSin(angle + FIX_HALF_PI);
+}
+
+#endif
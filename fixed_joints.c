@@ -0,0 +1,276 @@
+#include "fixed_joints.h"
+
+#define FIX_WARM_START FIX(JOINT_WARM_START)
+#define FIX_POSITION_BIAS FIX(JOINT_POSITION_BIAS)
+#define FIX_MAX_CORRECTION FIX(JOINT_MAX_CORRECTION)
+
+static FixVec2 Rotate(FixVec2 v, fixed angle) {
+    fixed c = FixCos(angle);
+    fixed s = FixSin(angle);
+    return (FixVec2){ FixMul(v.x, c) - FixMul(v.y, s), FixMul(v.x, s) + FixMul(v.y, c) };
+}
+
+// Torques can pass the Q16.16 range (a heavy block far from its anchor), so they stay in 64 bits
+static int64_t Cross(FixVec2 a, FixVec2 b) {
+    return ((int64_t)a.x * b.y - (int64_t)a.y * b.x) >> FIX_SHIFT;
+}
+
+// Function to turn a torque (or angular impulse) into the spin it gives body
+static fixed Turn(const FixedJointBody* body, int64_t torque) {
+    return (body->inertia > 0) ? (fixed)(torque * FIX_ONE / body->inertia) : 0;
+}
+
+// The inertia two bodies share about a weld, 1 / (1/Ia + 1/Ib); 0 if neither turns
+static int64_t SharedInertia(const FixedJointBody* a, const FixedJointBody* b) {
+    if (a->inertia <= 0) return b->inertia;
+    if (b->inertia <= 0) return a->inertia;
+    return a->inertia * ((b->inertia * FIX_ONE) / (a->inertia + b->inertia)) >> FIX_SHIFT;
+}
+
+static FixVec2 PointVelocity(const FixedJointBody* body, FixVec2 r) {
+    return (FixVec2){ body->velocity.x - FixMul(body->angularVelocity, r.y), body->velocity.y + FixMul(body->angularVelocity, r.x) };
+}
+
+FixedJoint FixedJointFromJoint(const Joint* joint) {
+    FixedJoint fixedJoint;
+    fixedJoint.type = joint->type;
+    fixedJoint.broken = joint->broken;
+    fixedJoint.bodyA = joint->bodyA;
+    fixedJoint.bodyB = joint->bodyB;
+    fixedJoint.anchorA = (FixVec2){ FixFromFloat(joint->anchorA.x), FixFromFloat(joint->anchorA.y) };
+    fixedJoint.anchorB = (FixVec2){ FixFromFloat(joint->anchorB.x), FixFromFloat(joint->anchorB.y) };
+    fixedJoint.length = FixFromFloat(joint->length);
+    fixedJoint.angle = FixFromFloat(joint->angle);
+    fixedJoint.breakForce = FixFromFloat(joint->breakForce);
+    fixedJoint.impulse = (FixVec2){ FixFromFloat(joint->impulse.x), FixFromFloat(joint->impulse.y) };
+    fixedJoint.angularImpulse = FixFromFloat(joint->angularImpulse);
+    return fixedJoint;
+}
+
+FixedJointBody MakeFixedJointBody(FixVec2 centre, fixed width, fixed height, fixed density) {
+    FixedJointBody body = { centre, { 0, 0 }, 0, 0, 0, 0 };
+    int64_t mass = ((((int64_t)density * width) >> FIX_SHIFT) * height >> FIX_SHIFT) / 1000;
+    if (mass <= 0) return body;
+
+    int64_t squares = (((int64_t)width * width) >> FIX_SHIFT) + (((int64_t)height * height) >> FIX_SHIFT);
+    body.invMass = (fixed)(((int64_t)FIX_ONE << FIX_SHIFT) / mass);
+    body.inertia = ((mass * squares) >> FIX_SHIFT) / 12;
+    return body;
+}
+
+FixVec2 FixedJointAnchorA(const FixedJoint* joint, const FixedJointBody* bodies) {
+    const FixedJointBody* a = &bodies[joint->bodyA];
+    FixVec2 r = Rotate(joint->anchorA, a->rotation);
+    return (FixVec2){ a->centre.x + r.x, a->centre.y + r.y };
+}
+
+// Function to change a body's velocity; it has already moved this step, so it moves again by the change
+static void Push(FixedJointBody* body, FixVec2 velocity, fixed angular) {
+    body->velocity.x += velocity.x;
+    body->velocity.y += velocity.y;
+    body->angularVelocity += angular;
+    body->centre.x += velocity.x;
+    body->centre.y += velocity.y;
+    body->rotation += angular;
+}
+
+static void ApplyImpulse(FixedJointFrame* frame, FixVec2 impulse) {
+    FixedJointBody* a = frame->a;
+    FixedJointBody* b = frame->b;
+    Push(a, (FixVec2){ -FixMul(a->invMass, impulse.x), -FixMul(a->invMass, impulse.y) }, -Turn(a, Cross(frame->rA, impulse)));
+    Push(b, (FixVec2){ FixMul(b->invMass, impulse.x), FixMul(b->invMass, impulse.y) }, Turn(b, Cross(frame->rB, impulse)));
+}
+
+static void ApplyAngularImpulse(FixedJointFrame* frame, fixed impulse) {
+    Push(frame->a, (FixVec2){ 0, 0 }, -Turn(frame->a, impulse));
+    Push(frame->b, (FixVec2){ 0, 0 }, Turn(frame->b, impulse));
+}
+
+static fixed AxisMass(const FixedJointFrame* frame, FixVec2 axis) {
+    int64_t crossA = Cross(frame->rA, axis);
+    int64_t crossB = Cross(frame->rB, axis);
+    int64_t k = (int64_t)frame->a->invMass + frame->b->invMass +
+        Turn(frame->a, (crossA * crossA) >> FIX_SHIFT) + Turn(frame->b, (crossB * crossB) >> FIX_SHIFT);
+    return (k > 0) ? (fixed)(((int64_t)FIX_ONE << FIX_SHIFT) / k) : 0;
+}
+
+// Function to fill in the point-to-point K matrix for a frame's lever arms
+static void PointMass(FixedJointFrame* frame) {
+    const FixedJointBody* a = frame->a;
+    const FixedJointBody* b = frame->b;
+    FixVec2 rA = frame->rA;
+    FixVec2 rB = frame->rB;
+
+    frame->k11 = (int64_t)a->invMass + b->invMass +
+        Turn(a, ((int64_t)rA.y * rA.y) >> FIX_SHIFT) + Turn(b, ((int64_t)rB.y * rB.y) >> FIX_SHIFT);
+    frame->k12 = -(int64_t)Turn(a, ((int64_t)rA.x * rA.y) >> FIX_SHIFT) - Turn(b, ((int64_t)rB.x * rB.y) >> FIX_SHIFT);
+    frame->k22 = (int64_t)a->invMass + b->invMass +
+        Turn(a, ((int64_t)rA.x * rA.x) >> FIX_SHIFT) + Turn(b, ((int64_t)rB.x * rB.x) >> FIX_SHIFT);
+}
+
+// Function to solve K * impulse = -error for a point-to-point constraint
+static FixVec2 PointImpulse(const FixedJointFrame* frame, FixVec2 error) {
+    int64_t det = frame->k11 * frame->k22 - frame->k12 * frame->k12;
+    if (det == 0) return (FixVec2){ 0, 0 };
+
+    return (FixVec2){
+        (fixed)(-(frame->k22 * error.x - frame->k12 * error.y) * FIX_ONE / det),
+        (fixed)(-(frame->k11 * error.y - frame->k12 * error.x) * FIX_ONE / det)
+    };
+}
+
+// Masses along the joint are worked out here once; they hold for every pass over the frame
+static FixedJointFrame FrameJoint(const FixedJoint* joint, FixedJointBody* bodies, FixedJointBody* worldBody) {
+    FixedJointFrame frame;
+    bool toWorld = joint->bodyB == JOINT_WORLD;
+    frame.a = &bodies[joint->bodyA];
+    frame.b = toWorld ? worldBody : &bodies[joint->bodyB];
+    frame.rA = Rotate(joint->anchorA, frame.a->rotation);
+    frame.rB = toWorld ? (FixVec2){ 0, 0 } : Rotate(joint->anchorB, frame.b->rotation);
+
+    FixVec2 pA = { frame.a->centre.x + frame.rA.x, frame.a->centre.y + frame.rA.y };
+    FixVec2 pB = toWorld ? joint->anchorB : (FixVec2){ frame.b->centre.x + frame.rB.x, frame.b->centre.y + frame.rB.y };
+    FixVec2 d = { pB.x - pA.x, pB.y - pA.y };
+
+    frame.distance = FixLength(d.x, d.y);
+    frame.axis = (frame.distance > 0) ? (FixVec2){ FixDiv(d.x, frame.distance), FixDiv(d.y, frame.distance) } : (FixVec2){ 0, FIX_ONE };
+    frame.active = joint->type != JOINT_ROPE || frame.distance >= joint->length;
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) frame.axisMass = AxisMass(&frame, frame.axis);
+    else PointMass(&frame);
+    return frame;
+}
+
+static void WarmStart(FixedJoint* joint, FixedJointFrame* frame) {
+    joint->impulse.x = FixMul(joint->impulse.x, FIX_WARM_START);
+    joint->impulse.y = FixMul(joint->impulse.y, FIX_WARM_START);
+    joint->angularImpulse = FixMul(joint->angularImpulse, FIX_WARM_START);
+
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+        if (!frame->active) {
+            joint->impulse.x = 0;
+            return;
+        }
+        ApplyImpulse(frame, (FixVec2){ FixMul(frame->axis.x, joint->impulse.x), FixMul(frame->axis.y, joint->impulse.x) });
+        return;
+    }
+
+    ApplyImpulse(frame, joint->impulse);
+    if (joint->type == JOINT_WELD) ApplyAngularImpulse(frame, joint->angularImpulse);
+}
+
+static void SolveVelocity(FixedJoint* joint, FixedJointFrame* frame) {
+    FixVec2 vA = PointVelocity(frame->a, frame->rA);
+    FixVec2 vB = PointVelocity(frame->b, frame->rB);
+    FixVec2 relative = { vB.x - vA.x, vB.y - vA.y };
+
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+        if (!frame->active) return;
+
+        fixed speed = FixMul(relative.x, frame->axis.x) + FixMul(relative.y, frame->axis.y);
+        fixed lambda = -FixMul(speed, frame->axisMass);
+        fixed previous = joint->impulse.x;
+        joint->impulse.x += lambda;
+        if (joint->type == JOINT_ROPE && joint->impulse.x > 0) joint->impulse.x = 0;  // ropes only pull
+        lambda = joint->impulse.x - previous;
+
+        ApplyImpulse(frame, (FixVec2){ FixMul(frame->axis.x, lambda), FixMul(frame->axis.y, lambda) });
+        return;
+    }
+
+    if (joint->type == JOINT_WELD) {
+        int64_t shared = SharedInertia(frame->a, frame->b);
+        if (shared > 0) {
+            fixed lambda = (fixed)(-(int64_t)(frame->b->angularVelocity - frame->a->angularVelocity) * shared >> FIX_SHIFT);
+            joint->angularImpulse += lambda;
+            ApplyAngularImpulse(frame, lambda);
+        }
+        vA = PointVelocity(frame->a, frame->rA);
+        vB = PointVelocity(frame->b, frame->rB);
+        relative = (FixVec2){ vB.x - vA.x, vB.y - vA.y };
+    }
+
+    FixVec2 impulse = PointImpulse(frame, relative);
+    joint->impulse.x += impulse.x;
+    joint->impulse.y += impulse.y;
+    ApplyImpulse(frame, impulse);
+}
+
+static void ApplyCorrection(FixedJointFrame* frame, FixVec2 impulse) {
+    frame->a->centre.x -= FixMul(frame->a->invMass, impulse.x);
+    frame->a->centre.y -= FixMul(frame->a->invMass, impulse.y);
+    frame->a->rotation -= Turn(frame->a, Cross(frame->rA, impulse));
+    frame->b->centre.x += FixMul(frame->b->invMass, impulse.x);
+    frame->b->centre.y += FixMul(frame->b->invMass, impulse.y);
+    frame->b->rotation += Turn(frame->b, Cross(frame->rB, impulse));
+}
+
+static fixed Clamp(fixed value, fixed limit) {
+    return (value > limit) ? limit : (value < -limit) ? -limit : value;
+}
+
+static void SolvePosition(const FixedJoint* joint, FixedJointBody* bodies, FixedJointBody* worldBody) {
+    FixedJointFrame frame = FrameJoint(joint, bodies, worldBody);
+
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+        if (!frame.active) return;
+
+        fixed error = Clamp(frame.distance - joint->length, FIX_MAX_CORRECTION);
+        fixed lambda = -FixMul(FixMul(FIX_POSITION_BIAS, error), frame.axisMass);
+        ApplyCorrection(&frame, (FixVec2){ FixMul(frame.axis.x, lambda), FixMul(frame.axis.y, lambda) });
+        return;
+    }
+
+    if (joint->type == JOINT_WELD) {
+        int64_t shared = SharedInertia(frame.a, frame.b);
+        if (shared > 0) {
+            fixed error = frame.b->rotation - frame.a->rotation - joint->angle;
+            int64_t lambda = -(int64_t)FixMul(FIX_POSITION_BIAS, error) * shared >> FIX_SHIFT;
+            frame.a->rotation -= Turn(frame.a, lambda);
+            frame.b->rotation += Turn(frame.b, lambda);
+        }
+        frame = FrameJoint(joint, bodies, worldBody);
+    }
+
+    FixVec2 error = { Clamp(FixMul(frame.axis.x, frame.distance), FIX_MAX_CORRECTION),
+        Clamp(FixMul(frame.axis.y, frame.distance), FIX_MAX_CORRECTION) };
+    FixVec2 impulse = PointImpulse(&frame, error);
+    ApplyCorrection(&frame, (FixVec2){ FixMul(impulse.x, FIX_POSITION_BIAS), FixMul(impulse.y, FIX_POSITION_BIAS) });
+}
+
+int SolveFixedJoints(FixedJoint* joints, int jointCount, FixedJointBody* bodies, FixedJointFrame* frames) {
+    int broke = 0;
+    // Stands in for bodyB of world joints; one per call, so worlds on other threads don't share it
+    FixedJointBody worldBody = { { 0, 0 }, { 0, 0 }, 0, 0, 0, 0 };
+
+    for (int i = 0; i < jointCount; i++) {
+        if (joints[i].broken) continue;
+        frames[i] = FrameJoint(&joints[i], bodies, &worldBody);
+        WarmStart(&joints[i], &frames[i]);
+    }
+
+    // Lever arms are kept for every pass as in joints.c; the position passes re-measure
+    for (int iteration = 0; iteration < JOINT_VELOCITY_ITERATIONS; iteration++) {
+        for (int i = 0; i < jointCount; i++) {
+            if (joints[i].broken) continue;
+            SolveVelocity(&joints[i], &frames[i]);
+        }
+    }
+
+    for (int i = 0; i < jointCount; i++) {
+        FixedJoint* joint = &joints[i];
+        if (joint->broken || joint->breakForce <= 0) continue;
+
+        if (FixLength(joint->impulse.x, joint->impulse.y) > joint->breakForce) {
+            joint->broken = true;
+            broke++;
+        }
+    }
+
+    for (int iteration = 0; iteration < JOINT_POSITION_ITERATIONS; iteration++) {
+        for (int i = 0; i < jointCount; i++) {
+            if (!joints[i].broken) SolvePosition(&joints[i], bodies, &worldBody);
+        }
+    }
+
+    return broke;
+}
@@ -0,0 +1,60 @@
+#ifndef FIXED_JOINTS_H
+#define FIXED_JOINTS_H
+
+#include "fixed.h"
+#include "joints.h"
+
+// The joints.c solver in Q16.16, for the fixed-point world. Same joint
+// types, iterations and constants; the world always steps 1/60 s, so
+// there is no scale.
+typedef struct {
+    unsigned char type;  // JointType
+    bool broken;
+    short bodyA;
+    short bodyB;         // or JOINT_WORLD
+    FixVec2 anchorA;
+    FixVec2 anchorB;
+    fixed length;
+    fixed angle;
+    fixed breakForce;    // 0 for unbreakable
+
+    FixVec2 impulse;
+    fixed angularImpulse;
+} FixedJoint;
+
+// Inertia is kept in 64 bits: a big stone block's overflows Q16.16, and its
+// inverse would round to nothing. Zero inverse mass and inertia mark a
+// static body.
+typedef struct {
+    FixVec2 centre;
+    FixVec2 velocity;
+    fixed rotation;
+    fixed angularVelocity;
+    fixed invMass;
+    int64_t inertia;
+} FixedJointBody;
+
+typedef struct {
+    FixedJointBody* a;
+    FixedJointBody* b;
+    FixVec2 rA;
+    FixVec2 rB;
+    FixVec2 axis;
+    fixed distance;
+    bool active;
+    fixed axisMass;           // distance and rope joints
+    int64_t k11, k12, k22;    // the rest: point-to-point K matrix
+} FixedJointFrame;
+
+FixedJoint FixedJointFromJoint(const Joint* joint);
+
+// Mass properties of a width x height box of the given density, as MakeJointBody()
+FixedJointBody MakeFixedJointBody(FixVec2 centre, fixed width, fixed height, fixed density);
+
+FixVec2 FixedJointAnchorA(const FixedJoint* joint, const FixedJointBody* bodies);
+
+// As SolveJoints() with a scale of one step; frames is scratch for
+// jointCount joints. Touches no globals. Returns how many joints broke.
+int SolveFixedJoints(FixedJoint* joints, int jointCount, FixedJointBody* bodies, FixedJointFrame* frames);
+
+#endif
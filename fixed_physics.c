@@ -0,0 +1,840 @@
+#include "fixed_physics.h"
+#include "bodies.h"
+#include "explosion.h"
+#include "materials.h"
+#include "sprite_shapes.h"
+#include <stdio.h>
+#include <string.h>
+
+// Per-step constants of the float path with deltaTime * 60 == 1
+#define FIX_GRAVITY FIX(0.41)
+#define FIX_GROUND_Y FIX(SCREEN_HEIGHT - GROUND_HEIGHT)
+#define FIX_SCREEN_WIDTH FixFromInt(SCREEN_WIDTH)
+#define FIX_SLING_X FixFromInt(150)
+#define FIX_SLING_Y FixFromInt(400)
+#define FIX_BLAST_RADIUS FIX(EXPLOSION_RADIUS)
+#define FIX_BLAST_IMPULSE FIX(EXPLOSION_IMPULSE)
+
+typedef struct {
+    fixed gravity; // block gravity (0.5) scaled by mass
+    fixed friction;
+    fixed bounciness;
+    fixed mass;        // density, for joints
+    fixed inverseMass; // for blast pushes
+} FixedMaterial;
+
+static const FixedMaterial fixedMaterialTable[MATERIAL_COUNT] = {
+#define FIXED_MATERIAL_ENTRY(id, name, mass, friction, bounciness) { FIX(0.5 * (mass)), FIX(friction), FIX(bounciness), FIX(mass), FIX(1.0 / (mass)) },
+    MATERIAL_LIST(FIXED_MATERIAL_ENTRY)
+#undef FIXED_MATERIAL_ENTRY
+};
+
+// Damage is applied at the end of the step, like the float path's event dispatch
+typedef struct {
+    BodyKind source;
+    int sourceIndex;
+    int enemy;
+    int amount;
+} PendingDamage;
+
+// Crates set off this step, in the order they were set off; each block at most once
+typedef struct {
+    int crates[MAX_BLOCKS];
+    bool queued[MAX_BLOCKS];
+    int count;
+} BlastQueue;
+
+static int FixedRandomValue(FixedWorld* world, int min, int max) {
+    world->rngState ^= world->rngState << 13;
+    world->rngState ^= world->rngState >> 17;
+    world->rngState ^= world->rngState << 5;
+    return min + (int)(world->rngState % (unsigned int)(max - min + 1));
+}
+
+// Same test as raylib's CheckCollisionCircleRec, squares kept in 64 bits
+static bool FixCircleRec(FixVec2 center, fixed radius, FixVec2 position, FixVec2 size) {
+    fixed halfWidth = size.x / 2;
+    fixed halfHeight = size.y / 2;
+    fixed dx = FixAbs(center.x - (position.x + halfWidth));
+    fixed dy = FixAbs(center.y - (position.y + halfHeight));
+
+    if (dx > halfWidth + radius) return false;
+    if (dy > halfHeight + radius) return false;
+    if (dx <= halfWidth) return true;
+    if (dy <= halfHeight) return true;
+
+    int64_t cornerX = dx - halfWidth;
+    int64_t cornerY = dy - halfHeight;
+    return cornerX * cornerX + cornerY * cornerY <= (int64_t)radius * radius;
+}
+
+static bool FixCircles(FixVec2 a, fixed radiusA, FixVec2 b, fixed radiusB) {
+    int64_t dx = a.x - b.x;
+    int64_t dy = a.y - b.y;
+    int64_t reach = (int64_t)radiusA + radiusB;
+    return dx * dx + dy * dy <= reach * reach;
+}
+
+// Collision passes test the traced shapes, as UpdateWorld does; moving, landing and joints keep the body's own
+static FixVec2 ShapeCorner(const FixedBlock* block) {
+    return (FixVec2){ block->position.x + block->shapeOffset.x, block->position.y + block->shapeOffset.y };
+}
+
+static FixVec2 BirdCentre(const FixedWorld* world) {
+    return (FixVec2){ world->bird.position.x + world->birdShapeOffset.x, world->bird.position.y + world->birdShapeOffset.y };
+}
+
+static bool FixRecs(const FixedBlock* a, const FixedBlock* b) {
+    FixVec2 cornerA = ShapeCorner(a);
+    FixVec2 cornerB = ShapeCorner(b);
+    return cornerA.x < cornerB.x + b->shapeSize.x && cornerA.x + a->shapeSize.x > cornerB.x &&
+        cornerA.y < cornerB.y + b->shapeSize.y && cornerA.y + a->shapeSize.y > cornerB.y;
+}
+
+static FixedBird RestingBird(void) {
+    return (FixedBird){ { FIX_SLING_X, FIX_SLING_Y }, { 0, 0 }, FixFromInt(15), false };
+}
+
+// Function to convert float bodies into the fixed world (touches no globals);
+// sourceTimers holds the enemies' cooldowns, NULL when they have none
+static void ImportBodies(FixedWorld* world, const Block* sourceBlocks, int sourceBlockCount,
+    const Enemy* sourceEnemies, int sourceEnemyCount, const TimerWheel* sourceTimers) {
+    ClearTimers(&world->timers);
+
+    world->blockCount = sourceBlockCount;
+    for (int i = 0; i < sourceBlockCount; i++) {
+        const Block* source = &sourceBlocks[i];
+        FixedBlock* block = &world->blocks[i];
+        block->position = (FixVec2){ FixFromFloat(source->rect.x), FixFromFloat(source->rect.y) };
+        block->size = (FixVec2){ FixFromFloat(source->rect.width), FixFromFloat(source->rect.height) };
+        Rectangle shape = BlockCollisionRect(source, i);
+        block->shapeOffset = (FixVec2){ FixFromFloat(shape.x - source->rect.x), FixFromFloat(shape.y - source->rect.y) };
+        block->shapeSize = (FixVec2){ FixFromFloat(shape.width), FixFromFloat(shape.height) };
+        block->velocity = (FixVec2){ FixFromFloat(source->velocity.x), FixFromFloat(source->velocity.y) };
+        block->rotation = FixFromFloat(source->rotation);
+        block->angularVelocity = FixFromFloat(source->angularVelocity);
+        block->material = source->material;
+        block->active = source->active;
+        block->falling = source->falling;
+        block->onGround = source->onGround;
+    }
+
+    world->enemyCount = sourceEnemyCount;
+    for (int i = 0; i < sourceEnemyCount; i++) {
+        const Enemy* source = &sourceEnemies[i];
+        FixedEnemy* enemy = &world->enemies[i];
+        Vector2 centre;
+        float radius;
+        EnemyCollisionCircle(source, &centre, &radius);
+        enemy->shapeOffset = (FixVec2){ FixFromFloat(centre.x - source->position.x), FixFromFloat(centre.y - source->position.y) };
+        enemy->position = (FixVec2){ FixFromFloat(source->position.x) + enemy->shapeOffset.x,
+            FixFromFloat(source->position.y) + enemy->shapeOffset.y };
+        enemy->velocity = (FixVec2){ FixFromFloat(source->velocity.x), FixFromFloat(source->velocity.y) };
+        enemy->radius = FixFromFloat(radius);
+        enemy->health = source->health;
+        enemy->maxHealth = source->maxHealth;
+        unsigned int cooldown = (sourceTimers != NULL) ? TimerRemaining(sourceTimers, source->hitCooldown) : 0;
+        enemy->hitCooldown = (cooldown > 0) ? ScheduleTimer(&world->timers, cooldown, TIMER_ENEMY_RECOVER, i) : TIMER_NONE;
+        enemy->active = source->active;
+        enemy->falling = source->falling;
+        enemy->landed = source->landed;
+    }
+}
+
+static void ImportBirdShape(FixedWorld* world, const Bird* bird) {
+    Vector2 centre;
+    float radius;
+    BirdCollisionCircle(bird, &centre, &radius);
+    world->birdShapeOffset = (FixVec2){ FixFromFloat(centre.x - bird->position.x), FixFromFloat(centre.y - bird->position.y) };
+    world->birdShapeRadius = FixFromFloat(radius);
+}
+
+static void ImportJoints(FixedWorld* world, const Joint* sourceJoints, int sourceJointCount) {
+    world->jointCount = sourceJointCount;
+    for (int i = 0; i < sourceJointCount; i++) {
+        world->joints[i] = FixedJointFromJoint(&sourceJoints[i]);
+    }
+}
+
+void FixedWorldReset(FixedWorld* world, unsigned int seed) {
+    Bird bird = { { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+
+    SeedGameRandom(seed);
+    FixedWorldImport(world, &bird, 0, 3, false, 0);
+}
+
+void FixedWorldLoadLevel(FixedWorld* world, const LevelData* level, unsigned int seed) {
+    memset(world, 0, sizeof(*world));
+
+    world->bird = RestingBird();
+    ImportBirdShape(world, &(Bird){ { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f });
+    ImportBodies(world, level->blocks, level->blockCount, level->enemies, level->enemyCount, NULL);
+    ImportJoints(world, level->joints, level->jointCount);
+    world->lives = 3;
+    world->rngState = (seed != 0) ? seed : 0x9E3779B9u; // as SeedGameRandom()
+}
+
+void FixedWorldImport(FixedWorld* world, const Bird* bird, int score, int lives, bool gameOver, unsigned int step) {
+    memset(world, 0, sizeof(*world));
+
+    world->bird.position = (FixVec2){ FixFromFloat(bird->position.x), FixFromFloat(bird->position.y) };
+    world->bird.velocity = (FixVec2){ FixFromFloat(bird->velocity.x), FixFromFloat(bird->velocity.y) };
+    world->bird.radius = FixFromFloat(bird->radius);
+    world->bird.launched = bird->launched;
+    ImportBirdShape(world, bird);
+
+    ImportBodies(world, blocks, blockCount, enemies, enemyCount, &gameTimers);
+    ImportJoints(world, joints, jointCount);
+
+    world->score = score;
+    world->lives = lives;
+    world->gameOver = gameOver;
+    world->rngState = gameRngState;
+    world->step = step;
+}
+
+void FixedWorldExport(const FixedWorld* world, Bird* bird, int* lives, bool* gameOver) {
+    bird->position = (Vector2){ FixToFloat(world->bird.position.x), FixToFloat(world->bird.position.y) };
+    bird->velocity = (Vector2){ FixToFloat(world->bird.velocity.x), FixToFloat(world->bird.velocity.y) };
+    bird->radius = FixToFloat(world->bird.radius);
+    bird->launched = world->bird.launched;
+
+    for (int i = 0; i < world->blockCount; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        blocks[i].rect.x = FixToFloat(block->position.x);
+        blocks[i].rect.y = FixToFloat(block->position.y);
+        blocks[i].velocity = (Vector2){ FixToFloat(block->velocity.x), FixToFloat(block->velocity.y) };
+        blocks[i].rotation = FixToFloat(block->rotation);
+        blocks[i].angularVelocity = FixToFloat(block->angularVelocity);
+        blocks[i].active = block->active;
+        blocks[i].falling = block->falling;
+        blocks[i].onGround = block->onGround;
+    }
+
+    for (int i = 0; i < world->enemyCount; i++) {
+        const FixedEnemy* enemy = &world->enemies[i];
+        enemies[i].position = (Vector2){ FixToFloat(enemy->position.x - enemy->shapeOffset.x),
+            FixToFloat(enemy->position.y - enemy->shapeOffset.y) };
+        enemies[i].velocity = (Vector2){ FixToFloat(enemy->velocity.x), FixToFloat(enemy->velocity.y) };
+        enemies[i].health = enemy->health;
+        // The float copy keeps its cooldown on the game's wheel, so a rewind can hand it back
+        unsigned int cooldown = TimerRemaining(&world->timers, enemy->hitCooldown);
+        if (TimerRemaining(&gameTimers, enemies[i].hitCooldown) != cooldown) {
+            CancelTimer(&gameTimers, enemies[i].hitCooldown);
+            enemies[i].hitCooldown = (cooldown > 0) ? ScheduleTimer(&gameTimers, cooldown, TIMER_ENEMY_RECOVER, i) : TIMER_NONE;
+        }
+        enemies[i].active = enemy->active;
+        enemies[i].falling = enemy->falling;
+        enemies[i].landed = enemy->landed;
+    }
+
+    for (int i = 0; i < world->jointCount; i++) {
+        const FixedJoint* joint = &world->joints[i];
+        joints[i].broken = joint->broken;
+        joints[i].impulse = (Vector2){ FixToFloat(joint->impulse.x), FixToFloat(joint->impulse.y) };
+        joints[i].angularImpulse = FixToFloat(joint->angularImpulse);
+    }
+
+    *lives = world->lives;
+    *gameOver = world->gameOver;
+    gameRngState = world->rngState;
+}
+
+void FixedWorldLaunch(FixedWorld* world, int pullX, int pullY) {
+    world->bird.position = (FixVec2){ FixFromInt(pullX), FixFromInt(pullY) };
+    world->bird.velocity = (FixVec2){
+        FixMul(FIX_SLING_X - world->bird.position.x, FIX(0.2)),
+        FixMul(FIX_SLING_Y - world->bird.position.y, FIX(0.2))
+    };
+    world->bird.launched = true;
+}
+
+static void UpdateFixedBlocks(FixedWorld* world, EventQueue* events) {
+    for (int i = 0; i < world->blockCount; i++) {
+        FixedBlock* block = &world->blocks[i];
+        if (!block->active || block->onGround || !block->falling) continue;
+
+        const FixedMaterial* material = &fixedMaterialTable[block->material];
+
+        block->velocity.y += material->gravity;
+        block->velocity.x = FixMul(block->velocity.x, FIX(0.98));
+        block->velocity.y = FixMul(block->velocity.y, FIX(0.99));
+
+        block->position.x += block->velocity.x;
+        block->position.y += block->velocity.y;
+
+        block->rotation += block->angularVelocity;
+        block->angularVelocity = FixMul(block->angularVelocity, FIX(0.95));
+
+        if (block->position.y + block->size.y >= FIX_GROUND_Y) {
+            block->position.y = FIX_GROUND_Y - block->size.y;
+            if (events) {
+                EmitEvent(events, EVENT_CONTACT, BODY_BLOCK, i, BODY_GROUND, -1, 0,
+                    FixToFloat(block->position.x + block->size.x / 2), FixToFloat(FIX_GROUND_Y),
+                    FixToFloat(FixAbs(block->velocity.y)));
+            }
+
+            block->velocity.y = -FixMul(block->velocity.y, material->bounciness);
+            block->velocity.x = FixMul(block->velocity.x, material->friction);
+            block->angularVelocity = FixMul(block->angularVelocity, FIX(0.7));
+
+            if (FixAbs(block->velocity.y) < FIX_ONE && FixAbs(block->velocity.x) < FIX(0.5)) {
+                block->velocity = (FixVec2){ 0, 0 };
+                block->angularVelocity = 0;
+                block->falling = false;
+                block->onGround = true;
+            }
+        }
+
+        if (block->position.x < 0) {
+            block->position.x = 0;
+            block->velocity.x = -block->velocity.x / 2;
+        }
+        if (block->position.x + block->size.x > FIX_SCREEN_WIDTH) {
+            block->position.x = FIX_SCREEN_WIDTH - block->size.x;
+            block->velocity.x = -block->velocity.x / 2;
+        }
+    }
+}
+
+static bool FixedBlockAwake(const FixedWorld* world, int index) {
+    const FixedBlock* block = &world->blocks[index];
+    return block->active && block->falling && !block->onGround;
+}
+
+// Function to hold jointed blocks together after they have moved, as
+// StepJoints in bodies.c: resting blocks are fixed anchors, a moving block
+// wakes whatever it is joined to, and a block hanging still goes back to rest
+static void StepFixedJoints(FixedWorld* world, EventQueue* events) {
+    if (world->jointCount == 0) return;
+
+    FixedJointBody bodies[MAX_BLOCKS];
+    FixedJointFrame frames[MAX_JOINTS];
+    for (int i = 0; i < world->blockCount; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        FixVec2 centre = { block->position.x + block->size.x / 2, block->position.y + block->size.y / 2 };
+        bodies[i] = MakeFixedJointBody(centre, block->size.x, block->size.y, fixedMaterialTable[block->material].mass);
+        bodies[i].velocity = block->velocity;
+        bodies[i].rotation = block->rotation;
+        bodies[i].angularVelocity = block->angularVelocity;
+    }
+
+    bool wasBroken[MAX_JOINTS];
+    for (int j = 0; j < world->jointCount; j++) {
+        FixedJoint* joint = &world->joints[j];
+        bool hasB = joint->bodyB != JOINT_WORLD;
+        wasBroken[j] = joint->broken;
+
+        // Destroyed blocks take their joints with them
+        if (!world->blocks[joint->bodyA].active || (hasB && !world->blocks[joint->bodyB].active)) joint->broken = true;
+        if (joint->broken || !hasB) continue;
+
+        // Woken blocks join in from the next step
+        FixedBlock* a = &world->blocks[joint->bodyA];
+        FixedBlock* b = &world->blocks[joint->bodyB];
+        if (FixedBlockAwake(world, joint->bodyA) && !b->falling) b->falling = true;
+        if (FixedBlockAwake(world, joint->bodyB) && !a->falling) a->falling = true;
+    }
+
+    bool awake[MAX_BLOCKS];
+    for (int i = 0; i < world->blockCount; i++) {
+        awake[i] = FixedBlockAwake(world, i);
+        if (!awake[i]) {
+            bodies[i].invMass = 0;
+            bodies[i].inertia = 0;
+        }
+    }
+
+    SolveFixedJoints(world->joints, world->jointCount, bodies, frames);
+
+    for (int i = 0; i < world->blockCount; i++) {
+        if (!awake[i]) continue;
+
+        FixedBlock* block = &world->blocks[i];
+        block->position = (FixVec2){ bodies[i].centre.x - block->size.x / 2, bodies[i].centre.y - block->size.y / 2 };
+        block->velocity = bodies[i].velocity;
+        block->rotation = bodies[i].rotation;
+        block->angularVelocity = bodies[i].angularVelocity;
+    }
+
+    for (int j = 0; j < world->jointCount; j++) {
+        const FixedJoint* joint = &world->joints[j];
+        if (joint->broken && !wasBroken[j] && events) {
+            FixVec2 at = FixedJointAnchorA(joint, bodies);
+            EmitEvent(events, EVENT_JOINT_BROKEN, BODY_BLOCK, joint->bodyA,
+                joint->bodyB == JOINT_WORLD ? BODY_NONE : BODY_BLOCK, joint->bodyB, 0, FixToFloat(at.x), FixToFloat(at.y), 0.0f);
+        }
+    }
+
+    // A block only sleeps once everything holding it has stopped too
+    for (int i = 0; i < world->blockCount; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        bool still = awake[i] && FixAbs(block->velocity.x) < FIX(JOINT_SLEEP_SPEED) &&
+            FixAbs(block->velocity.y) < FIX(JOINT_SLEEP_SPEED) && FixAbs(block->angularVelocity) < FIX(JOINT_SLEEP_SPEED / 100.0);
+        world->stillSteps[i] = still ? world->stillSteps[i] + 1 : 0;
+    }
+    for (int j = 0; j < world->jointCount; j++) {
+        const FixedJoint* joint = &world->joints[j];
+        if (joint->broken) continue;
+
+        int a = joint->bodyA;
+        int b = joint->bodyB;
+        if (world->stillSteps[a] >= JOINT_SLEEP_STEPS &&
+            (b == JOINT_WORLD || !awake[b] || world->stillSteps[b] >= JOINT_SLEEP_STEPS)) {
+            world->blocks[a].falling = false;
+            world->blocks[a].velocity = (FixVec2){ 0, 0 };
+            world->blocks[a].angularVelocity = 0;
+            world->stillSteps[a] = 0;
+        }
+    }
+}
+
+static void ResolveFixedDamage(FixedWorld* world, const PendingDamage* pending, int count, EventQueue* events) {
+    for (int n = 0; n < count; n++) {
+        FixedEnemy* enemy = &world->enemies[pending[n].enemy];
+        if (!enemy->active) continue;
+
+        enemy->health -= pending[n].amount;
+        if (enemy->health > 0) {
+            enemy->falling = true;
+            enemy->velocity = (FixVec2){ 0, FixFromInt(-4) };
+            continue;
+        }
+
+        enemy->active = false;
+        world->enemiesKilled++;
+        world->score += (pending[n].source == BODY_BIRD) ? 150 : 100;
+        if (events) {
+            EmitEvent(events, EVENT_KILL, pending[n].source, pending[n].sourceIndex, BODY_ENEMY, pending[n].enemy,
+                0, FixToFloat(enemy->position.x), FixToFloat(enemy->position.y), 0.0f);
+        }
+    }
+}
+
+static void QueueFixedBlast(const FixedWorld* world, BlastQueue* queue, int index) {
+    if (index < 0 || index >= world->blockCount || queue->queued[index]) return;
+    if (!world->blocks[index].active || world->blocks[index].material != MATERIAL_TNT) return;
+
+    queue->queued[index] = true;
+    queue->crates[queue->count++] = index;
+}
+
+// Function to push one block away from a blast, as explosion.c's PushBlock
+static void PushFixedBlock(FixedWorld* world, int index, FixVec2 centre, int source, EventQueue* events) {
+    FixedBlock* block = &world->blocks[index];
+    FixVec2 middle = { block->position.x + block->size.x / 2, block->position.y + block->size.y / 2 };
+    FixVec2 away = { middle.x - centre.x, middle.y - centre.y };
+    fixed distance = FixLength(away.x, away.y);
+    fixed falloff = FIX_ONE - FixDiv(distance, FIX_BLAST_RADIUS);
+    if (falloff < FIX(0.1)) falloff = FIX(0.1);
+    fixed speed = FixMul(FixMul(FIX_BLAST_IMPULSE, falloff), fixedMaterialTable[block->material].inverseMass);
+
+    if (distance > 0) {
+        away.x = FixDiv(away.x, distance);
+        away.y = FixDiv(away.y, distance);
+    }
+    else {
+        away = (FixVec2){ 0, -FIX_ONE };
+    }
+
+    bool wasResting = !block->falling;
+    block->velocity.x += FixMul(away.x, speed);
+    block->velocity.y += FixMul(away.y, speed);
+    block->angularVelocity += FixMul(FixFromInt(FixedRandomValue(world, -30, 30)) / 10, falloff);
+    block->falling = true;
+    block->onGround = false;
+
+    if (wasResting && events) {
+        EmitEvent(events, EVENT_BLOCK_BROKEN, BODY_BLOCK, source, BODY_BLOCK, index, 0,
+            FixToFloat(middle.x), FixToFloat(middle.y), FixToFloat(speed));
+    }
+}
+
+// Function to set off the queued crates as ResolveExplosions does: chained
+// crates go off in the same step, and the damage is resolved after the last
+static int ResolveFixedBlasts(FixedWorld* world, BlastQueue* queue, EventQueue* events) {
+    PendingDamage pending[MAX_BLOCKS * MAX_ENEMIES];
+    int pendingCount = 0;
+
+    for (int n = 0; n < queue->count; n++) {
+        int source = queue->crates[n];
+        FixedBlock* crate = &world->blocks[source];
+        FixVec2 centre = { crate->position.x + crate->size.x / 2, crate->position.y + crate->size.y / 2 };
+
+        crate->active = false;
+        world->blasts[world->blastCount++] = centre;
+
+        // Blocks, then enemies, each by index: the order SpatialQueryCircle() returns them in
+        for (int i = 0; i < world->blockCount; i++) {
+            FixedBlock* block = &world->blocks[i];
+            if (!block->active || !FixCircleRec(centre, FIX_BLAST_RADIUS, ShapeCorner(block), block->shapeSize)) continue;
+
+            if (block->material == MATERIAL_TNT) QueueFixedBlast(world, queue, i);
+            else PushFixedBlock(world, i, centre, source, events);
+        }
+
+        for (int i = 0; i < world->enemyCount; i++) {
+            const FixedEnemy* enemy = &world->enemies[i];
+            if (!enemy->active || !FixCircles(centre, FIX_BLAST_RADIUS, enemy->position, enemy->radius)) continue;
+
+            fixed falloff = FIX_ONE - FixDiv(FixLength(enemy->position.x - centre.x, enemy->position.y - centre.y), FIX_BLAST_RADIUS);
+            if (falloff < 0) falloff = 0;
+            int damage = (FixMul(FixFromInt(EXPLOSION_DAMAGE), falloff) + FIX_ONE - 1) >> FIX_SHIFT;
+            pending[pendingCount++] = (PendingDamage){ BODY_BLOCK, source, i, damage > 0 ? damage : 1 };
+        }
+    }
+
+    ResolveFixedDamage(world, pending, pendingCount, events);
+    return queue->count;
+}
+
+int FixedWorldDetonate(FixedWorld* world, int blockIndex, EventQueue* events) {
+    BlastQueue queue = { 0 };
+    world->blastCount = 0;
+
+    QueueFixedBlast(world, &queue, blockIndex);
+    return ResolveFixedBlasts(world, &queue, events);
+}
+
+bool AllFixedEnemiesDead(const FixedWorld* world) {
+    for (int i = 0; i < world->enemyCount; i++) {
+        if (world->enemies[i].active) return false;
+    }
+    return true;
+}
+
+// Function to end the hit cooldowns due this step
+static void AdvanceFixedTimers(FixedWorld* world) {
+    Timer due[MAX_TIMERS];
+    int count = TakeDueTimers(&world->timers, due);
+
+    for (int n = 0; n < count; n++) {
+        if (due[n].action == TIMER_ENEMY_RECOVER && due[n].target >= 0 && due[n].target < world->enemyCount) {
+            world->enemies[due[n].target].hitCooldown = TIMER_NONE;
+        }
+    }
+}
+
+// Function to move the bird and the falling enemies, round bodies first like StepBodies
+static void UpdateFixedRoundBodies(FixedWorld* world, EventQueue* events) {
+    FixedBird* bird = &world->bird;
+    if (bird->launched) {
+        bird->velocity.y += FIX_GRAVITY;
+        bird->position.x += bird->velocity.x;
+        bird->position.y += bird->velocity.y;
+
+        if (bird->position.y + bird->radius >= FIX_GROUND_Y) {
+            bird->position.y = FIX_GROUND_Y - bird->radius;
+            if (events) {
+                EmitEvent(events, EVENT_CONTACT, BODY_BIRD, 0, BODY_GROUND, -1, 0,
+                    FixToFloat(bird->position.x), FixToFloat(FIX_GROUND_Y), FixToFloat(FixAbs(bird->velocity.y)));
+            }
+
+            bird->velocity.y = -bird->velocity.y / 2;
+            if (FixAbs(bird->velocity.y) < FIX_ONE) {
+                bird->velocity.y = 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < world->enemyCount; i++) {
+        FixedEnemy* enemy = &world->enemies[i];
+        if (!enemy->active || !enemy->falling) continue;
+
+        enemy->velocity.y += FIX_GRAVITY;
+        enemy->position.y += enemy->velocity.y;
+
+        if (enemy->position.y + enemy->radius >= FIX_GROUND_Y) {
+            enemy->position.y = FIX_GROUND_Y - enemy->radius;
+            if (events) {
+                EmitEvent(events, EVENT_CONTACT, BODY_ENEMY, i, BODY_GROUND, -1, 0,
+                    FixToFloat(enemy->position.x), FixToFloat(FIX_GROUND_Y), FixToFloat(FixAbs(enemy->velocity.y)));
+            }
+
+            // Enemies land dead still
+            enemy->velocity.y = 0;
+            enemy->falling = false;
+            enemy->landed = true;
+        }
+    }
+}
+
+// Function to advance the fixed world by one step, in the same order as
+// UpdateWorld: cooldowns, then every body moves, then the collision passes
+// on the moved bodies, then the damage they caused, then the blasts
+void FixedWorldStep(FixedWorld* world, EventQueue* events) {
+    PendingDamage pending[MAX_BLOCKS * MAX_ENEMIES + MAX_ENEMIES];
+    int pendingCount = 0;
+    BlastQueue blasts = { 0 };
+    FixedBird* bird = &world->bird;
+
+    world->blastCount = 0;
+    AdvanceFixedTimers(world);
+
+    UpdateFixedRoundBodies(world, events);
+    UpdateFixedBlocks(world, events);
+    StepFixedJoints(world, events);
+
+    // Block-enemy collision; a hit starts the enemy's cooldown
+    for (int i = 0; i < world->blockCount; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        if (!block->active || !block->falling) continue;
+
+        for (int j = 0; j < world->enemyCount; j++) {
+            FixedEnemy* enemy = &world->enemies[j];
+            if (enemy->active && !enemy->falling && enemy->hitCooldown == TIMER_NONE &&
+                FixCircleRec(enemy->position, enemy->radius, ShapeCorner(block), block->shapeSize)) {
+
+                enemy->hitCooldown = ScheduleTimer(&world->timers, ENEMY_HIT_STEPS, TIMER_ENEMY_RECOVER, j);
+                pending[pendingCount++] = (PendingDamage){ BODY_BLOCK, i, j, 1 };
+            }
+        }
+    }
+
+    if (bird->launched) {
+        for (int i = 0; i < world->enemyCount; i++) {
+            const FixedEnemy* enemy = &world->enemies[i];
+            if (enemy->active && FixCircles(BirdCentre(world), world->birdShapeRadius, enemy->position, enemy->radius)) {
+                pending[pendingCount++] = (PendingDamage){ BODY_BIRD, 0, i, enemy->maxHealth };
+            }
+        }
+
+        if ((FixAbs(bird->velocity.x) < FIX(0.5) && FixAbs(bird->velocity.y) < FIX(0.5)) ||
+            bird->position.x > FIX_SCREEN_WIDTH || bird->position.x < 0 || bird->position.y < 0) {
+
+            if (world->lives > 1) {
+                *bird = RestingBird();
+                world->lives--;
+            }
+            else {
+                world->gameOver = true;
+            }
+        }
+
+        for (int i = 0; i < world->blockCount; i++) {
+            FixedBlock* block = &world->blocks[i];
+            if (!block->active || block->falling ||
+                !FixCircleRec(BirdCentre(world), world->birdShapeRadius, ShapeCorner(block), block->shapeSize)) continue;
+
+            block->falling = true;
+
+            fixed impactForce = FixLength(bird->velocity.x, bird->velocity.y);
+
+            block->velocity = (FixVec2){
+                FixMul(bird->velocity.x, FIX(0.3)) + FixFromInt(FixedRandomValue(world, -2, 2)),
+                -FixMul(impactForce, FIX(0.2))
+            };
+            block->angularVelocity = FixFromInt(FixedRandomValue(world, -30, 30)) / 10;
+
+            world->score += 10;
+            QueueFixedBlast(world, &blasts, i);
+            if (events) {
+                EmitEvent(events, EVENT_BLOCK_BROKEN, BODY_BIRD, 0, BODY_BLOCK, i, 0,
+                    FixToFloat(bird->position.x), FixToFloat(bird->position.y), FixToFloat(impactForce));
+            }
+
+            bird->velocity.x = FixMul(bird->velocity.x, FIX(0.7));
+            bird->velocity.y = FixMul(bird->velocity.y, FIX(0.7));
+        }
+    }
+
+    // Block-block collision
+    for (int i = 0; i < world->blockCount; i++) {
+        FixedBlock* block = &world->blocks[i];
+        if (!block->active || !block->falling || block->onGround) continue;
+
+        for (int j = 0; j < world->blockCount; j++) {
+            FixedBlock* other = &world->blocks[j];
+            if (i == j || !other->active || other->falling || other->onGround) continue;
+            if (!FixRecs(block, other)) continue;
+
+            other->falling = true;
+            other->velocity = (FixVec2){
+                block->velocity.x / 2 + FixFromInt(FixedRandomValue(world, -1, 1)),
+                FixFromInt(-3 + FixedRandomValue(world, -1, 1))
+            };
+            other->angularVelocity = FixFromInt(FixedRandomValue(world, -15, 15)) / 10;
+            QueueFixedBlast(world, &blasts, j);
+
+            if (events) {
+                EmitEvent(events, EVENT_BLOCK_BROKEN, BODY_BLOCK, i, BODY_BLOCK, j, 0,
+                    FixToFloat(other->position.x), FixToFloat(other->position.y), FixToFloat(FixAbs(block->velocity.y)));
+            }
+
+            block->velocity.x = FixMul(block->velocity.x, FIX(0.8));
+            block->velocity.y = FixMul(block->velocity.y, FIX(0.8));
+        }
+    }
+
+    ResolveFixedDamage(world, pending, pendingCount, events);
+
+    // Crates knocked loose above go off now, and their damage is scored in the same step
+    ResolveFixedBlasts(world, &blasts, events);
+    world->step++;
+}
+
+// FNV-1a over the fields one by one, so struct padding never gets hashed
+static unsigned long long HashValue(unsigned long long hash, int64_t value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (unsigned long long)((value >> (i * 8)) & 0xFF);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+unsigned long long FixedWorldHash(const FixedWorld* world) {
+    unsigned long long hash = 14695981039346656037ull;
+
+    hash = HashValue(hash, world->step);
+    hash = HashValue(hash, world->rngState);
+    hash = HashValue(hash, world->score);
+    hash = HashValue(hash, world->lives);
+    hash = HashValue(hash, world->gameOver);
+
+    hash = HashValue(hash, world->bird.position.x);
+    hash = HashValue(hash, world->bird.position.y);
+    hash = HashValue(hash, world->bird.velocity.x);
+    hash = HashValue(hash, world->bird.velocity.y);
+    hash = HashValue(hash, world->bird.launched);
+
+    for (int i = 0; i < world->blockCount; i++) {
+        const FixedBlock* block = &world->blocks[i];
+        hash = HashValue(hash, block->position.x);
+        hash = HashValue(hash, block->position.y);
+        hash = HashValue(hash, block->velocity.x);
+        hash = HashValue(hash, block->velocity.y);
+        hash = HashValue(hash, block->rotation);
+        hash = HashValue(hash, block->active | (block->falling << 1) | (block->onGround << 2));
+    }
+
+    for (int i = 0; i < world->enemyCount; i++) {
+        const FixedEnemy* enemy = &world->enemies[i];
+        hash = HashValue(hash, enemy->position.x);
+        hash = HashValue(hash, enemy->position.y);
+        hash = HashValue(hash, enemy->velocity.y);
+        hash = HashValue(hash, enemy->health);
+        hash = HashValue(hash, TimerRemaining(&world->timers, enemy->hitCooldown));
+        hash = HashValue(hash, enemy->active | (enemy->falling << 1) | (enemy->landed << 2));
+    }
+
+    for (int i = 0; i < world->jointCount; i++) {
+        hash = HashValue(hash, world->joints[i].broken);
+    }
+    return hash;
+}
+
+void BeginReplay(Replay* replay, int level, unsigned int seed) {
+    memset(replay, 0, sizeof(*replay));
+    replay->level = level;
+    replay->seed = seed;
+}
+
+void RecordReplayShot(Replay* replay, unsigned int step, int pullX, int pullY) {
+    if (replay->shotCount >= MAX_REPLAY_SHOTS) {
+        replay->tainted = true;
+        return;
+    }
+    replay->shots[replay->shotCount++] = (ReplayShot){ step, pullX, pullY };
+}
+
+// Replay files are plain text:
+//   replay 1 / level N / seed S / steps N / shot STEP X Y ... / score N / hash HEX
+bool SaveReplay(const char* fileName, const Replay* replay) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to write %s", fileName);
+        return false;
+    }
+
+    fprintf(file, "replay 1\nlevel %d\nseed %u\nsteps %u\n", replay->level, replay->seed, replay->steps);
+    for (int i = 0; i < replay->shotCount; i++) {
+        fprintf(file, "shot %u %d %d\n", replay->shots[i].step, replay->shots[i].pullX, replay->shots[i].pullY);
+    }
+    fprintf(file, "score %d\nhash %016llx\n", replay->claimedScore, replay->claimedHash);
+
+    fclose(file);
+    return true;
+}
+
+bool LoadReplay(const char* fileName, Replay* replay) {
+    FILE* file = fopen(fileName, "r");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to open %s", fileName);
+        return false;
+    }
+
+    memset(replay, 0, sizeof(*replay));
+
+    char line[128];
+    int version = 0;
+    bool valid = true;
+
+    while (valid && fgets(line, sizeof(line), file)) {
+        ReplayShot shot;
+
+        if (sscanf(line, "replay %d", &version) == 1) continue;
+        if (sscanf(line, "level %d", &replay->level) == 1) continue;
+        if (sscanf(line, "seed %u", &replay->seed) == 1) continue;
+        if (sscanf(line, "steps %u", &replay->steps) == 1) continue;
+        if (sscanf(line, "score %d", &replay->claimedScore) == 1) continue;
+        if (sscanf(line, "hash %llx", &replay->claimedHash) == 1) continue;
+
+        if (sscanf(line, "shot %u %d %d", &shot.step, &shot.pullX, &shot.pullY) == 3) {
+            // Shots must be in order, one per step at most
+            if (replay->shotCount >= MAX_REPLAY_SHOTS ||
+                (replay->shotCount > 0 && shot.step <= replay->shots[replay->shotCount - 1].step)) {
+                valid = false;
+            }
+            else {
+                replay->shots[replay->shotCount++] = shot;
+            }
+            continue;
+        }
+
+        if (line[0] != '\n' && line[0] != '\r' && line[0] != '#') valid = false;
+    }
+    fclose(file);
+
+    if (!valid || version != 1 || replay->level < 1 || replay->level > totalLevels) {
+        TraceLog(LOG_WARNING, "REPLAY: %s is not a valid replay", fileName);
+        return false;
+    }
+    return true;
+}
+
+void StepReplay(const Replay* replay, FixedWorld* world, int* nextShot) {
+    if (*nextShot < replay->shotCount && replay->shots[*nextShot].step == world->step) {
+        if (!world->bird.launched) {
+            FixedWorldLaunch(world, replay->shots[*nextShot].pullX, replay->shots[*nextShot].pullY);
+        }
+        (*nextShot)++;
+    }
+    FixedWorldStep(world, NULL);
+}
+
+void RunReplay(const Replay* replay, FixedWorld* world) {
+    FixedWorldLoadLevel(world, GetLevelData(replay->level), replay->seed);
+
+    int nextShot = 0;
+    while (world->step < replay->steps) {
+        StepReplay(replay, world, &nextShot);
+    }
+}
+
+int VerifyReplayFile(const char* fileName) {
+    Replay replay;
+    if (!LoadReplay(fileName, &replay)) return 2;
+
+    FixedWorld world;
+    RunReplay(&replay, &world);
+
+    // Replays are only saved on victory, so the replayed level must be won too
+    unsigned long long hash = FixedWorldHash(&world);
+    bool matches = AllFixedEnemiesDead(&world) && world.score == replay.claimedScore && hash == replay.claimedHash;
+
+    printf("%s: level %d, %d shots, %u steps, score %d (claimed %d), hash %016llx (claimed %016llx): %s\n",
+        fileName, replay.level, replay.shotCount, replay.steps, world.score, replay.claimedScore,
+        hash, replay.claimedHash, matches ? "OK" : "MISMATCH");
+
+    return matches ? 0 : 1;
+}
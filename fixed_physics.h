@@ -0,0 +1,125 @@
+#ifndef FIXED_PHYSICS_H
+#define FIXED_PHYSICS_H
+
+#include "fixed.h"
+#include "fixed_joints.h"
+#include "game.h"
+#include "level.h"
+#include "events.h"
+
+#define MAX_REPLAY_SHOTS 32
+
+typedef struct {
+    FixVec2 position;
+    FixVec2 velocity;
+    fixed radius;
+    bool launched;
+} FixedBird;
+
+typedef struct {
+    FixVec2 position; // top-left corner, like Block::rect
+    FixVec2 size;
+    FixVec2 shapeOffset; // the rect it collides with, within the block: see BlockCollisionRect()
+    FixVec2 shapeSize;
+    FixVec2 velocity;
+    fixed rotation;
+    fixed angularVelocity;
+    unsigned char material;
+    bool active;
+    bool falling;
+    bool onGround;
+} FixedBlock;
+
+typedef struct {
+    FixVec2 position;    // centre of the collision circle, see EnemyCollisionCircle()
+    FixVec2 shapeOffset; // from the game's enemy position to that centre
+    FixVec2 velocity;
+    fixed radius;
+    int health;
+    int maxHealth;
+    int hitCooldown; // timer in FixedWorld::timers, TIMER_NONE when blocks can hurt it
+    bool active;
+    bool falling;
+    bool landed;
+} FixedEnemy;
+
+// Deterministic mirror of the game world, stepped at a fixed 60 Hz
+typedef struct {
+    FixedBird bird;
+    FixVec2 birdShapeOffset; // from the bird's position to its collision circle, see BirdCollisionCircle()
+    fixed birdShapeRadius;
+    FixedBlock blocks[MAX_BLOCKS];
+    FixedEnemy enemies[MAX_ENEMIES];
+    FixedJoint joints[MAX_JOINTS];
+    int blockCount;
+    int enemyCount;
+    int jointCount;
+    int stillSteps[MAX_BLOCKS]; // how long each jointed block has hung still
+    int score;
+    int lives;
+    int enemiesKilled;
+    bool gameOver;
+    unsigned int rngState;
+    unsigned int step;
+    TimerWheel timers; // its own, so worlds on other threads never share one
+    FixVec2 blasts[MAX_BLOCKS]; // centres of the crates that went off in the last step, for drawing
+    int blastCount;
+} FixedWorld;
+
+// A launch: the pull point at release, in whole pixels
+typedef struct {
+    unsigned int step;
+    int pullX;
+    int pullY;
+} ReplayShot;
+
+typedef struct {
+    int level;
+    unsigned int seed;
+    unsigned int steps;      // total steps simulated
+    int shotCount;
+    ReplayShot shots[MAX_REPLAY_SHOTS];
+    bool tainted;            // rewound during play, can't be verified
+    int claimedScore;
+    unsigned long long claimedHash;
+} Replay;
+
+// Builds the fixed world from the current float world (blocks[], enemies[], joints[])
+void FixedWorldReset(FixedWorld* world, unsigned int seed);
+void FixedWorldImport(FixedWorld* world, const Bird* bird, int score, int lives, bool gameOver, unsigned int step);
+void FixedWorldExport(const FixedWorld* world, Bird* bird, int* lives, bool* gameOver);
+
+// Builds a fresh world straight from level data, without touching the
+// float globals, so several worlds can be simulated on different threads
+void FixedWorldLoadLevel(FixedWorld* world, const LevelData* level, unsigned int seed);
+
+void FixedWorldLaunch(FixedWorld* world, int pullX, int pullY);
+
+// Advances one step; kills and broken blocks are also pushed to events (may be NULL).
+// TNT knocked loose goes off at the end of the step, like ResolveExplosions().
+void FixedWorldStep(FixedWorld* world, EventQueue* events);
+
+// Sets off TNT block blockIndex and everything it chains into, then applies
+// the damage. Returns the number of crates that went off.
+int FixedWorldDetonate(FixedWorld* world, int blockIndex, EventQueue* events);
+unsigned long long FixedWorldHash(const FixedWorld* world);
+
+// True once every enemy is dead, which wins the level
+bool AllFixedEnemiesDead(const FixedWorld* world);
+
+void BeginReplay(Replay* replay, int level, unsigned int seed);
+void RecordReplayShot(Replay* replay, unsigned int step, int pullX, int pullY);
+bool SaveReplay(const char* fileName, const Replay* replay);
+bool LoadReplay(const char* fileName, Replay* replay);
+
+// Re-simulates a replay from scratch on the fixed-point path
+void RunReplay(const Replay* replay, FixedWorld* world);
+
+// One step of a replay: launches the shot due at this step, then steps
+void StepReplay(const Replay* replay, FixedWorld* world, int* nextShot);
+
+// Checks a submitted replay file: 0 if the score and hash reproduce,
+// 1 if they don't, 2 if the file can't be used
+int VerifyReplayFile(const char* fileName);
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "raylib.h"
+#include "joints.h"
+#include "timers.h"
+
+#define MAX_BLOCKS 10
+#define MAX_ENEMIES 5
+#define MAX_JOINTS 16
+#define MAX_TRAJECTORY_POINTS 100
+#define TRAJECTORY_DURATION 45.0f  // simulated frames covered by the aim preview
+#define ENEMY_MAX_HEALTH 3
+#define ENEMY_HIT_STEPS 30 // 0.5 s before blocks can hurt an enemy again
+#define LEVEL_COMPLETE_DELAY_STEPS 45 // the last kill plays out before the level complete screen
+
+// The simulation works in these fixed units even without a window
+#define SCREEN_WIDTH 1536
+#define SCREEN_HEIGHT 800
+#define GROUND_HEIGHT 250.0f
+
+typedef struct {
+    Vector2 position;
+    Vector2 velocity;
+    bool launched;
+    float radius;
+} Bird;
+
+typedef struct {
+    Rectangle rect;
+    bool active;
+    Vector2 velocity;
+    bool falling;
+    Rectangle startRect;
+    float rotation;
+    float angularVelocity;
+    bool onGround;
+    unsigned char material; // MaterialId, see materials.h
+} Block;
+
+typedef struct {
+    Vector2 position;
+    float radius;
+    bool active;
+    Vector2 velocity;
+    bool falling;
+    bool landed;
+    int health;
+    int maxHealth;
+    int hitCooldown; // TIMER_ENEMY_RECOVER handle while blocks can't hurt it, TIMER_NONE otherwise
+} Enemy;
+
+typedef struct {
+    Vector2 points[MAX_TRAJECTORY_POINTS];
+    int count;
+} TrajectoryPoints;
+
+typedef enum {
+    MENU,
+    GAME,
+    SETTINGS,
+    LEVEL_COMPLETE
+} GameState;
+
+// World state, defined in FileName.c
+extern Enemy enemies[MAX_ENEMIES];
+extern Block blocks[MAX_BLOCKS];
+extern Joint joints[MAX_JOINTS];  // between blocks[] entries, or to the world
+extern TimerWheel gameTimers;     // cooldowns and delayed actions, by simulation step
+extern int enemyCount;
+extern int blockCount;
+extern int jointCount;
+extern int currentLevel;
+extern int totalLevels;
+extern unsigned int gameRngState;
+
+void InitializeEnemies(int level);
+void InitializeBlocks(int level);
+void DamageEnemy(int enemyIndex, int damage);
+bool AllEnemiesDead(void);
+void UpdateWorld(Bird* bird, int* lives, bool* gameOver, bool* victory, float deltaTime);
+
+// Simulation RNG; its state is part of the world so snapshots and replays are exact
+void SeedGameRandom(unsigned int seed);
+int GameRandomValue(int min, int max);
+
+#endif
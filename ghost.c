@@ -0,0 +1,396 @@
+#include "ghost.h"
+#include <math.h>
+#include <string.h>
+
+#define GHOST_MAGIC 0x47
+#define GHOST_HEADER_SIZE 8
+#define GHOST_HAS_BASE 1
+#define GHOST_HAS_ACK 2
+
+#define FIELD_COUNT 7  // x, y, width, height, rotation, flags, extra
+
+typedef struct {
+    unsigned char* data;
+    int capacity;
+    int size;
+    bool overflow;
+} Writer;
+
+typedef struct {
+    const unsigned char* data;
+    int size;
+    int position;
+    bool bad;
+} Reader;
+
+static void PutByte(Writer* writer, unsigned char value) {
+    if (writer->size >= writer->capacity) {
+        writer->overflow = true;
+        return;
+    }
+    writer->data[writer->size++] = value;
+}
+
+static void PutVarint(Writer* writer, unsigned int value) {
+    while (value >= 0x80) {
+        PutByte(writer, (unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    PutByte(writer, (unsigned char)value);
+}
+
+// Small magnitudes of either sign stay short: 0, -1, 1, -2 ... become 0, 1, 2, 3 ...
+static void PutSigned(Writer* writer, int value) {
+    PutVarint(writer, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+static unsigned char GetByte(Reader* reader) {
+    if (reader->position >= reader->size) {
+        reader->bad = true;
+        return 0;
+    }
+    return reader->data[reader->position++];
+}
+
+static unsigned int GetVarint(Reader* reader) {
+    unsigned int value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        unsigned char byte = GetByte(reader);
+        value |= (unsigned int)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    reader->bad = true;
+    return 0;
+}
+
+static int GetSigned(Reader* reader) {
+    unsigned int value = GetVarint(reader);
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+static unsigned short ToEighths(float value) {
+    float scaled = fminf(fmaxf(value * 8.0f, -32768.0f), 32767.0f);
+    return (unsigned short)(short)lrintf(scaled);
+}
+
+static float FromEighths(unsigned short value) {
+    return (float)(short)value / 8.0f;
+}
+
+GhostBody QuantizeRect(Rectangle rect, float rotation, unsigned char flags, unsigned char extra) {
+    // Whole turns drop out when the long is cut down to 16 bits
+    long turn = lrintf(rotation * (65536.0f / (2.0f * PI)));
+    return (GhostBody){ ToEighths(rect.x), ToEighths(rect.y), ToEighths(rect.width), ToEighths(rect.height),
+        (unsigned short)turn, flags, extra };
+}
+
+GhostBody QuantizeCircle(Vector2 centre, float radius, unsigned char flags, unsigned char extra) {
+    unsigned short diameter = ToEighths(radius * 2.0f);
+    return (GhostBody){ ToEighths(centre.x), ToEighths(centre.y), diameter, diameter, 0, flags, extra };
+}
+
+Rectangle GhostRect(const GhostBody* body) {
+    return (Rectangle){ FromEighths(body->x), FromEighths(body->y), FromEighths(body->width), FromEighths(body->height) };
+}
+
+Vector2 GhostCentre(const GhostBody* body) {
+    return (Vector2){ FromEighths(body->x), FromEighths(body->y) };
+}
+
+float GhostRotation(const GhostBody* body) {
+    return (float)body->rotation * (2.0f * PI / 65536.0f);
+}
+
+static void BodyFields(const GhostBody* body, unsigned short* fields) {
+    fields[0] = body->x;
+    fields[1] = body->y;
+    fields[2] = body->width;
+    fields[3] = body->height;
+    fields[4] = body->rotation;
+    fields[5] = body->flags;
+    fields[6] = body->extra;
+}
+
+// Bodies in wire order: the bird, then blocks, then enemies
+static const GhostBody* FrameBody(const GhostFrame* frame, int index) {
+    static const GhostBody none = { 0 };
+    if (frame == NULL) return &none;
+    if (index == 0) return &frame->bird;
+    index--;
+    if (index < frame->blockCount) return &frame->blocks[index];
+    index -= frame->blockCount;
+    if (index < frame->enemyCount) return &frame->enemies[index];
+    return &none;
+}
+
+static GhostBody* FrameBodyOut(GhostFrame* frame, int index) {
+    if (index == 0) return &frame->bird;
+    index--;
+    if (index < frame->blockCount) return &frame->blocks[index];
+    return &frame->enemies[index - frame->blockCount];
+}
+
+int EncodeGhostFrame(const GhostFrame* frame, const GhostFrame* base, unsigned char* out, int capacity) {
+    if (frame->blockCount > GHOST_MAX_BODIES || frame->enemyCount > GHOST_MAX_BODIES) return 0;
+
+    Writer writer = { out, capacity, 0, false };
+    PutVarint(&writer, frame->step);
+    PutSigned(&writer, frame->score);
+    PutByte(&writer, frame->level);
+    PutByte(&writer, frame->lives);
+    PutByte(&writer, frame->shots);
+    PutSigned(&writer, frame->pullX);
+    PutSigned(&writer, frame->pullY);
+    PutByte(&writer, (unsigned char)frame->blockCount);
+    PutByte(&writer, (unsigned char)frame->enemyCount);
+
+    // Bitmap of changed bodies, filled in as they are written
+    const int bodyCount = 1 + frame->blockCount + frame->enemyCount;
+    const int bitmapStart = writer.size;
+    for (int i = 0; i < (bodyCount + 7) / 8; i++) PutByte(&writer, 0);
+    if (writer.overflow) return 0;
+
+    for (int i = 0; i < bodyCount; i++) {
+        const GhostBody* body = FrameBody(frame, i);
+        const GhostBody* previous = FrameBody(base, i);
+        unsigned short now[FIELD_COUNT];
+        unsigned short was[FIELD_COUNT];
+        BodyFields(body, now);
+        BodyFields(previous, was);
+
+        unsigned char mask = 0;
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (now[f] != was[f]) mask |= (unsigned char)(1 << f);
+        }
+        if (mask == 0) continue;
+
+        out[bitmapStart + i / 8] |= (unsigned char)(1 << (i % 8));
+        PutByte(&writer, mask);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (!(mask & (1 << f))) continue;
+            if (f < 5) PutSigned(&writer, (short)(unsigned short)(now[f] - was[f]));
+            else PutByte(&writer, (unsigned char)now[f]);
+        }
+    }
+
+    return writer.overflow ? 0 : writer.size;
+}
+
+bool DecodeGhostFrame(const unsigned char* data, int size, const GhostFrame* base, GhostFrame* out) {
+    Reader reader = { data, size, 0, false };
+    GhostFrame frame;
+
+    frame.step = GetVarint(&reader);
+    frame.score = GetSigned(&reader);
+    frame.level = GetByte(&reader);
+    frame.lives = GetByte(&reader);
+    frame.shots = GetByte(&reader);
+    frame.pullX = (short)GetSigned(&reader);
+    frame.pullY = (short)GetSigned(&reader);
+    frame.blockCount = GetByte(&reader);
+    frame.enemyCount = GetByte(&reader);
+    if (reader.bad || frame.blockCount > GHOST_MAX_BODIES || frame.enemyCount > GHOST_MAX_BODIES) return false;
+
+    const int bodyCount = 1 + frame.blockCount + frame.enemyCount;
+    const int bitmapStart = reader.position;
+    reader.position += (bodyCount + 7) / 8;
+    if (reader.position > size) return false;
+
+    for (int i = 0; i < bodyCount; i++) {
+        GhostBody* body = FrameBodyOut(&frame, i);
+        *body = *FrameBody(base, i);
+        if (!(data[bitmapStart + i / 8] & (1 << (i % 8)))) continue;
+
+        unsigned short fields[FIELD_COUNT];
+        BodyFields(body, fields);
+
+        unsigned char mask = GetByte(&reader);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (!(mask & (1 << f))) continue;
+            if (f < 5) fields[f] = (unsigned short)(fields[f] + (unsigned short)GetSigned(&reader));
+            else fields[f] = GetByte(&reader);
+        }
+        if (reader.bad) return false;
+
+        *body = (GhostBody){ fields[0], fields[1], fields[2], fields[3], fields[4],
+            (unsigned char)fields[5], (unsigned char)fields[6] };
+    }
+
+    *out = frame;
+    return true;
+}
+
+static void PutShort(unsigned char* out, unsigned short value) {
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+}
+
+static unsigned short GetShort(const unsigned char* in) {
+    return (unsigned short)(in[0] | (in[1] << 8));
+}
+
+// Function to frame and encode one snapshot; returns the packet size
+static int BuildPacket(GhostLink* link, const GhostFrame* frame, unsigned char* packet) {
+    const GhostFrame* base = NULL;
+    unsigned char flags = 0;
+
+    // Only a frame the peer has decoded, and both sides still keep, can be the baseline
+    if (link->peerAcked && (unsigned short)(link->sequence - link->peerAck) < GHOST_HISTORY) {
+        base = &link->sent[link->peerAck % GHOST_HISTORY];
+        flags |= GHOST_HAS_BASE;
+    }
+    if (link->received) flags |= GHOST_HAS_ACK;
+
+    packet[0] = GHOST_MAGIC;
+    packet[1] = flags;
+    PutShort(packet + 2, link->sequence);
+    PutShort(packet + 4, link->peerAck);
+    PutShort(packet + 6, link->newest);
+
+    int payload = EncodeGhostFrame(frame, base, packet + GHOST_HEADER_SIZE, GHOST_MAX_PACKET - GHOST_HEADER_SIZE);
+    return (payload > 0) ? GHOST_HEADER_SIZE + payload : 0;
+}
+
+// Function to take in one packet from the peer; false if it can't be used
+static bool AcceptPacket(GhostLink* link, const unsigned char* packet, int size) {
+    static GhostFrame decoded;
+
+    if (size < GHOST_HEADER_SIZE || packet[0] != GHOST_MAGIC) return false;
+
+    unsigned char flags = packet[1];
+    unsigned short sequence = GetShort(packet + 2);
+    unsigned short baseSequence = GetShort(packet + 4);
+    unsigned short ack = GetShort(packet + 6);
+
+    if ((flags & GHOST_HAS_ACK) && (!link->peerAcked || (short)(ack - link->peerAck) > 0)) {
+        link->peerAck = ack;
+        link->peerAcked = true;
+    }
+
+    // Stale or repeated
+    if (link->received && (short)(sequence - link->newest) <= 0) return false;
+
+    const GhostFrame* base = NULL;
+    if (flags & GHOST_HAS_BASE) {
+        int slot = baseSequence % GHOST_HISTORY;
+        if (!link->received || link->frameSequences[slot] != baseSequence) return false;
+        base = &link->frames[slot];
+    }
+
+    if (!DecodeGhostFrame(packet + GHOST_HEADER_SIZE, size - GHOST_HEADER_SIZE, base, &decoded)) return false;
+
+    link->frames[sequence % GHOST_HISTORY] = decoded;
+    link->frameSequences[sequence % GHOST_HISTORY] = sequence;
+    link->newest = sequence;
+    link->received = true;
+    return true;
+}
+
+const GhostFrame* GhostLinkLatest(const GhostLink* link) {
+    return link->received ? &link->frames[link->newest % GHOST_HISTORY] : NULL;
+}
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static struct sockaddr_in LoopbackAddress(int port) {
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+bool GhostLinkOpen(GhostLink* link, int localPort, int peerPort) {
+    memset(link, 0, sizeof(*link));
+    link->socket = -1;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        TraceLog(LOG_WARNING, "GHOST: can't create socket");
+        return false;
+    }
+
+    struct sockaddr_in local = LoopbackAddress(localPort);
+    if (bind(fd, (struct sockaddr*)&local, sizeof(local)) != 0 || fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+        TraceLog(LOG_WARNING, "GHOST: can't listen on port %d", localPort);
+        close(fd);
+        return false;
+    }
+
+    link->socket = fd;
+    link->peerPort = (unsigned short)peerPort;
+    link->open = true;
+    TraceLog(LOG_INFO, "GHOST: port %d, peer on %d", localPort, peerPort);
+    return true;
+}
+
+void GhostLinkClose(GhostLink* link) {
+    if (!link->open) return;
+
+    close(link->socket);
+    link->socket = -1;
+    link->open = false;
+}
+
+int GhostLinkSend(GhostLink* link, const GhostFrame* frame) {
+    unsigned char packet[GHOST_MAX_PACKET];
+    if (!link->open) return 0;
+
+    int size = BuildPacket(link, frame, packet);
+    if (size == 0) return 0;
+
+    // Nobody listening yet is fine; the frame is kept as a baseline either way
+    struct sockaddr_in peer = LoopbackAddress(link->peerPort);
+    sendto(link->socket, packet, (size_t)size, 0, (struct sockaddr*)&peer, sizeof(peer));
+
+    link->sent[link->sequence % GHOST_HISTORY] = *frame;
+    link->sequence++;
+    link->bytesSent += (unsigned long long)size;
+    link->packetsSent++;
+    return size;
+}
+
+int GhostLinkReceive(GhostLink* link) {
+    unsigned char packet[GHOST_MAX_PACKET];
+    int accepted = 0;
+    if (!link->open) return 0;
+
+    for (;;) {
+        ssize_t size = recv(link->socket, packet, sizeof(packet), 0);
+        if (size <= 0) break;
+
+        if (AcceptPacket(link, packet, (int)size)) accepted++;
+        else link->packetsDropped++;
+    }
+    return accepted;
+}
+
+#else
+
+// No sockets on Windows builds yet; the codec still works
+
+bool GhostLinkOpen(GhostLink* link, int localPort, int peerPort) {
+    memset(link, 0, sizeof(*link));
+    TraceLog(LOG_INFO, "GHOST: not supported on this platform");
+    return false;
+}
+
+void GhostLinkClose(GhostLink* link) {
+}
+
+int GhostLinkSend(GhostLink* link, const GhostFrame* frame) {
+    return 0;
+}
+
+int GhostLinkReceive(GhostLink* link) {
+    return 0;
+}
+
+#endif
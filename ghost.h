@@ -0,0 +1,97 @@
+#ifndef GHOST_H
+#define GHOST_H
+
+#include "raylib.h"
+
+#define GHOST_MAX_BODIES 128     // blocks, and enemies, per frame
+#define GHOST_HISTORY 16         // frames kept on each side as delta baselines
+#define GHOST_SEND_INTERVAL 2    // simulation steps between snapshots
+#define GHOST_MAX_PACKET 1400    // fits a full 100-body frame
+
+#define GHOST_ACTIVE 1
+#define GHOST_FALLING 2
+#define GHOST_LAUNCHED 4         // bird only
+
+// A body quantized for the wire: positions and sizes in 1/8 px, rotation
+// in 1/65536 turn. Fields are compared and sent as 16-bit deltas that
+// wrap, so a spinning block never overflows.
+typedef struct {
+    unsigned short x;       // top-left for blocks, centre for the bird and enemies
+    unsigned short y;
+    unsigned short width;   // diameter for circles
+    unsigned short height;
+    unsigned short rotation;
+    unsigned char flags;    // GHOST_ACTIVE, ...
+    unsigned char extra;    // block material, enemy health
+} GhostBody;
+
+// One player's world as the other one sees it
+typedef struct {
+    unsigned int step;
+    int score;
+    unsigned char level;
+    unsigned char lives;
+    unsigned char shots;    // launches so far; pullX/pullY is the newest
+    short pullX;
+    short pullY;
+    GhostBody bird;
+    int blockCount;
+    int enemyCount;
+    GhostBody blocks[GHOST_MAX_BODIES];
+    GhostBody enemies[GHOST_MAX_BODIES];
+} GhostFrame;
+
+GhostBody QuantizeRect(Rectangle rect, float rotation, unsigned char flags, unsigned char extra);
+GhostBody QuantizeCircle(Vector2 centre, float radius, unsigned char flags, unsigned char extra);
+Rectangle GhostRect(const GhostBody* body);
+Vector2 GhostCentre(const GhostBody* body);
+float GhostRotation(const GhostBody* body);
+
+// Writes frame as changes from base (NULL for a full frame): a bitmap of
+// the bodies that changed, then for each a mask of its changed fields and
+// their zigzag varint deltas. Returns the bytes written, 0 if capacity is
+// too small.
+int EncodeGhostFrame(const GhostFrame* frame, const GhostFrame* base, unsigned char* out, int capacity);
+
+// Rebuilds a frame from EncodeGhostFrame() output and the same base.
+// Returns false on truncated or malformed data.
+bool DecodeGhostFrame(const unsigned char* data, int size, const GhostFrame* base, GhostFrame* out);
+
+// One peer of a two-player session over UDP on this machine. Every packet
+// carries the newest sequence received from the peer; frames are encoded
+// against the newest sent frame the peer has acknowledged, or in full.
+// Lost packets only cost a larger delta later.
+typedef struct {
+    int socket;
+    bool open;
+    unsigned short peerPort;
+
+    unsigned short sequence;          // next frame to send
+    bool peerAcked;                   // the peer has decoded something of ours
+    unsigned short peerAck;           // ...and this is the newest
+    GhostFrame sent[GHOST_HISTORY];   // by sequence % GHOST_HISTORY
+
+    bool received;                    // we have decoded something of the peer's
+    unsigned short newest;            // ...and this is the newest sequence
+    GhostFrame frames[GHOST_HISTORY];
+    unsigned short frameSequences[GHOST_HISTORY];
+
+    unsigned long long bytesSent;
+    unsigned int packetsSent;
+    unsigned int packetsDropped;      // undecodable: stale, or baseline no longer kept
+} GhostLink;
+
+// Binds 127.0.0.1:localPort and sends to 127.0.0.1:peerPort
+bool GhostLinkOpen(GhostLink* link, int localPort, int peerPort);
+void GhostLinkClose(GhostLink* link);
+
+// Returns the packet size, 0 if nothing was sent
+int GhostLinkSend(GhostLink* link, const GhostFrame* frame);
+
+// Decodes every packet waiting on the socket; never blocks. Returns how many were new.
+int GhostLinkReceive(GhostLink* link);
+
+// The peer's newest frame, NULL before the first one arrives
+const GhostFrame* GhostLinkLatest(const GhostLink* link);
+
+#endif
@@ -0,0 +1,324 @@
+#include "hot_reload.h"
+#include "level.h"
+#include "idle.h"
+#include "alloc_tracker.h"
+#include <string.h>
+
+#ifdef __linux__
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <stdio.h>
+
+#define MAX_PENDING_RELOADS 16
+
+typedef enum {
+    HOT_TEXTURE,
+    HOT_LEVEL
+} HotAssetKind;
+
+typedef struct {
+    char fileName[64];
+    HotAssetKind kind;
+    Texture2D* texture; // HOT_TEXTURE: slot swapped on reload
+    int width;
+    int height;
+    int level;          // HOT_LEVEL: level number
+} HotAsset;
+
+// A decoded asset waiting for the main thread
+typedef struct {
+    int asset;
+    Image image;
+    LevelData level;
+    double detectedAt;
+} PendingReload;
+
+static HotAsset assets[MAX_HOT_ASSETS];
+static int assetCount = 0;
+static char watchDirectory[256];
+
+static PendingReload pending[MAX_PENDING_RELOADS];
+static int pendingCount = 0;
+static pthread_mutex_t reloadLock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_t watchThread;
+static int inotifyFd = -1;
+static int stopPipe[2] = { -1, -1 };
+static bool running = false;
+
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Function to find the first registered asset at or after first for a file name (caller holds reloadLock)
+static int FindAsset(const char* fileName, int first) {
+    for (int i = first; i < assetCount; i++) {
+        if (strcmp(assets[i].fileName, fileName) == 0) return i;
+    }
+    return -1;
+}
+
+// Function to hand a decoded asset to the main thread; false if it had to be dropped
+static bool QueueReload(PendingReload reload, const char* fileName) {
+    pthread_mutex_lock(&reloadLock);
+
+    // A newer save of the same file replaces the queued one
+    int slot = pendingCount;
+    for (int i = 0; i < pendingCount; i++) {
+        if (pending[i].asset == reload.asset) slot = i;
+    }
+
+    bool queued = true;
+    if (slot < pendingCount) {
+        UnloadImage(pending[slot].image);
+        pending[slot] = reload;
+    }
+    else if (pendingCount < MAX_PENDING_RELOADS) {
+        pending[pendingCount++] = reload;
+    }
+    else {
+        UnloadImage(reload.image);
+        TraceLog(LOG_WARNING, "HOTRELOAD: queue full, dropped %s", fileName);
+        queued = false;
+    }
+
+    pthread_mutex_unlock(&reloadLock);
+    return queued;
+}
+
+// Runs on the watch thread: decode the changed file and queue it for the main thread.
+// One file can back several assets (a texture kept at each quality tier); it is decoded once.
+static void DecodeAsset(const char* fileName) {
+    double detectedAt = Now();
+
+    char path[sizeof(watchDirectory) + 72];
+    snprintf(path, sizeof(path), "%s/%s", watchDirectory, fileName);
+
+    Image decoded = { 0 };
+    bool queued = false;
+
+    for (int index = 0; ; index++) {
+        pthread_mutex_lock(&reloadLock);
+        index = FindAsset(fileName, index);
+        HotAsset asset = (index >= 0) ? assets[index] : (HotAsset){ 0 };
+        pthread_mutex_unlock(&reloadLock);
+
+        if (index < 0) break;
+
+        PendingReload reload = { 0 };
+        reload.asset = index;
+        reload.detectedAt = detectedAt;
+
+        if (asset.kind == HOT_TEXTURE) {
+            if (decoded.data == NULL) decoded = LoadImage(path);
+            if (decoded.data == NULL) {
+                TraceLog(LOG_WARNING, "HOTRELOAD: can't decode %s, keeping old texture", fileName);
+                break;
+            }
+            reload.image = ImageCopy(decoded);
+            if (asset.width > 0 && asset.height > 0) {
+                ImageResize(&reload.image, asset.width, asset.height);
+            }
+        }
+        else if (!LoadLevelFile(path, &reload.level)) {
+            TraceLog(LOG_WARNING, "HOTRELOAD: can't parse %s, keeping old level", fileName);
+            break;
+        }
+
+        if (QueueReload(reload, fileName)) queued = true;
+    }
+    UnloadImage(decoded);
+
+    // A main loop waiting for input would only swap them in at the next event
+    if (queued) IdleWake();
+}
+
+static void* WatchThreadMain(void* arg) {
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd fds[2] = {
+        { inotifyFd, POLLIN, 0 },
+        { stopPipe[0], POLLIN, 0 }
+    };
+
+    // Decoding allocates, but off the frame
+    AllocTrackerSetLoaderThread();
+    AllocTrackerPushScope(ALLOC_ASSETS);
+
+    while (running) {
+        if (poll(fds, 2, -1) <= 0) continue;
+        if (fds[1].revents != 0) break;
+
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) continue;
+
+        for (char* p = buffer; p < buffer + length; ) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+
+            // Editors either rewrite the file or rename a temp file over it
+            if (event->len > 0 && (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))) {
+                DecodeAsset(event->name);
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    AllocTrackerPopScope();
+    return NULL;
+}
+
+bool HotReloadInit(const char* directory) {
+    if (running) return true;
+
+    snprintf(watchDirectory, sizeof(watchDirectory), "%s", directory);
+
+    inotifyFd = inotify_init1(IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        TraceLog(LOG_WARNING, "HOTRELOAD: inotify unavailable");
+        return false;
+    }
+
+    if (inotify_add_watch(inotifyFd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0 || pipe(stopPipe) != 0) {
+        TraceLog(LOG_WARNING, "HOTRELOAD: can't watch %s", directory);
+        close(inotifyFd);
+        inotifyFd = -1;
+        return false;
+    }
+
+    running = true;
+    if (pthread_create(&watchThread, NULL, WatchThreadMain, NULL) != 0) {
+        running = false;
+        close(inotifyFd);
+        close(stopPipe[0]);
+        close(stopPipe[1]);
+        inotifyFd = -1;
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "HOTRELOAD: watching %s", directory);
+    return true;
+}
+
+void HotReloadShutdown(void) {
+    if (!running) return;
+
+    running = false;
+    char stop = 1;
+    if (write(stopPipe[1], &stop, 1) != 1) {
+        TraceLog(LOG_WARNING, "HOTRELOAD: can't signal watch thread");
+    }
+    pthread_join(watchThread, NULL);
+
+    close(inotifyFd);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    inotifyFd = -1;
+
+    for (int i = 0; i < pendingCount; i++) {
+        UnloadImage(pending[i].image);
+    }
+    pendingCount = 0;
+}
+
+static bool AddAsset(HotAsset asset) {
+    pthread_mutex_lock(&reloadLock);
+    bool added = assetCount < MAX_HOT_ASSETS;
+    if (added) assets[assetCount++] = asset;
+    pthread_mutex_unlock(&reloadLock);
+    return added;
+}
+
+bool HotReloadWatchTexture(const char* fileName, Texture2D* texture, int width, int height) {
+    HotAsset asset = { 0 };
+    snprintf(asset.fileName, sizeof(asset.fileName), "%s", fileName);
+    asset.kind = HOT_TEXTURE;
+    asset.texture = texture;
+    asset.width = width;
+    asset.height = height;
+    return AddAsset(asset);
+}
+
+bool HotReloadWatchLevel(const char* fileName, int level) {
+    HotAsset asset = { 0 };
+    snprintf(asset.fileName, sizeof(asset.fileName), "%s", fileName);
+    asset.kind = HOT_LEVEL;
+    asset.level = level;
+    return AddAsset(asset);
+}
+
+unsigned int HotReloadPoll(int* swapped) {
+    static PendingReload ready[MAX_PENDING_RELOADS];
+    int readyCount = 0;
+    *swapped = 0;
+
+    // Never stall the frame on the watch thread
+    if (!running || pthread_mutex_trylock(&reloadLock) != 0) return 0;
+
+    if (pendingCount > 0) {
+        memcpy(ready, pending, sizeof(PendingReload) * pendingCount);
+        readyCount = pendingCount;
+        pendingCount = 0;
+    }
+    pthread_mutex_unlock(&reloadLock);
+
+    unsigned int changedLevels = 0;
+
+    for (int i = 0; i < readyCount; i++) {
+        const HotAsset* asset = &assets[ready[i].asset];
+
+        if (asset->kind == HOT_TEXTURE) {
+            Texture2D* texture = asset->texture;
+            Image image = ready[i].image;
+
+            if (image.width == texture->width && image.height == texture->height && image.format == texture->format) {
+                UpdateTexture(*texture, image.data);
+            }
+            else {
+                Texture2D replacement = LoadTextureFromImage(image);
+                if (replacement.id != 0) {
+                    UnloadTexture(*texture);
+                    *texture = replacement;
+                }
+            }
+            UnloadImage(image);
+        }
+        else {
+            ReplaceLevelData(asset->level, &ready[i].level);
+            changedLevels |= 1u << asset->level;
+        }
+
+        TraceLog(LOG_INFO, "HOTRELOAD: %s swapped in %.1f ms", asset->fileName,
+            (Now() - ready[i].detectedAt) * 1000.0);
+    }
+
+    *swapped = readyCount;
+    return changedLevels;
+}
+
+#else
+
+bool HotReloadInit(const char* directory) {
+    TraceLog(LOG_INFO, "HOTRELOAD: not supported on this platform");
+    return false;
+}
+
+void HotReloadShutdown(void) {}
+
+bool HotReloadWatchTexture(const char* fileName, Texture2D* texture, int width, int height) {
+    return false;
+}
+
+bool HotReloadWatchLevel(const char* fileName, int level) {
+    return false;
+}
+
+unsigned int HotReloadPoll(int* swapped) {
+    *swapped = 0;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+
+#include "raylib.h"
+
+#define MAX_HOT_ASSETS 32
+
+// Watches the asset directory (inotify on Linux, no-op elsewhere).
+// Changed files are decoded on a worker thread, which then wakes an idle
+// main loop; HotReloadPoll swaps the results in on the main thread.
+bool HotReloadInit(const char* directory);
+void HotReloadShutdown(void);
+
+// The texture is updated in place when the file changes. Pass a
+// non-zero size to resize the decoded image before upload. One file may
+// back several textures, e.g. a copy per quality tier.
+bool HotReloadWatchTexture(const char* fileName, Texture2D* texture, int width, int height);
+bool HotReloadWatchLevel(const char* fileName, int level);
+
+// Applies finished reloads; swapped gets how many assets changed.
+// Returns a bit mask of the levels that changed (bit n = level n);
+// their new data is already in the level cache.
+unsigned int HotReloadPoll(int* swapped);
+
+#endif
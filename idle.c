@@ -0,0 +1,40 @@
+#include "idle.h"
+
+// raylib's desktop platform waits in GLFW; posting an empty event is GLFW's
+// thread-safe way to end that wait, which raylib doesn't wrap
+void glfwPostEmptyEvent(void);
+
+bool IdleInputActive(void) {
+    Vector2 mouseDelta = GetMouseDelta();
+    if (mouseDelta.x != 0.0f || mouseDelta.y != 0.0f || GetMouseWheelMove() != 0.0f) return true;
+
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_RIGHT; button++) {
+        if (IsMouseButtonDown(button) || IsMouseButtonReleased(button)) return true;
+    }
+
+    // Held keys matter too: LEFT/RIGHT keep scrubbing while down
+    return GetKeyPressed() != 0 || IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_RIGHT);
+}
+
+bool IdleUpdate(IdleState* idle, bool changing) {
+    bool slept = idle->waiting;
+
+    idle->quietFrames = changing ? 0 : idle->quietFrames + 1;
+
+    if (idle->quietFrames >= IDLE_GRACE_FRAMES && !idle->waiting) {
+        TraceLog(LOG_DEBUG, "IDLE: Nothing changing, waiting for input");
+        EnableEventWaiting();
+        idle->waiting = true;
+    }
+    else if (idle->quietFrames == 0 && idle->waiting) {
+        TraceLog(LOG_DEBUG, "IDLE: Back to full rate");
+        DisableEventWaiting();
+        idle->waiting = false;
+    }
+
+    return slept;
+}
+
+void IdleWake(void) {
+    glfwPostEmptyEvent();
+}
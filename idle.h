@@ -0,0 +1,28 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include "raylib.h"
+
+#define IDLE_GRACE_FRAMES 3  // quiet frames still drawn, so the last change reaches the screen
+
+typedef struct {
+    int quietFrames;
+    bool waiting;  // EndDrawing() blocks until the next input event
+} IdleState;
+
+// True when the player did anything this frame: moved the mouse, scrolled,
+// pressed or held a button, or pressed a key
+bool IdleInputActive(void);
+
+// Call once per frame, before drawing, with whether anything on screen is
+// changing. After IDLE_GRACE_FRAMES quiet frames the loop sleeps in
+// EndDrawing() until an input event arrives; the first change switches back
+// to full rate. Returns true when the previous frame slept, so its frame
+// time measures the wait rather than any work.
+bool IdleUpdate(IdleState* idle, bool changing);
+
+// Ends the EndDrawing() wait from any thread, for changes that aren't
+// input (a file edited on disk)
+void IdleWake(void);
+
+#endif
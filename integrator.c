@@ -0,0 +1,33 @@
+#include "integrator.h"
+#include <string.h>
+
+static const char* const integratorNames[INTEGRATOR_COUNT] = { "euler", "verlet", "rk4" };
+
+const char* IntegratorName(IntegratorKind kind) {
+    return (kind >= 0 && kind < INTEGRATOR_COUNT) ? integratorNames[kind] : "unknown";
+}
+
+bool IntegratorFromName(const char* name, IntegratorKind* kind) {
+    for (int i = 0; i < INTEGRATOR_COUNT; i++) {
+        if (strcmp(name, integratorNames[i]) == 0) {
+            *kind = (IntegratorKind)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void IntegrateRows(IntegratorKind kind, Transform* transform, Vector2* velocity, const Motion* motion,
+    const TickRate* tick, int count) {
+    switch (kind) {
+    case INTEGRATOR_VELOCITY_VERLET:
+        for (int row = 0; row < count; row++) StepVelocityVerlet(&transform[row].position, &velocity[row], motion[row], tick[row].scale);
+        break;
+    case INTEGRATOR_RK4:
+        for (int row = 0; row < count; row++) StepRungeKutta4(&transform[row].position, &velocity[row], motion[row], tick[row].scale);
+        break;
+    default:
+        for (int row = 0; row < count; row++) StepSemiImplicitEuler(&transform[row].position, &velocity[row], motion[row], tick[row].scale);
+        break;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef INTEGRATOR_H
+#define INTEGRATOR_H
+
+#include "ecs.h"
+
+// How bodies move between collisions: gravity plus linear air drag,
+//   dv/dt = (-dragX * v.x, gravity - dragY * v.y)
+// with every constant per 60 Hz step, advanced by each row's TickRate.
+// Semi-implicit Euler is what the game has always done; velocity Verlet
+// and RK4 follow the same forces more closely at a higher cost per body.
+// `--bench integrators` compares them at several tick rates.
+typedef enum {
+    INTEGRATOR_SEMI_IMPLICIT_EULER,
+    INTEGRATOR_VELOCITY_VERLET,
+    INTEGRATOR_RK4,
+    INTEGRATOR_COUNT
+} IntegratorKind;
+
+const char* IntegratorName(IntegratorKind kind);
+
+// Looks up a name from IntegratorName() ("euler", "verlet", "rk4"); false if unknown
+bool IntegratorFromName(const char* name, IntegratorKind* kind);
+
+// Moves count rows of positions and velocities under their Motion
+void IntegrateRows(IntegratorKind kind, Transform* transform, Vector2* velocity, const Motion* motion,
+    const TickRate* tick, int count);
+
+// One body over one step. These are inline so a caller passing a constant
+// Motion gets it folded into its loop (see the block systems in bodies.c).
+static inline Vector2 MotionAcceleration(Motion motion, Vector2 velocity) {
+    return (Vector2){ -motion.dragX * velocity.x, motion.gravity - motion.dragY * velocity.y };
+}
+
+// Gravity, then drag as a share of speed lost, then position from the new velocity
+static inline void StepSemiImplicitEuler(Vector2* position, Vector2* velocity, Motion motion, float scale) {
+    velocity->y += motion.gravity * scale;
+    velocity->x *= (1.0f - motion.dragX * scale);
+    velocity->y *= (1.0f - motion.dragY * scale);
+
+    position->x += velocity->x * scale;
+    position->y += velocity->y * scale;
+}
+
+// Drag depends on velocity, so the end-of-step acceleration is taken at the Euler-predicted velocity
+static inline void StepVelocityVerlet(Vector2* position, Vector2* velocity, Motion motion, float scale) {
+    Vector2 v = *velocity;
+    Vector2 a0 = MotionAcceleration(motion, v);
+
+    position->x += (v.x + 0.5f * a0.x * scale) * scale;
+    position->y += (v.y + 0.5f * a0.y * scale) * scale;
+
+    Vector2 a1 = MotionAcceleration(motion, (Vector2){ v.x + a0.x * scale, v.y + a0.y * scale });
+    velocity->x = v.x + 0.5f * (a0.x + a1.x) * scale;
+    velocity->y = v.y + 0.5f * (a0.y + a1.y) * scale;
+}
+
+// Classic fourth-order Runge-Kutta on (position, velocity)
+static inline void StepRungeKutta4(Vector2* position, Vector2* velocity, Motion motion, float scale) {
+    const float half = 0.5f * scale;
+
+    Vector2 v1 = *velocity;
+    Vector2 a1 = MotionAcceleration(motion, v1);
+    Vector2 v2 = { v1.x + a1.x * half, v1.y + a1.y * half };
+    Vector2 a2 = MotionAcceleration(motion, v2);
+    Vector2 v3 = { v1.x + a2.x * half, v1.y + a2.y * half };
+    Vector2 a3 = MotionAcceleration(motion, v3);
+    Vector2 v4 = { v1.x + a3.x * scale, v1.y + a3.y * scale };
+    Vector2 a4 = MotionAcceleration(motion, v4);
+
+    const float sixth = scale / 6.0f;
+    position->x += (v1.x + 2.0f * v2.x + 2.0f * v3.x + v4.x) * sixth;
+    position->y += (v1.y + 2.0f * v2.y + 2.0f * v3.y + v4.y) * sixth;
+    velocity->x += (a1.x + 2.0f * a2.x + 2.0f * a3.x + a4.x) * sixth;
+    velocity->y += (a1.y + 2.0f * a2.y + 2.0f * a3.y + a4.y) * sixth;
+}
+
+// Moves count rows that all share one Motion
+static inline void IntegrateUniformRows(IntegratorKind kind, Transform* transform, Vector2* velocity, Motion motion,
+    const TickRate* tick, int count) {
+    switch (kind) {
+    case INTEGRATOR_VELOCITY_VERLET:
+        for (int row = 0; row < count; row++) StepVelocityVerlet(&transform[row].position, &velocity[row], motion, tick[row].scale);
+        break;
+    case INTEGRATOR_RK4:
+        for (int row = 0; row < count; row++) StepRungeKutta4(&transform[row].position, &velocity[row], motion, tick[row].scale);
+        break;
+    default:
+        for (int row = 0; row < count; row++) StepSemiImplicitEuler(&transform[row].position, &velocity[row], motion, tick[row].scale);
+        break;
+    }
+}
+
+#endif
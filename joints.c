@@ -0,0 +1,254 @@
+#include "joints.h"
+#include <math.h>
+
+// Stands in for bodyB of world joints; with no mass, impulses leave it where it is
+static JointBody worldBody;
+
+// Time stepped by the current SolveJoints() call, in 60 Hz steps
+static float stepScale;
+
+static Vector2 Rotate(Vector2 v, float angle) {
+    float c = cosf(angle);
+    float s = sinf(angle);
+    return (Vector2){ v.x * c - v.y * s, v.x * s + v.y * c };
+}
+
+static float Cross(Vector2 a, Vector2 b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+// Velocity of the point r away from the centre of a body spinning at w
+static Vector2 PointVelocity(const JointBody* body, Vector2 r) {
+    return (Vector2){ body->velocity.x - body->angularVelocity * r.y, body->velocity.y + body->angularVelocity * r.x };
+}
+
+JointBody MakeJointBody(Vector2 centre, float width, float height, float density) {
+    float mass = density * width * height / 1000.0f;
+    float inertia = mass * (width * width + height * height) / 12.0f;
+    return (JointBody){ centre, { 0.0f, 0.0f }, 0.0f, 0.0f, 1.0f / mass, 1.0f / inertia };
+}
+
+static JointBody* BodyB(const Joint* joint, JointBody* bodies) {
+    return (joint->bodyB == JOINT_WORLD) ? &worldBody : &bodies[joint->bodyB];
+}
+
+Vector2 JointAnchorA(const Joint* joint, const JointBody* bodies) {
+    const JointBody* a = &bodies[joint->bodyA];
+    Vector2 r = Rotate(joint->anchorA, a->rotation);
+    return (Vector2){ a->centre.x + r.x, a->centre.y + r.y };
+}
+
+Vector2 JointAnchorB(const Joint* joint, const JointBody* bodies) {
+    if (joint->bodyB == JOINT_WORLD) return joint->anchorB;
+
+    const JointBody* b = &bodies[joint->bodyB];
+    Vector2 r = Rotate(joint->anchorB, b->rotation);
+    return (Vector2){ b->centre.x + r.x, b->centre.y + r.y };
+}
+
+// Function to measure a joint from its bodies' current positions and rotations
+static JointFrame FrameJoint(const Joint* joint, JointBody* bodies) {
+    JointFrame frame;
+    frame.a = &bodies[joint->bodyA];
+    frame.b = BodyB(joint, bodies);
+    frame.rA = Rotate(joint->anchorA, frame.a->rotation);
+    frame.rB = (joint->bodyB == JOINT_WORLD) ? (Vector2){ 0.0f, 0.0f } : Rotate(joint->anchorB, frame.b->rotation);
+
+    Vector2 pA = { frame.a->centre.x + frame.rA.x, frame.a->centre.y + frame.rA.y };
+    Vector2 pB = (joint->bodyB == JOINT_WORLD) ? joint->anchorB :
+        (Vector2){ frame.b->centre.x + frame.rB.x, frame.b->centre.y + frame.rB.y };
+    Vector2 d = { pB.x - pA.x, pB.y - pA.y };
+
+    frame.distance = sqrtf(d.x * d.x + d.y * d.y);
+    frame.axis = (frame.distance > 0.0001f) ? (Vector2){ d.x / frame.distance, d.y / frame.distance } : (Vector2){ 0.0f, 1.0f };
+    frame.active = joint->type != JOINT_ROPE || frame.distance >= joint->length;
+    return frame;
+}
+
+// Function to change a body's velocity; the body has already moved this
+// step, so it is moved again by the change, as if solved before it moved
+static void Push(JointBody* body, Vector2 velocity, float angular) {
+    body->velocity.x += velocity.x;
+    body->velocity.y += velocity.y;
+    body->angularVelocity += angular;
+    body->centre.x += velocity.x * stepScale;
+    body->centre.y += velocity.y * stepScale;
+    body->rotation += angular * stepScale;
+}
+
+static void ApplyImpulse(JointFrame* frame, Vector2 impulse) {
+    JointBody* a = frame->a;
+    JointBody* b = frame->b;
+    Push(a, (Vector2){ -a->invMass * impulse.x, -a->invMass * impulse.y }, -a->invInertia * Cross(frame->rA, impulse));
+    Push(b, (Vector2){ b->invMass * impulse.x, b->invMass * impulse.y }, b->invInertia * Cross(frame->rB, impulse));
+}
+
+static void ApplyAngularImpulse(JointFrame* frame, float impulse) {
+    Push(frame->a, (Vector2){ 0.0f, 0.0f }, -frame->a->invInertia * impulse);
+    Push(frame->b, (Vector2){ 0.0f, 0.0f }, frame->b->invInertia * impulse);
+}
+
+// Effective mass along one axis
+static float AxisMass(const JointFrame* frame, Vector2 axis) {
+    float crossA = Cross(frame->rA, axis);
+    float crossB = Cross(frame->rB, axis);
+    float k = frame->a->invMass + frame->b->invMass +
+        frame->a->invInertia * crossA * crossA + frame->b->invInertia * crossB * crossB;
+    return (k > 0.0f) ? 1.0f / k : 0.0f;
+}
+
+// Function to solve K * impulse = -error for a point-to-point constraint
+static Vector2 PointImpulse(const JointFrame* frame, Vector2 error) {
+    const JointBody* a = frame->a;
+    const JointBody* b = frame->b;
+    Vector2 rA = frame->rA;
+    Vector2 rB = frame->rB;
+
+    float k11 = a->invMass + b->invMass + a->invInertia * rA.y * rA.y + b->invInertia * rB.y * rB.y;
+    float k12 = -a->invInertia * rA.x * rA.y - b->invInertia * rB.x * rB.y;
+    float k22 = a->invMass + b->invMass + a->invInertia * rA.x * rA.x + b->invInertia * rB.x * rB.x;
+    float det = k11 * k22 - k12 * k12;
+    if (det == 0.0f) return (Vector2){ 0.0f, 0.0f };
+
+    return (Vector2){ -(k22 * error.x - k12 * error.y) / det, -(k11 * error.y - k12 * error.x) / det };
+}
+
+static void WarmStart(Joint* joint, JointFrame* frame) {
+    joint->impulse.x *= JOINT_WARM_START;
+    joint->impulse.y *= JOINT_WARM_START;
+    joint->angularImpulse *= JOINT_WARM_START;
+
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+        if (!frame->active) {
+            joint->impulse.x = 0.0f;
+            return;
+        }
+        // Along the axis, stored in impulse.x
+        ApplyImpulse(frame, (Vector2){ frame->axis.x * joint->impulse.x, frame->axis.y * joint->impulse.x });
+        return;
+    }
+
+    ApplyImpulse(frame, joint->impulse);
+    if (joint->type == JOINT_WELD) ApplyAngularImpulse(frame, joint->angularImpulse);
+}
+
+static void SolveVelocity(Joint* joint, JointFrame* frame) {
+    Vector2 vA = PointVelocity(frame->a, frame->rA);
+    Vector2 vB = PointVelocity(frame->b, frame->rB);
+    Vector2 relative = { vB.x - vA.x, vB.y - vA.y };
+
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+        if (!frame->active) return;
+
+        float speed = relative.x * frame->axis.x + relative.y * frame->axis.y;
+        float lambda = -speed * AxisMass(frame, frame->axis);
+        float previous = joint->impulse.x;
+        joint->impulse.x += lambda;
+        if (joint->type == JOINT_ROPE && joint->impulse.x > 0.0f) joint->impulse.x = 0.0f;  // ropes only pull
+        lambda = joint->impulse.x - previous;
+
+        ApplyImpulse(frame, (Vector2){ frame->axis.x * lambda, frame->axis.y * lambda });
+        return;
+    }
+
+    if (joint->type == JOINT_WELD) {
+        float k = frame->a->invInertia + frame->b->invInertia;
+        if (k > 0.0f) {
+            float lambda = -(frame->b->angularVelocity - frame->a->angularVelocity) / k;
+            joint->angularImpulse += lambda;
+            ApplyAngularImpulse(frame, lambda);
+        }
+        vA = PointVelocity(frame->a, frame->rA);
+        vB = PointVelocity(frame->b, frame->rB);
+        relative = (Vector2){ vB.x - vA.x, vB.y - vA.y };
+    }
+
+    Vector2 impulse = PointImpulse(frame, relative);
+    joint->impulse.x += impulse.x;
+    joint->impulse.y += impulse.y;
+    ApplyImpulse(frame, impulse);
+}
+
+// Function to move both bodies by a position-level impulse
+static void ApplyCorrection(JointFrame* frame, Vector2 impulse) {
+    frame->a->centre.x -= frame->a->invMass * impulse.x;
+    frame->a->centre.y -= frame->a->invMass * impulse.y;
+    frame->a->rotation -= frame->a->invInertia * Cross(frame->rA, impulse);
+    frame->b->centre.x += frame->b->invMass * impulse.x;
+    frame->b->centre.y += frame->b->invMass * impulse.y;
+    frame->b->rotation += frame->b->invInertia * Cross(frame->rB, impulse);
+}
+
+static float Clamp(float value, float limit) {
+    return (value > limit) ? limit : (value < -limit) ? -limit : value;
+}
+
+static void SolvePosition(const Joint* joint, JointBody* bodies) {
+    JointFrame frame = FrameJoint(joint, bodies);
+
+    if (joint->type == JOINT_DISTANCE || joint->type == JOINT_ROPE) {
+        if (!frame.active) return;
+
+        float error = Clamp(frame.distance - joint->length, JOINT_MAX_CORRECTION);
+        float lambda = -JOINT_POSITION_BIAS * error * AxisMass(&frame, frame.axis);
+        ApplyCorrection(&frame, (Vector2){ frame.axis.x * lambda, frame.axis.y * lambda });
+        return;
+    }
+
+    if (joint->type == JOINT_WELD) {
+        float k = frame.a->invInertia + frame.b->invInertia;
+        if (k > 0.0f) {
+            float error = frame.b->rotation - frame.a->rotation - joint->angle;
+            float lambda = -JOINT_POSITION_BIAS * error / k;
+            frame.a->rotation -= frame.a->invInertia * lambda;
+            frame.b->rotation += frame.b->invInertia * lambda;
+        }
+        frame = FrameJoint(joint, bodies);
+    }
+
+    Vector2 error = { Clamp(frame.axis.x * frame.distance, JOINT_MAX_CORRECTION),
+        Clamp(frame.axis.y * frame.distance, JOINT_MAX_CORRECTION) };
+    Vector2 impulse = PointImpulse(&frame, error);
+    ApplyCorrection(&frame, (Vector2){ impulse.x * JOINT_POSITION_BIAS, impulse.y * JOINT_POSITION_BIAS });
+}
+
+int SolveJoints(Joint* joints, int jointCount, JointBody* bodies, JointFrame* frames, float scale) {
+    int broke = 0;
+    worldBody = (JointBody){ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 0.0f, 0.0f, 0.0f };
+    stepScale = scale;
+
+    for (int i = 0; i < jointCount; i++) {
+        if (joints[i].broken) continue;
+        frames[i] = FrameJoint(&joints[i], bodies);
+        WarmStart(&joints[i], &frames[i]);
+    }
+
+    // The lever arms measured above are kept for every pass, although Push()
+    // moves and turns the bodies as it goes, so they drift by up to a step's
+    // rotation; the position passes below measure afresh and take that out
+    for (int iteration = 0; iteration < JOINT_VELOCITY_ITERATIONS; iteration++) {
+        for (int i = 0; i < jointCount; i++) {
+            if (joints[i].broken) continue;
+            SolveVelocity(&joints[i], &frames[i]);
+        }
+    }
+
+    for (int i = 0; i < jointCount; i++) {
+        Joint* joint = &joints[i];
+        if (joint->broken || joint->breakForce <= 0.0f || scale <= 0.0f) continue;
+
+        float force = sqrtf(joint->impulse.x * joint->impulse.x + joint->impulse.y * joint->impulse.y) / scale;
+        if (force > joint->breakForce) {
+            joint->broken = true;
+            broke++;
+        }
+    }
+
+    for (int iteration = 0; iteration < JOINT_POSITION_ITERATIONS; iteration++) {
+        for (int i = 0; i < jointCount; i++) {
+            if (!joints[i].broken) SolvePosition(&joints[i], bodies);
+        }
+    }
+
+    return broke;
+}
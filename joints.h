@@ -0,0 +1,76 @@
+#ifndef JOINTS_H
+#define JOINTS_H
+
+#include "raylib.h"
+
+#define JOINT_WORLD -1                // bodyB of a joint pinned to the world
+#define JOINT_VELOCITY_ITERATIONS 8
+#define JOINT_POSITION_ITERATIONS 3
+#define JOINT_WARM_START 0.9f         // share of last step's impulse applied up front
+#define JOINT_POSITION_BIAS 1.0f      // share of the position error removed per iteration
+#define JOINT_MAX_CORRECTION 8.0f     // pixels per iteration, so a snap can't teleport bodies
+
+typedef enum {
+    JOINT_DISTANCE,  // anchors held at a fixed distance (a rigid rod)
+    JOINT_REVOLUTE,  // anchors pinned together, free to rotate (a hinge)
+    JOINT_ROPE,      // anchors at most length apart, slack when closer
+    JOINT_WELD       // pinned together and keeping their relative angle
+} JointType;
+
+// Anchors are offsets from each body's centre in its unrotated frame; for
+// JOINT_WORLD bodies anchorB is the world point itself
+typedef struct {
+    unsigned char type;  // JointType
+    bool broken;
+    short bodyA;
+    short bodyB;         // or JOINT_WORLD
+    Vector2 anchorA;
+    Vector2 anchorB;
+    float length;        // distance and rope joints
+    float angle;         // weld joints: rotation of B minus rotation of A
+    float breakForce;    // impulse per 60 Hz step that snaps the joint, 0 for unbreakable
+
+    // Accumulated impulses, kept between steps for warm starting
+    Vector2 impulse;
+    float angularImpulse;
+} Joint;
+
+// Everything the solver reads and writes of a body. Static bodies (at
+// rest, or not simulated) have zero inverse mass and inertia.
+typedef struct {
+    Vector2 centre;
+    Vector2 velocity;       // per 60 Hz step
+    float rotation;         // radians
+    float angularVelocity;  // radians per 60 Hz step
+    float invMass;
+    float invInertia;
+} JointBody;
+
+// Per-step lever arms of one joint; SolveJoints() needs one per joint as scratch
+typedef struct {
+    JointBody* a;
+    JointBody* b;
+    Vector2 rA;
+    Vector2 rB;
+    Vector2 axis;     // from anchor A to anchor B
+    float distance;
+    bool active;      // rope joints go slack when shorter than their length
+} JointFrame;
+
+// Mass properties of a width x height box of the given density
+JointBody MakeJointBody(Vector2 centre, float width, float height, float density);
+
+// World position of each anchor
+Vector2 JointAnchorA(const Joint* joint, const JointBody* bodies);
+Vector2 JointAnchorB(const Joint* joint, const JointBody* bodies);
+
+// Sequential impulses over every joint (warm started from last step), then
+// a few rounds of position projection to remove drift. Bodies are expected
+// to have moved this step already; every velocity change moves them again
+// by scale, as if the joints had been solved first. Joints whose impulse
+// passes breakForce are marked broken and skipped from then on. scale is
+// the time stepped, in 60 Hz steps. frames is scratch space for jointCount
+// joints. Returns how many joints broke.
+int SolveJoints(Joint* joints, int jointCount, JointBody* bodies, JointFrame* frames, float scale);
+
+#endif
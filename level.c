@@ -0,0 +1,172 @@
+#include "level.h"
+#include "materials.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static LevelData levelCache[MAX_LEVELS + 1];
+static bool levelCached[MAX_LEVELS + 1];
+
+static Vector2 BlockCentre(const Block* block) {
+    return (Vector2){ block->rect.x + block->rect.width / 2.0f, block->rect.y + block->rect.height / 2.0f };
+}
+
+// Function to read "joint <type> <blockA> <blockB> <x> <y> [<x2> <y2>] [<breakForce>]"; false if malformed
+static bool ParseJoint(const char* line, LevelData* level, int lineNumber) {
+    char typeName[16];
+    char other[16];
+    int a;
+    float v[5];
+    int fields = sscanf(line, "%*s %15s %d %15s %f %f %f %f %f", typeName, &a, other, &v[0], &v[1], &v[2], &v[3], &v[4]);
+    if (fields < 5) return false;
+
+    JointType type;
+    if (strcmp(typeName, "distance") == 0) type = JOINT_DISTANCE;
+    else if (strcmp(typeName, "rope") == 0) type = JOINT_ROPE;
+    else if (strcmp(typeName, "hinge") == 0) type = JOINT_REVOLUTE;
+    else if (strcmp(typeName, "weld") == 0) type = JOINT_WELD;
+    else return false;
+
+    bool twoPoints = (type == JOINT_DISTANCE || type == JOINT_ROPE);
+    int values = fields - 3;
+    if (twoPoints && values < 4) return false;
+
+    int b = JOINT_WORLD;
+    if (strcmp(other, "world") != 0 && sscanf(other, "%d", &b) != 1) return false;
+
+    if (a < 0 || a >= level->blockCount || b < JOINT_WORLD || b >= level->blockCount || a == b) {
+        TraceLog(LOG_WARNING, "LEVEL: line %d: joint between missing blocks %d and %d", lineNumber, a, b);
+        return true;
+    }
+    if (level->jointCount >= MAX_JOINTS) {
+        TraceLog(LOG_WARNING, "LEVEL: line %d: more than %d joints", lineNumber, MAX_JOINTS);
+        return true;
+    }
+
+    Vector2 pointA = { v[0], v[1] };
+    Vector2 pointB = twoPoints ? (Vector2){ v[2], v[3] } : pointA;
+    int breakField = twoPoints ? 4 : 2;
+    Vector2 centreA = BlockCentre(&level->blocks[a]);
+
+    Joint joint = { 0 };
+    joint.type = (unsigned char)type;
+    joint.bodyA = (short)a;
+    joint.bodyB = (short)b;
+    joint.anchorA = (Vector2){ pointA.x - centreA.x, pointA.y - centreA.y };
+    joint.anchorB = pointB;
+    if (b != JOINT_WORLD) {
+        Vector2 centreB = BlockCentre(&level->blocks[b]);
+        joint.anchorB = (Vector2){ pointB.x - centreB.x, pointB.y - centreB.y };
+    }
+    joint.length = hypotf(pointB.x - pointA.x, pointB.y - pointA.y);
+    joint.breakForce = (values > breakField) ? v[breakField] : 0.0f;
+
+    level->joints[level->jointCount++] = joint;
+    return true;
+}
+
+// Function to parse one level description; unknown lines are reported and skipped
+bool ParseLevelText(const char* text, LevelData* level) {
+    memset(level, 0, sizeof(*level));
+    if (text == NULL) return false;
+
+    int lineNumber = 0;
+    const char* line = text;
+
+    while (*line != '\0') {
+        const char* end = strchr(line, '\n');
+        size_t length = end ? (size_t)(end - line) : strlen(line);
+        char buffer[128];
+        if (length >= sizeof(buffer)) length = sizeof(buffer) - 1;
+        memcpy(buffer, line, length);
+        buffer[length] = '\0';
+        lineNumber++;
+
+        char* comment = strchr(buffer, '#');
+        if (comment) *comment = '\0';
+
+        char kind[16];
+        char materialName[16];
+        Rectangle r;
+        float x, y, radius;
+
+        if (sscanf(buffer, "%15s", kind) != 1) {
+            // blank line
+        }
+        else if (strcmp(kind, "block") == 0 &&
+            sscanf(buffer, "%*s %f %f %f %f %15s", &r.x, &r.y, &r.width, &r.height, materialName) == 5) {
+            int material = FindMaterial(materialName);
+            if (material < 0) {
+                TraceLog(LOG_WARNING, "LEVEL: line %d: unknown material '%s', using wood", lineNumber, materialName);
+                material = MATERIAL_WOOD;
+            }
+
+            if (level->blockCount < MAX_BLOCKS) {
+                level->blocks[level->blockCount++] = (Block){
+                    r, true, {0.0f, 0.0f}, false, r, 0.0f, 0.0f, false, (unsigned char)material
+                };
+            }
+            else {
+                TraceLog(LOG_WARNING, "LEVEL: line %d: more than %d blocks", lineNumber, MAX_BLOCKS);
+            }
+        }
+        else if (strcmp(kind, "enemy") == 0 &&
+            sscanf(buffer, "%*s %f %f %f", &x, &y, &radius) == 3) {
+            if (level->enemyCount < MAX_ENEMIES) {
+                level->enemies[level->enemyCount++] = (Enemy){
+                    {x, y}, radius, true, {0.0f, 0.0f}, false, false,
+                    ENEMY_MAX_HEALTH, ENEMY_MAX_HEALTH, 0.0f
+                };
+            }
+            else {
+                TraceLog(LOG_WARNING, "LEVEL: line %d: more than %d enemies", lineNumber, MAX_ENEMIES);
+            }
+        }
+        else if (strcmp(kind, "joint") == 0 && ParseJoint(buffer, level, lineNumber)) {
+            // added by ParseJoint
+        }
+        else {
+            TraceLog(LOG_WARNING, "LEVEL: line %d: can't parse '%s'", lineNumber, buffer);
+        }
+
+        if (end == NULL) break;
+        line = end + 1;
+    }
+
+    return level->blockCount > 0 || level->enemyCount > 0;
+}
+
+bool LoadLevelFile(const char* fileName, LevelData* level) {
+    char* text = LoadFileText(fileName);
+    if (text == NULL) {
+        memset(level, 0, sizeof(*level));
+        return false;
+    }
+
+    bool ok = ParseLevelText(text, level);
+    UnloadFileText(text);
+    return ok;
+}
+
+const char* LevelFileName(int level) {
+    return TextFormat("level%d.lvl", level);
+}
+
+const LevelData* GetLevelData(int level) {
+    if (level < 1 || level > MAX_LEVELS) level = 1;
+
+    if (!levelCached[level]) {
+        if (!LoadLevelFile(LevelFileName(level), &levelCache[level])) {
+            TraceLog(LOG_ERROR, "LEVEL: failed to load %s", LevelFileName(level));
+        }
+        levelCached[level] = true;
+    }
+    return &levelCache[level];
+}
+
+void ReplaceLevelData(int level, const LevelData* data) {
+    if (level < 1 || level > MAX_LEVELS) return;
+
+    levelCache[level] = *data;
+    levelCached[level] = true;
+}
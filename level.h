@@ -0,0 +1,34 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "game.h"
+
+#define MAX_LEVELS 16
+
+// Everything needed to instantiate a level, as read from levelN.lvl
+typedef struct {
+    Block blocks[MAX_BLOCKS];
+    int blockCount;
+    Enemy enemies[MAX_ENEMIES];
+    int enemyCount;
+    Joint joints[MAX_JOINTS];
+    int jointCount;
+} LevelData;
+
+// Level file format, one entry per line ('#' starts a comment):
+//   block <x> <y> <width> <height> <material>   (wood, stone, ice, glass, tnt)
+//   enemy <x> <y> <radius>
+//   joint <type> <blockA> <blockB> <x> <y> [<x2> <y2>] [<breakForce>]
+// Joint types are distance, rope (both anchored at (x, y) on A and (x2, y2)
+// on B, which sets their length), hinge and weld (one shared point). Blocks
+// are numbered from 0 in file order; blockB may be "world". Joints must
+// come after the blocks they join.
+bool ParseLevelText(const char* text, LevelData* level);
+bool LoadLevelFile(const char* fileName, LevelData* level);
+const char* LevelFileName(int level);
+
+// Cached level data, loaded from disk on first use
+const LevelData* GetLevelData(int level);
+void ReplaceLevelData(int level, const LevelData* data);
+
+#endif
@@ -0,0 +1,125 @@
+#include "level_prefetch.h"
+#include "alloc_tracker.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    int level;           // 0 when nothing is being prepared
+    char fileName[64];   // resolved on the main thread; TextFormat() isn't thread safe
+    bool loaded;
+    LevelData data;
+    WorldSnapshot world;
+} Prefetch;
+
+// Written by the worker until ready is set, then by the main thread only
+static Prefetch prefetch;
+static atomic_bool ready;
+
+// Function to read a level and build the world it starts with
+static void PrepareLevel(Prefetch* job) {
+    job->loaded = LoadLevelFile(job->fileName, &job->data);
+
+    // Zeroed like CaptureWorld(), so the first snapshot deltas stay small
+    WorldSnapshot* world = &job->world;
+    memset(world, 0, sizeof(*world));
+    world->lives = 3;
+    world->bird = (Bird){ { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+    world->blockCount = job->data.blockCount;
+    world->enemyCount = job->data.enemyCount;
+    world->jointCount = job->data.jointCount;
+    memcpy(world->blocks, job->data.blocks, sizeof(Block) * job->data.blockCount);
+    memcpy(world->enemies, job->data.enemies, sizeof(Enemy) * job->data.enemyCount);
+    memcpy(world->joints, job->data.joints, sizeof(Joint) * job->data.jointCount);
+    ClearTimers(&world->timers);
+}
+
+#ifndef _WIN32
+
+#include <pthread.h>
+
+static pthread_t worker;
+static bool working = false;
+
+static void* PrefetchMain(void* argument) {
+    // Reading the level allocates, but off the frame
+    AllocTrackerSetLoaderThread();
+    AllocTrackerPushScope(ALLOC_ASSETS);
+    PrepareLevel(&prefetch);
+    AllocTrackerPopScope();
+    atomic_store_explicit(&ready, true, memory_order_release);
+    return NULL;
+}
+
+// Function to wait for the worker to exit
+static void JoinWorker(void) {
+    if (!working) return;
+
+    pthread_join(worker, NULL);
+    working = false;
+}
+
+static void LaunchWorker(void) {
+    if (pthread_create(&worker, NULL, PrefetchMain, NULL) == 0) {
+        working = true;
+        return;
+    }
+
+    TraceLog(LOG_WARNING, "PREFETCH: can't start worker, loading level %d inline", prefetch.level);
+    PrepareLevel(&prefetch);
+    atomic_store_explicit(&ready, true, memory_order_release);
+}
+
+#else
+
+// No worker thread on Windows builds: the level is prepared inside LevelPrefetchStart()
+
+static void JoinWorker(void) {
+}
+
+static void LaunchWorker(void) {
+    PrepareLevel(&prefetch);
+    atomic_store_explicit(&ready, true, memory_order_release);
+}
+
+#endif
+
+void LevelPrefetchStart(int level) {
+    JoinWorker();
+
+    prefetch.level = level;
+    snprintf(prefetch.fileName, sizeof(prefetch.fileName), "%s", LevelFileName(level));
+    atomic_store_explicit(&ready, false, memory_order_relaxed);
+    LaunchWorker();
+}
+
+int LevelPrefetchLevel(void) {
+    return prefetch.level;
+}
+
+bool LevelPrefetchReady(int level) {
+    return level != 0 && prefetch.level == level && atomic_load_explicit(&ready, memory_order_acquire);
+}
+
+bool LevelPrefetchTake(int level, WorldSnapshot* world, LevelData* data) {
+    if (!LevelPrefetchReady(level)) return false;
+
+    // Already finished, so this only reaps the thread
+    JoinWorker();
+    prefetch.level = 0;
+
+    if (!prefetch.loaded) {
+        TraceLog(LOG_WARNING, "PREFETCH: can't load %s", prefetch.fileName);
+        return false;
+    }
+
+    *world = prefetch.world;
+    *data = prefetch.data;
+    return true;
+}
+
+void LevelPrefetchCancel(void) {
+    JoinWorker();
+    prefetch.level = 0;
+    atomic_store_explicit(&ready, false, memory_order_relaxed);
+}
@@ -0,0 +1,30 @@
+#ifndef LEVEL_PREFETCH_H
+#define LEVEL_PREFETCH_H
+
+#include "level.h"
+#include "snapshot.h"
+
+// Reads and instantiates one level on a worker thread while the player is
+// still looking at the previous one, so switching to it costs a copy.
+// The prepared world is a WorldSnapshot of the level at step 0: resting
+// bird, three lives, no timers. Without thread support the work is done
+// inside LevelPrefetchStart().
+
+// Starts preparing level; one already being prepared is finished and dropped first
+void LevelPrefetchStart(int level);
+
+// The level being prepared or ready, 0 for none
+int LevelPrefetchLevel(void);
+
+// True once the worker is done with level; never waits
+bool LevelPrefetchReady(int level);
+
+// Hands over the prepared world and the level data it was built from.
+// Returns false (and keeps nothing) if level isn't ready or its file
+// couldn't be read.
+bool LevelPrefetchTake(int level, WorldSnapshot* world, LevelData* data);
+
+// Drops whatever is being prepared, waiting for the worker if it's busy
+void LevelPrefetchCancel(void);
+
+#endif
@@ -2,6 +2,9 @@
 #include <cmath>
 #include <vector>
 #include <string>
+#include <cstdlib>
+#include <new>
+#include "alloc_tracker.h"
 
 struct Bird {
     Vector2 position;
@@ -36,9 +39,18 @@ std::vector<Enemy> enemies = {
 };
 
 
-// Trajectory hesaplama fonksiyonu
-std::vector<Vector2> CalculateTrajectory(Vector2 startPos, Vector2 velocity, int numPoints, float timeStep) {
-    std::vector<Vector2> points;
+// Tüm C++ heap ayırmalarını say (aktif kapsamın alt sistemine ve satırına yazılır)
+void* operator new(std::size_t size) {
+    AllocTrackerRecordInScope(size);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Trajectory hesaplama fonksiyonu (çağıranın vektörünü doldurur, kapasite korunur)
+void CalculateTrajectory(Vector2 startPos, Vector2 velocity, int numPoints, float timeStep, std::vector<Vector2>& points) {
+    points.clear();
     const float gravity = 0.5f;
     for (int i = 0; i < numPoints; i++) {
         float t = i * timeStep;
@@ -46,7 +58,6 @@ std::vector<Vector2> CalculateTrajectory(Vector2 startPos, Vector2 velocity, int
         float y = startPos.y + velocity.y * t + 0.5f * gravity * t * t;
         points.push_back({ x, y });
     }
-    return points;
 }
 
 const float gravity = 0.41f;
@@ -60,6 +71,9 @@ int main() {
     InitWindow(screenWidth, screenHeight, "Angry Birds - Raylib");
     SetTargetFPS(60);
 
+    // Yüklenen her şey assets alt sistemine yazılır
+    AllocTrackerPushScope(ALLOC_ASSETS);
+
     // Arka plan
     Image bgImage = LoadImage("backpeace.jpg");
     ImageResize(&bgImage, 1536, 1024);
@@ -83,6 +97,7 @@ int main() {
     if (birdTexture.id == 0) {
         TraceLog(LOG_ERROR, "Bird texture failed to load!");
     }
+    AllocTrackerPopScope();
 
     const int maxLives = 3;
     int lives = maxLives;
@@ -121,8 +136,26 @@ int main() {
     int score = 0;
     bool dragging = false;
 
+    // Nişangah noktaları: tek sefer ayrılır, her karede yeniden kullanılır
+    std::vector<Vector2> trajPoints;
+    trajPoints.reserve(100);
+
+    // Isınmadan sonra GAME durumunda heap ayırması hata sayılır
+    const int allocWarmupFrames = 120;
+    int gameFrames = 0;
+
     while (!WindowShouldClose()) {
+        AllocTrackerBeginFrame();
+        if (currentState != GAME) {
+            AllocTrackerSetSteadyState(false);
+            gameFrames = 0;
+        }
+        else if (++gameFrames == allocWarmupFrames) {
+            AllocTrackerSetSteadyState(true);
+        }
+
         if (currentState == MENU) {
+            AllocTrackerPushScope(ALLOC_UI);
             BeginDrawing();
             ClearBackground(RAYWHITE);
 
@@ -140,12 +173,14 @@ int main() {
             }
 
             EndDrawing();
+            AllocTrackerPopScope();
             continue; // Menüdeyken oyunu çizme
         }
         // Eğer oyun başladıysa (yani currentState == GAME)
        
 
         // === GÜNCELLEME ===
+        AllocTrackerPushScope(ALLOC_PHYSICS);
         for (auto& block : blocks) {
             if (block.active && block.falling) {
                 for (auto& enemy : enemies) {
@@ -291,7 +326,10 @@ int main() {
 
         }
 
+        AllocTrackerPopScope();
+
         // === ÇİZİM ===
+        AllocTrackerPushScope(ALLOC_RENDER);
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -396,6 +434,8 @@ int main() {
             }
         }
 
+        // Blok fiziği çizimin ortasında çalışır
+        AllocTrackerPushScope(ALLOC_PHYSICS);
         for (auto& block : blocks) {
             if (block.active && block.falling) {
                 // Yerçekimi etkisi
@@ -446,6 +486,7 @@ int main() {
                 }
             }
         }
+        AllocTrackerPopScope();
 
 
 
@@ -495,13 +536,14 @@ int main() {
                 (slingPos.x - bird.position.x) * 0.2f,
                 (slingPos.y - bird.position.y) * 0.2f
             };
-            std::vector<Vector2> trajPoints = CalculateTrajectory(slingPos, velocity, 100, 0.9f);
+            CalculateTrajectory(slingPos, velocity, 100, 0.9f, trajPoints);
             for (const auto& point : trajPoints) {
                 DrawCircleV(point, 2.0f, WHITE);
             }
         }
 
         EndDrawing();
+        AllocTrackerPopScope();
     }
 
     // Kaynakları boşalt
@@ -513,7 +555,7 @@ int main() {
     UnloadTexture(blockTexture2);
     UnloadTexture(enemyTexture);
     UnloadTexture(menuBackground);
-   
+    AllocTrackerReport();
 
 
     CloseWindow();
@@ -0,0 +1,46 @@
+#ifndef MATERIALS_H
+#define MATERIALS_H
+
+#include <string.h>
+
+// Block materials: X(id, name, mass, friction, bounciness)
+// mass scales gravity, friction is kept on ground contact, bounciness is
+// the share of vertical speed kept when bouncing off the ground. TNT
+// explodes once knocked loose, see explosion.h. Masses keep the real
+// density order: wood, ice, glass, stone.
+#define MATERIAL_LIST(X) \
+    X(WOOD,  "wood",  2.0f, 0.8f, 0.3f) \
+    X(STONE, "stone", 3.0f, 0.9f, 0.2f) \
+    X(ICE,   "ice",   2.3f, 0.95f, 0.1f) \
+    X(GLASS, "glass", 2.6f, 0.8f, 0.2f) \
+    X(TNT,   "tnt",   2.0f, 0.8f, 0.3f)
+
+typedef enum {
+#define MATERIAL_ENUM(id, name, mass, friction, bounciness) MATERIAL_##id,
+    MATERIAL_LIST(MATERIAL_ENUM)
+#undef MATERIAL_ENUM
+    MATERIAL_COUNT
+} MaterialId;
+
+typedef struct {
+    const char* name;
+    float mass;
+    float friction;
+    float bounciness;
+} Material;
+
+static const Material materialTable[MATERIAL_COUNT] = {
+#define MATERIAL_ENTRY(id, name, mass, friction, bounciness) { name, mass, friction, bounciness },
+    MATERIAL_LIST(MATERIAL_ENTRY)
+#undef MATERIAL_ENTRY
+};
+
+// Function to look a material up by its level-file name, -1 if unknown
+static inline int FindMaterial(const char* name) {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        if (strcmp(materialTable[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+#endif
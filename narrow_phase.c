@@ -0,0 +1,210 @@
+#include "narrow_phase.h"
+#include <math.h>
+#include <stddef.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+bool PackRect(PackedRects* rects, Rectangle rect) {
+    if (rects->count >= NARROW_MAX_BODIES) return false;
+
+    int i = rects->count++;
+    rects->x[i] = rect.x;
+    rects->y[i] = rect.y;
+    rects->width[i] = rect.width;
+    rects->height[i] = rect.height;
+    return true;
+}
+
+bool PackCircle(PackedCircles* circles, Vector2 centre, float radius) {
+    if (circles->count >= NARROW_MAX_BODIES) return false;
+
+    int i = circles->count++;
+    circles->x[i] = centre.x;
+    circles->y[i] = centre.y;
+    circles->radius[i] = radius;
+    return true;
+}
+
+// Function to test one circle against a rect the way CheckCollisionCircleRec does
+static bool CircleRect(float cx, float cy, float radius, float x, float y, float width, float height, float* depth) {
+    float halfWidth = width / 2.0f;
+    float halfHeight = height / 2.0f;
+    float dx = fabsf(cx - (x + halfWidth));
+    float dy = fabsf(cy - (y + halfHeight));
+
+    bool hit;
+    if (dx > halfWidth + radius || dy > halfHeight + radius) hit = false;
+    else if (dx <= halfWidth || dy <= halfHeight) hit = true;
+    else hit = (dx - halfWidth) * (dx - halfWidth) + (dy - halfHeight) * (dy - halfHeight) <= radius * radius;
+
+    if (depth) {
+        if (!hit) *depth = 0.0f;
+        else if (dx <= halfWidth && dy <= halfHeight) *depth = radius + fminf(halfWidth - dx, halfHeight - dy);
+        else {
+            float ex = fmaxf(dx - halfWidth, 0.0f);
+            float ey = fmaxf(dy - halfHeight, 0.0f);
+            *depth = radius - sqrtf(ex * ex + ey * ey);
+        }
+    }
+    return hit;
+}
+
+static bool CircleRectLane(Vector2 centre, float radius, const PackedRects* rects, int i, float* depth) {
+    return CircleRect(centre.x, centre.y, radius, rects->x[i], rects->y[i], rects->width[i], rects->height[i],
+        depth ? depth + i : NULL);
+}
+
+static bool RectCircleLane(Rectangle rect, const PackedCircles* circles, int i, float* depth) {
+    return CircleRect(circles->x[i], circles->y[i], circles->radius[i], rect.x, rect.y, rect.width, rect.height,
+        depth ? depth + i : NULL);
+}
+
+// Function to test one lane the way CheckCollisionCircles does
+static bool CircleCircleLane(Vector2 centre, float radius, const PackedCircles* circles, int i, float* depth) {
+    float dx = circles->x[i] - centre.x;
+    float dy = circles->y[i] - centre.y;
+    float reach = radius + circles->radius[i];
+    bool hit = dx * dx + dy * dy <= reach * reach;
+
+    if (depth) depth[i] = hit ? reach - sqrtf(dx * dx + dy * dy) : 0.0f;
+    return hit;
+}
+
+#if defined(__AVX2__)
+
+// Separate multiplies and adds (no FMA), so every lane rounds like the scalar tests
+
+// Function to run CircleRect() on eight lanes; returns the hit lanes as a mask
+static int CircleRectLanes(__m256 cx, __m256 cy, __m256 r, __m256 x, __m256 y, __m256 width, __m256 height, float* depth) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    __m256 halfWidth = _mm256_mul_ps(width, half);
+    __m256 halfHeight = _mm256_mul_ps(height, half);
+    __m256 dx = _mm256_andnot_ps(signBit, _mm256_sub_ps(cx, _mm256_add_ps(x, halfWidth)));
+    __m256 dy = _mm256_andnot_ps(signBit, _mm256_sub_ps(cy, _mm256_add_ps(y, halfHeight)));
+
+    __m256 far = _mm256_or_ps(_mm256_cmp_ps(dx, _mm256_add_ps(halfWidth, r), _CMP_GT_OQ),
+        _mm256_cmp_ps(dy, _mm256_add_ps(halfHeight, r), _CMP_GT_OQ));
+    __m256 insideX = _mm256_cmp_ps(dx, halfWidth, _CMP_LE_OQ);
+    __m256 insideY = _mm256_cmp_ps(dy, halfHeight, _CMP_LE_OQ);
+    __m256 ex = _mm256_sub_ps(dx, halfWidth);
+    __m256 ey = _mm256_sub_ps(dy, halfHeight);
+    __m256 cornerSq = _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+    __m256 corner = _mm256_cmp_ps(cornerSq, _mm256_mul_ps(r, r), _CMP_LE_OQ);
+    __m256 hit = _mm256_andnot_ps(far, _mm256_or_ps(_mm256_or_ps(insideX, insideY), corner));
+
+    if (depth) {
+        ex = _mm256_max_ps(ex, _mm256_setzero_ps());
+        ey = _mm256_max_ps(ey, _mm256_setzero_ps());
+        __m256 outside = _mm256_sub_ps(r, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey))));
+        __m256 inside = _mm256_add_ps(r, _mm256_min_ps(_mm256_sub_ps(halfWidth, dx), _mm256_sub_ps(halfHeight, dy)));
+        __m256 reach = _mm256_blendv_ps(outside, inside, _mm256_and_ps(insideX, insideY));
+        _mm256_storeu_ps(depth, _mm256_and_ps(reach, hit));
+    }
+    return _mm256_movemask_ps(hit);
+}
+
+uint64_t CircleVsRects(Vector2 centre, float radius, const PackedRects* rects, float* depth) {
+    const __m256 cx = _mm256_set1_ps(centre.x);
+    const __m256 cy = _mm256_set1_ps(centre.y);
+    const __m256 r = _mm256_set1_ps(radius);
+
+    uint64_t mask = 0;
+    int i = 0;
+    for (; i + 8 <= rects->count; i += 8) {
+        int hit = CircleRectLanes(cx, cy, r, _mm256_loadu_ps(rects->x + i), _mm256_loadu_ps(rects->y + i),
+            _mm256_loadu_ps(rects->width + i), _mm256_loadu_ps(rects->height + i), depth ? depth + i : NULL);
+        mask |= (uint64_t)hit << i;
+    }
+
+    for (; i < rects->count; i++) {
+        if (CircleRectLane(centre, radius, rects, i, depth)) mask |= (uint64_t)1 << i;
+    }
+    return mask;
+}
+
+uint64_t RectVsCircles(Rectangle rect, const PackedCircles* circles, float* depth) {
+    const __m256 x = _mm256_set1_ps(rect.x);
+    const __m256 y = _mm256_set1_ps(rect.y);
+    const __m256 width = _mm256_set1_ps(rect.width);
+    const __m256 height = _mm256_set1_ps(rect.height);
+
+    uint64_t mask = 0;
+    int i = 0;
+    for (; i + 8 <= circles->count; i += 8) {
+        int hit = CircleRectLanes(_mm256_loadu_ps(circles->x + i), _mm256_loadu_ps(circles->y + i),
+            _mm256_loadu_ps(circles->radius + i), x, y, width, height, depth ? depth + i : NULL);
+        mask |= (uint64_t)hit << i;
+    }
+
+    for (; i < circles->count; i++) {
+        if (RectCircleLane(rect, circles, i, depth)) mask |= (uint64_t)1 << i;
+    }
+    return mask;
+}
+
+uint64_t CircleVsCircles(Vector2 centre, float radius, const PackedCircles* circles, float* depth) {
+    const __m256 cx = _mm256_set1_ps(centre.x);
+    const __m256 cy = _mm256_set1_ps(centre.y);
+    const __m256 r = _mm256_set1_ps(radius);
+
+    uint64_t mask = 0;
+    int i = 0;
+    for (; i + 8 <= circles->count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(circles->x + i), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(circles->y + i), cy);
+        __m256 reach = _mm256_add_ps(r, _mm256_loadu_ps(circles->radius + i));
+        __m256 distanceSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 hit = _mm256_cmp_ps(distanceSq, _mm256_mul_ps(reach, reach), _CMP_LE_OQ);
+
+        mask |= (uint64_t)_mm256_movemask_ps(hit) << i;
+
+        if (depth) {
+            __m256 overlap = _mm256_sub_ps(reach, _mm256_sqrt_ps(distanceSq));
+            _mm256_storeu_ps(depth + i, _mm256_and_ps(overlap, hit));
+        }
+    }
+
+    for (; i < circles->count; i++) {
+        if (CircleCircleLane(centre, radius, circles, i, depth)) mask |= (uint64_t)1 << i;
+    }
+    return mask;
+}
+
+#else
+
+uint64_t CircleVsRects(Vector2 centre, float radius, const PackedRects* rects, float* depth) {
+    uint64_t mask = 0;
+    for (int i = 0; i < rects->count; i++) {
+        if (CircleRectLane(centre, radius, rects, i, depth)) mask |= (uint64_t)1 << i;
+    }
+    return mask;
+}
+
+uint64_t RectVsCircles(Rectangle rect, const PackedCircles* circles, float* depth) {
+    uint64_t mask = 0;
+    for (int i = 0; i < circles->count; i++) {
+        if (RectCircleLane(rect, circles, i, depth)) mask |= (uint64_t)1 << i;
+    }
+    return mask;
+}
+
+uint64_t CircleVsCircles(Vector2 centre, float radius, const PackedCircles* circles, float* depth) {
+    uint64_t mask = 0;
+    for (int i = 0; i < circles->count; i++) {
+        if (CircleCircleLane(centre, radius, circles, i, depth)) mask |= (uint64_t)1 << i;
+    }
+    return mask;
+}
+
+#endif
+
+void CirclesVsRects(const PackedCircles* circles, const PackedRects* rects, uint64_t* hits, float* depth) {
+    for (int c = 0; c < circles->count; c++) {
+        Vector2 centre = { circles->x[c], circles->y[c] };
+        hits[c] = CircleVsRects(centre, circles->radius[c], rects, depth ? depth + c * NARROW_MAX_BODIES : NULL);
+    }
+}
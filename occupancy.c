@@ -0,0 +1,146 @@
+#include "occupancy.h"
+#include "sprite_shapes.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Function to set cells from..to (inclusive) of one row
+static void FillSpan(unsigned char* row, int from, int to, unsigned char value) {
+    unsigned char* out = row + from;
+    const int length = to - from + 1;
+
+#if defined(__AVX2__)
+    if (length >= 32) {
+        const __m256i fill = _mm256_set1_epi8((char)value);
+        for (int i = 0; i + 32 < length; i += 32) _mm256_storeu_si256((__m256i*)(out + i), fill);
+        // The last store ends on the span's end, overlapping the one before it
+        _mm256_storeu_si256((__m256i*)(out + length - 32), fill);
+        return;
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (length >= 16) {
+        const __m128i fill = _mm_set1_epi8((char)value);
+        for (int i = 0; i + 16 < length; i += 16) _mm_storeu_si128((__m128i*)(out + i), fill);
+        _mm_storeu_si128((__m128i*)(out + length - 16), fill);
+        return;
+    }
+#endif
+    for (int i = 0; i < length; i++) out[i] = value;
+}
+
+// Function to fill the cells whose centres lie between x0 and x1 (in cells) on one row
+static void FillRow(OccupancyGrid* grid, int y, float x0, float x1, unsigned char kind,
+    OccupancyChannel detailChannel, unsigned char detail) {
+    int from = (int)ceilf(x0 - 0.5f);
+    int to = (int)floorf(x1 - 0.5f);
+    if (from < 0) from = 0;
+    if (to > OCCUPANCY_WIDTH - 1) to = OCCUPANCY_WIDTH - 1;
+    if (from > to) return;
+
+    // A cell holds only the details of what was drawn last
+    FillSpan(grid->cells[OCCUPANCY_KIND][y], from, to, kind);
+    for (int channel = OCCUPANCY_KIND + 1; channel < OCCUPANCY_CHANNELS; channel++) {
+        FillSpan(grid->cells[channel][y], from, to, (channel == (int)detailChannel) ? detail : 0);
+    }
+}
+
+// Function to find the rows whose centres lie between y0 and y1 (in cells)
+static bool RowRange(float y0, float y1, int* first, int* last) {
+    *first = (int)ceilf(y0 - 0.5f);
+    *last = (int)floorf(y1 - 0.5f);
+    if (*first < 0) *first = 0;
+    if (*last > OCCUPANCY_HEIGHT - 1) *last = OCCUPANCY_HEIGHT - 1;
+    return *first <= *last;
+}
+
+void ClearOccupancy(OccupancyGrid* grid) {
+    memset(grid, 0, sizeof(*grid));
+
+    int first, last;
+    if (RowRange((SCREEN_HEIGHT - GROUND_HEIGHT) / OCCUPANCY_CELL_SIZE, (float)OCCUPANCY_HEIGHT, &first, &last)) {
+        memset(grid->cells[OCCUPANCY_KIND][first], OCCUPANCY_GROUND, (size_t)(last - first + 1) * OCCUPANCY_WIDTH);
+    }
+}
+
+void RasterizeRect(OccupancyGrid* grid, Rectangle rect, float rotation, unsigned char kind, unsigned char material) {
+    const float scale = 1.0f / OCCUPANCY_CELL_SIZE;
+    const float halfWidth = rect.width * 0.5f * scale;
+    const float halfHeight = rect.height * 0.5f * scale;
+    const float cx = (rect.x + rect.width * 0.5f) * scale;
+    const float cy = (rect.y + rect.height * 0.5f) * scale;
+    const float c = cosf(rotation);
+    const float s = sinf(rotation);
+
+    // Corners in order around the rect, in cells
+    const float cornerX[4] = { -halfWidth, halfWidth, halfWidth, -halfWidth };
+    const float cornerY[4] = { -halfHeight, -halfHeight, halfHeight, halfHeight };
+    float px[4], py[4];
+    float top = INFINITY;
+    float bottom = -INFINITY;
+    for (int i = 0; i < 4; i++) {
+        px[i] = cx + cornerX[i] * c - cornerY[i] * s;
+        py[i] = cy + cornerX[i] * s + cornerY[i] * c;
+        top = fminf(top, py[i]);
+        bottom = fmaxf(bottom, py[i]);
+    }
+
+    int first, last;
+    if (!RowRange(top, bottom, &first, &last)) return;
+
+    // The rect is convex, so each scanline crosses it in one span between its two edge crossings
+    for (int y = first; y <= last; y++) {
+        const float scan = (float)y + 0.5f;
+        float left = INFINITY;
+        float right = -INFINITY;
+        for (int i = 0; i < 4; i++) {
+            int j = (i + 1) & 3;
+            if ((py[i] <= scan) == (py[j] <= scan)) continue;
+
+            float x = px[i] + (scan - py[i]) * (px[j] - px[i]) / (py[j] - py[i]);
+            left = fminf(left, x);
+            right = fmaxf(right, x);
+        }
+        if (left <= right) FillRow(grid, y, left, right, kind, OCCUPANCY_MATERIAL, material);
+    }
+}
+
+void RasterizeCircle(OccupancyGrid* grid, Vector2 centre, float radius, unsigned char kind, unsigned char health) {
+    const float scale = 1.0f / OCCUPANCY_CELL_SIZE;
+    const float cx = centre.x * scale;
+    const float cy = centre.y * scale;
+    const float r = radius * scale;
+
+    int first, last;
+    if (!RowRange(cy - r, cy + r, &first, &last)) return;
+
+    for (int y = first; y <= last; y++) {
+        float dy = (float)y + 0.5f - cy;
+        float half = sqrtf(fmaxf(r * r - dy * dy, 0.0f));
+        FillRow(grid, y, cx - half, cx + half, kind, OCCUPANCY_HEALTH, health);
+    }
+}
+
+void RasterizeWorld(OccupancyGrid* grid, const Bird* bird, const Block* blocks, int blockCount,
+    const Enemy* enemies, int enemyCount) {
+    ClearOccupancy(grid);
+
+    for (int i = 0; i < blockCount; i++) {
+        if (!blocks[i].active) continue;
+        RasterizeRect(grid, blocks[i].rect, blocks[i].rotation, OCCUPANCY_BLOCK, (unsigned char)(blocks[i].material + 1));
+    }
+    for (int i = 0; i < enemyCount; i++) {
+        if (!enemies[i].active) continue;
+
+        Vector2 centre;
+        float radius;
+        EnemyCollisionCircle(&enemies[i], &centre, &radius);
+        RasterizeCircle(grid, centre, radius, OCCUPANCY_ENEMY, (unsigned char)enemies[i].health);
+    }
+    RasterizeCircle(grid, bird->position, bird->radius, OCCUPANCY_BIRD, 0);
+}
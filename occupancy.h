@@ -0,0 +1,49 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include "game.h"
+
+// Low-resolution picture of the world drawn on the CPU, for tools that
+// have no GPU: solvers, agents, level validators. One cell is 16 x 16 px
+// of the screen; it belongs to a shape when its centre is inside it.
+#define OCCUPANCY_WIDTH 96
+#define OCCUPANCY_HEIGHT 50
+#define OCCUPANCY_CELL_SIZE ((float)SCREEN_WIDTH / OCCUPANCY_WIDTH)
+
+#if SCREEN_HEIGHT != OCCUPANCY_HEIGHT * SCREEN_WIDTH / OCCUPANCY_WIDTH
+#error "Occupancy cells must be square"
+#endif
+
+typedef enum {
+    OCCUPANCY_KIND,      // OccupancyKind of whatever was drawn last
+    OCCUPANCY_MATERIAL,  // MaterialId + 1 under blocks, 0 elsewhere
+    OCCUPANCY_HEALTH,    // health under enemies, 0 elsewhere
+    OCCUPANCY_CHANNELS
+} OccupancyChannel;
+
+typedef enum {
+    OCCUPANCY_EMPTY,
+    OCCUPANCY_GROUND,
+    OCCUPANCY_BLOCK,
+    OCCUPANCY_ENEMY,
+    OCCUPANCY_BIRD
+} OccupancyKind;
+
+// One plane per channel, rows top to bottom
+typedef struct {
+    unsigned char cells[OCCUPANCY_CHANNELS][OCCUPANCY_HEIGHT][OCCUPANCY_WIDTH];
+} OccupancyGrid;
+
+// Empty sky above the ground
+void ClearOccupancy(OccupancyGrid* grid);
+
+// Scanline fills in screen coordinates. rect is the block's unrotated
+// rect, turned by rotation radians about its centre as it is drawn.
+void RasterizeRect(OccupancyGrid* grid, Rectangle rect, float rotation, unsigned char kind, unsigned char material);
+void RasterizeCircle(OccupancyGrid* grid, Vector2 centre, float radius, unsigned char kind, unsigned char health);
+
+// Clears the grid and draws the active blocks, then enemies, then the bird
+void RasterizeWorld(OccupancyGrid* grid, const Bird* bird, const Block* blocks, int blockCount,
+    const Enemy* enemies, int enemyCount);
+
+#endif
@@ -0,0 +1,135 @@
+#include "quality.h"
+#include <stddef.h>
+
+const QualityTier qualityTiers[QUALITY_TIER_COUNT] = {
+    [QUALITY_LOW] = { "low", 25, 0.5f, 6 },
+    [QUALITY_MEDIUM] = { "medium", 50, 0.75f, 2 },
+    [QUALITY_HIGH] = { "high", 100, 1.0f, 1 },
+};
+
+void QualityInit(QualityController* quality, QualityLevel tier, bool automatic) {
+    *quality = (QualityController){ 0 };
+    quality->tier = tier;
+    quality->automatic = automatic;
+    quality->upCooldown = QUALITY_UP_COOLDOWN;
+}
+
+static void ChangeTier(QualityController* quality, QualityLevel tier) {
+    quality->lastWasUp = tier > quality->tier;
+    quality->tier = tier;
+    quality->sampleCount = 0;
+    quality->next = 0;
+    quality->sinceChange = 0.0f;
+}
+
+void QualitySetTier(QualityController* quality, QualityLevel tier, bool automatic) {
+    TraceLog(LOG_INFO, "QUALITY: Set to %s (%s)", qualityTiers[tier].name, automatic ? "automatic" : "fixed");
+    ChangeTier(quality, tier);
+    quality->automatic = automatic;
+    quality->upCooldown = QUALITY_UP_COOLDOWN;
+    quality->lastWasUp = false;
+}
+
+bool QualityObserve(QualityController* quality, float frameTime, float busyTime, bool resolutionAtMin, bool resolutionAtMax) {
+    quality->frameTimes[quality->next] = frameTime;
+    quality->busyTimes[quality->next] = busyTime;
+    quality->next = (quality->next + 1) % QUALITY_WINDOW;
+    if (quality->sampleCount < QUALITY_WINDOW) quality->sampleCount++;
+    quality->sinceChange += frameTime;
+
+    // Every tier change refills the window, so a decision only ever sees frames drawn at the current tier
+    if (!quality->automatic || quality->sampleCount < QUALITY_WINDOW) return false;
+
+    float frameSum = 0.0f;
+    float busySum = 0.0f;
+    for (int i = 0; i < QUALITY_WINDOW; i++) {
+        frameSum += quality->frameTimes[i];
+        busySum += quality->busyTimes[i];
+    }
+    const float budget = 1.0f / QUALITY_TARGET_FPS;
+    const float averageFrame = frameSum / QUALITY_WINDOW;
+    const float averageBusy = busySum / QUALITY_WINDOW;
+
+    if (averageFrame > budget * QUALITY_DOWN_RATIO && quality->tier > QUALITY_LOW &&
+        quality->sinceChange >= QUALITY_DOWN_COOLDOWN && resolutionAtMin) {
+
+        // Falling straight back after a step up means that tier doesn't hold: wait longer next time
+        if (quality->lastWasUp && quality->sinceChange < 2.0f * QUALITY_UP_COOLDOWN &&
+            quality->upCooldown < QUALITY_MAX_UP_COOLDOWN) {
+            quality->upCooldown *= 2.0f;
+            TraceLog(LOG_INFO, "QUALITY: Step up to %s didn't hold, next one waits %.0f s",
+                qualityTiers[quality->tier].name, quality->upCooldown);
+        }
+
+        TraceLog(LOG_INFO, "QUALITY: Average frame %.2f ms over the %.2f ms budget, stepping down to %s",
+            averageFrame * 1000.0f, budget * 1000.0f, qualityTiers[quality->tier - 1].name);
+        ChangeTier(quality, (QualityLevel)(quality->tier - 1));
+        return true;
+    }
+
+    if (averageBusy < budget * QUALITY_UP_RATIO && quality->tier < QUALITY_HIGH &&
+        quality->sinceChange >= quality->upCooldown && resolutionAtMax) {
+
+        TraceLog(LOG_INFO, "QUALITY: Average busy time %.2f ms leaves headroom, stepping up to %s",
+            averageBusy * 1000.0f, qualityTiers[quality->tier + 1].name);
+        ChangeTier(quality, (QualityLevel)(quality->tier + 1));
+        return true;
+    }
+
+    return false;
+}
+
+const QualityTier* QualityCurrent(const QualityController* quality) {
+    return &qualityTiers[quality->tier];
+}
+
+void LoadScaledTextures(ScaledTexture* textures, int count) {
+    for (int i = 0; i < count; i++) {
+        Image image = LoadImage(textures[i].fileName);
+        if (image.data == NULL) {
+            TraceLog(LOG_WARNING, "QUALITY: Failed to load %s", textures[i].fileName);
+            continue;
+        }
+
+        int width = (textures[i].width > 0) ? textures[i].width : image.width;
+        int height = (textures[i].height > 0) ? textures[i].height : image.height;
+
+        for (int tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+            int scaledWidth = (int)(width * qualityTiers[tier].textureScale);
+            int scaledHeight = (int)(height * qualityTiers[tier].textureScale);
+            if (scaledWidth < 1) scaledWidth = 1;
+            if (scaledHeight < 1) scaledHeight = 1;
+
+            Image scaled = ImageCopy(image);
+            if (scaledWidth != scaled.width || scaledHeight != scaled.height) {
+                ImageResize(&scaled, scaledWidth, scaledHeight);
+            }
+
+            textures[i].tiers[tier] = LoadTextureFromImage(scaled);
+            UnloadImage(scaled);
+            SetTextureFilter(textures[i].tiers[tier], TEXTURE_FILTER_BILINEAR);
+        }
+        UnloadImage(image);
+    }
+}
+
+void UnloadScaledTextures(ScaledTexture* textures, int count) {
+    for (int i = 0; i < count; i++) {
+        for (int tier = 0; tier < QUALITY_TIER_COUNT; tier++) {
+            UnloadTexture(textures[i].tiers[tier]);
+            textures[i].tiers[tier] = (Texture2D){ 0 };
+        }
+        *textures[i].texture = (Texture2D){ 0 };
+    }
+}
+
+void SelectTextureTier(const ScaledTexture* textures, int count, QualityLevel tier) {
+    for (int i = 0; i < count; i++) {
+        *textures[i].texture = textures[i].tiers[tier];
+    }
+}
+
+void DrawScaledTexture(Texture2D texture, Rectangle dest) {
+    Rectangle source = { 0.0f, 0.0f, (float)texture.width, (float)texture.height };
+    DrawTexturePro(texture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+}
@@ -0,0 +1,81 @@
+#ifndef QUALITY_H
+#define QUALITY_H
+
+#include "raylib.h"
+
+#define QUALITY_TARGET_FPS 60
+#define QUALITY_WINDOW 90            // frames averaged before any decision
+#define QUALITY_DOWN_RATIO 1.10f     // average frame time above budget * this steps down
+#define QUALITY_UP_RATIO 0.60f       // average busy time below budget * this steps up
+#define QUALITY_DOWN_COOLDOWN 1.0f   // seconds after a change before stepping down again
+#define QUALITY_UP_COOLDOWN 5.0f     // ... and before stepping up; doubled when a step up is undone
+#define QUALITY_MAX_UP_COOLDOWN 80.0f
+
+typedef enum {
+    QUALITY_LOW,
+    QUALITY_MEDIUM,
+    QUALITY_HIGH,
+    QUALITY_TIER_COUNT
+} QualityLevel;
+
+typedef struct {
+    const char* name;
+    int trajectoryDots;
+    float textureScale;  // fraction of the full-screen art's resolution kept on the GPU
+    int hudInterval;     // frames between HUD redraws
+} QualityTier;
+
+extern const QualityTier qualityTiers[QUALITY_TIER_COUNT];
+
+// Watches a rolling window of frame times and steps the tier down when the
+// frame budget is missed, and back up once frames leave plenty of headroom.
+// Frame time includes the vsync/target-FPS wait, so headroom is judged from
+// busy time: the part of the frame spent before EndDrawing().
+typedef struct {
+    QualityLevel tier;
+    bool automatic;
+    float frameTimes[QUALITY_WINDOW];
+    float busyTimes[QUALITY_WINDOW];
+    int sampleCount;
+    int next;
+    float sinceChange;  // seconds
+    float upCooldown;
+    bool lastWasUp;
+} QualityController;
+
+void QualityInit(QualityController* quality, QualityLevel tier, bool automatic);
+
+// Fixes the tier (from the settings window), or hands it back to the controller
+void QualitySetTier(QualityController* quality, QualityLevel tier, bool automatic);
+
+// Feeds one frame. Dynamic resolution answers a missed budget first, so
+// the tier only steps down once the resolution is at its lowest
+// (resolutionAtMin) and only steps up once it is back at full scale
+// (resolutionAtMax). Returns true when the tier changed.
+bool QualityObserve(QualityController* quality, float frameTime, float busyTime, bool resolutionAtMin, bool resolutionAtMax);
+
+const QualityTier* QualityCurrent(const QualityController* quality);
+
+// Full-screen art that follows the texture tier. It is always drawn
+// stretched over a fixed rectangle, so its resolution can change freely.
+// A copy per tier is uploaded at load time; decoding multi-megabyte
+// images mid-level would cause the very hitch a tier change is meant to cure.
+typedef struct {
+    const char* fileName;
+    Texture2D* texture;  // set to the current tier's copy
+    int width;           // full resolution; 0 = the file's own size
+    int height;
+    Texture2D tiers[QUALITY_TIER_COUNT];
+} ScaledTexture;
+
+// Decodes each file once and uploads it at every tier's textureScale
+void LoadScaledTextures(ScaledTexture* textures, int count);
+void UnloadScaledTextures(ScaledTexture* textures, int count);
+
+// Points each texture at its copy for tier; no loading
+void SelectTextureTier(const ScaledTexture* textures, int count, QualityLevel tier);
+
+// Draws a texture stretched over dest, whatever resolution it was loaded at
+void DrawScaledTexture(Texture2D texture, Rectangle dest);
+
+#endif
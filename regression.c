@@ -0,0 +1,477 @@
+#include "regression.h"
+#include "fixed_physics.h"
+#include "explosion.h"
+#include "level.h"
+#include "bench.h"
+#include "alloc_tracker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// Float results depend on the compiler and FPU, so their baseline is only
+// compared on the platform it was recorded on
+#if defined(_WIN32)
+#define REGRESSION_OS "windows"
+#elif defined(__APPLE__)
+#define REGRESSION_OS "macos"
+#else
+#define REGRESSION_OS "linux"
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+#define REGRESSION_PLATFORM REGRESSION_OS "-x64"
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define REGRESSION_PLATFORM REGRESSION_OS "-arm64"
+#else
+#define REGRESSION_PLATFORM REGRESSION_OS "-other"
+#endif
+
+// Game-side state and listeners from FileName.c, so the float replay resolves
+// damage and score exactly as it does in the game
+extern EventQueue gameEvents;
+void ResolveCombatEvents(const GameEvent* events, int count, void* userData);
+void ApplyScoreEvents(const GameEvent* events, int count, void* userData);
+
+typedef struct {
+    unsigned long long hash;
+    int score;
+    int killed;
+    unsigned int steps;
+    double p50;  // step time, ns
+    double p99;
+} LevelOutcome;
+
+typedef struct {
+    int level;
+    bool hasShots;
+    Replay shots;
+
+    LevelOutcome result;
+    bool deterministic;  // every repeat ended with the same hash
+    long long* stepTimes;
+
+    bool hasBaseline;
+    LevelOutcome baseline;
+
+    // The same shots through UpdateWorld, the path non-fixed-point builds play
+    LevelOutcome floatResult;
+    bool floatDeterministic;
+    bool hasFloatBaseline;
+    char floatPlatform[32];  // of the baseline
+    LevelOutcome floatBaseline;
+} LevelRun;
+
+static LevelRun runs[MAX_LEVELS];
+static int runCount = 0;
+static atomic_int nextRun;
+
+static int CompareTimes(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Function to sort a level's step times and take their percentiles
+static void TakePercentiles(long long* times, size_t count, LevelOutcome* outcome) {
+    if (count == 0) return;
+
+    qsort(times, count, sizeof(long long), CompareTimes);
+    outcome->p50 = (double)times[(count - 1) / 2];
+    outcome->p99 = (double)times[(count - 1) * 99 / 100];
+}
+
+// Runs on a worker: replays one level REGRESSION_REPEATS times
+static void ReplayLevel(LevelRun* run) {
+    const LevelData* level = GetLevelData(run->level);
+    const unsigned int steps = run->shots.steps;
+    FixedWorld world;
+
+    run->deterministic = true;
+
+    for (int repeat = 0; repeat < REGRESSION_REPEATS; repeat++) {
+        FixedWorldLoadLevel(&world, level, run->shots.seed);
+        long long* times = run->stepTimes + (size_t)repeat * steps;
+
+        int nextShot = 0;
+        for (unsigned int step = 0; step < steps; step++) {
+            long long start = BenchNow();
+            StepReplay(&run->shots, &world, &nextShot);
+            times[step] = BenchNow() - start;
+        }
+
+        unsigned long long hash = FixedWorldHash(&world);
+        if (repeat > 0 && hash != run->result.hash) run->deterministic = false;
+
+        run->result.hash = hash;
+        run->result.score = world.score;
+        run->result.killed = world.enemiesKilled;
+        run->result.steps = world.step;
+    }
+
+    TakePercentiles(run->stepTimes, (size_t)steps * REGRESSION_REPEATS, &run->result);
+}
+
+static unsigned long long HashBytes(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static unsigned long long HashFloat(unsigned long long hash, float value) {
+    return HashBytes(hash, &value, sizeof(value));
+}
+
+static unsigned long long HashInt(unsigned long long hash, int value) {
+    return HashBytes(hash, &value, sizeof(value));
+}
+
+// Function to hash the float world field by field (FNV-1a), the way FixedWorldHash() does the fixed one
+static unsigned long long FloatWorldHash(const Bird* bird, int score, int lives, bool gameOver) {
+    unsigned long long hash = 14695981039346656037ull;
+
+    hash = HashFloat(hash, bird->position.x);
+    hash = HashFloat(hash, bird->position.y);
+    hash = HashFloat(hash, bird->velocity.x);
+    hash = HashFloat(hash, bird->velocity.y);
+    hash = HashInt(hash, bird->launched);
+
+    for (int i = 0; i < blockCount; i++) {
+        const Block* block = &blocks[i];
+        hash = HashFloat(hash, block->rect.x);
+        hash = HashFloat(hash, block->rect.y);
+        hash = HashFloat(hash, block->velocity.x);
+        hash = HashFloat(hash, block->velocity.y);
+        hash = HashFloat(hash, block->rotation);
+        hash = HashInt(hash, block->active | (block->falling << 1) | (block->onGround << 2));
+    }
+
+    for (int i = 0; i < enemyCount; i++) {
+        const Enemy* enemy = &enemies[i];
+        hash = HashFloat(hash, enemy->position.x);
+        hash = HashFloat(hash, enemy->position.y);
+        hash = HashFloat(hash, enemy->velocity.y);
+        hash = HashInt(hash, enemy->health);
+        hash = HashInt(hash, (int)TimerRemaining(&gameTimers, enemy->hitCooldown));
+        hash = HashInt(hash, enemy->active | (enemy->falling << 1) | (enemy->landed << 2));
+    }
+
+    for (int i = 0; i < jointCount; i++) {
+        hash = HashInt(hash, joints[i].broken);
+    }
+
+    hash = HashInt(hash, score);
+    hash = HashInt(hash, lives);
+    hash = HashInt(hash, gameOver);
+    return hash;
+}
+
+// Function to replay one level on the float path REGRESSION_REPEATS times.
+// That world is the game's globals, so levels run one after another on
+// the calling thread, once the fixed-point workers are done.
+static void ReplayFloatLevel(LevelRun* run) {
+    const unsigned int steps = run->shots.steps;
+    int score = 0;
+
+    ClearEventListeners();
+    EventQueueInit(&gameEvents);
+    AddEventListener(ResolveCombatEvents, NULL);
+    AddEventListener(ApplyScoreEvents, &score);
+    AddEventListener(TriggerExplosives, NULL);
+
+    run->floatDeterministic = true;
+
+    for (int repeat = 0; repeat < REGRESSION_REPEATS; repeat++) {
+        Bird bird = { { 150.0f, 400.0f }, { 0.0f, 0.0f }, false, 15.0f };
+        int lives = 3;
+        bool gameOver = false;
+        bool victory = false;
+        score = 0;
+
+        SeedGameRandom(run->shots.seed);
+        InitializeEnemies(run->level);
+        InitializeBlocks(run->level);
+        ClearExplosions();
+        long long* times = run->stepTimes + (size_t)repeat * steps;
+
+        // Launched from the same whole pixels as FixedWorldLaunch()
+        int nextShot = 0;
+        for (unsigned int step = 0; step < steps; step++) {
+            if (nextShot < run->shots.shotCount && run->shots.shots[nextShot].step == step) {
+                if (!bird.launched) {
+                    bird.position = (Vector2){ (float)run->shots.shots[nextShot].pullX, (float)run->shots.shots[nextShot].pullY };
+                    bird.velocity = (Vector2){ (150.0f - bird.position.x) * 0.2f, (400.0f - bird.position.y) * 0.2f };
+                    bird.launched = true;
+                }
+                nextShot++;
+            }
+
+            long long start = BenchNow();
+            UpdateWorld(&bird, &lives, &gameOver, &victory, 1.0f / 60.0f);
+            times[step] = BenchNow() - start;
+        }
+
+        int killed = 0;
+        for (int i = 0; i < enemyCount; i++) {
+            if (!enemies[i].active) killed++;
+        }
+
+        unsigned long long hash = FloatWorldHash(&bird, score, lives, gameOver);
+        if (repeat > 0 && hash != run->floatResult.hash) run->floatDeterministic = false;
+
+        run->floatResult.hash = hash;
+        run->floatResult.score = score;
+        run->floatResult.killed = killed;
+        run->floatResult.steps = steps;
+    }
+    ClearEventListeners();
+
+    TakePercentiles(run->stepTimes, (size_t)steps * REGRESSION_REPEATS, &run->floatResult);
+}
+
+static void RunPendingLevels(void) {
+    for (;;) {
+        int index = atomic_fetch_add(&nextRun, 1);
+        if (index >= runCount) break;
+        if (runs[index].hasShots) ReplayLevel(&runs[index]);
+    }
+}
+
+#ifndef _WIN32
+
+#include <pthread.h>
+#include <unistd.h>
+
+static void* RegressionWorker(void* argument) {
+    RunPendingLevels();
+    return NULL;
+}
+
+// Function to run every level on a thread-per-core pool
+static void RunAllLevels(void) {
+    pthread_t workers[MAX_LEVELS];
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int workerCount = (cores < 1) ? 1 : (cores > runCount ? runCount : (int)cores);
+    int started = 0;
+
+    for (int i = 0; i < workerCount; i++) {
+        if (pthread_create(&workers[started], NULL, RegressionWorker, NULL) == 0) started++;
+    }
+
+    RunPendingLevels();
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+}
+
+#else
+
+static void RunAllLevels(void) {
+    RunPendingLevels();
+}
+
+#endif
+
+// Function to read a report written by WriteReport() back in (one level per line)
+static void LoadBaseline(const char* fileName) {
+    FILE* file = fopen(fileName, "r");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "REGRESS: No baseline at %s, outcomes can't be compared", fileName);
+        return;
+    }
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        const char* entry = strstr(line, "{\"level\":");
+        if (entry == NULL) continue;
+
+        int level = 0;
+        LevelOutcome outcome = { 0 };
+        if (sscanf(entry, "{\"level\": %d, \"score\": %d, \"killed\": %d, \"hash\": \"%llx\", \"steps\": %u, "
+            "\"p50_ns\": %lf, \"p99_ns\": %lf", &level, &outcome.score, &outcome.killed, &outcome.hash,
+            &outcome.steps, &outcome.p50, &outcome.p99) != 7) continue;
+
+        // The float path's outcome, recorded on one platform
+        char platform[32] = "";
+        LevelOutcome floatOutcome = { 0 };
+        const char* floatEntry = strstr(entry, "\"float\": {");
+        bool hasFloat = floatEntry != NULL &&
+            sscanf(floatEntry, "\"float\": {\"platform\": \"%31[^\"]\", \"score\": %d, \"killed\": %d, \"hash\": \"%llx\", "
+            "\"steps\": %u, \"p50_ns\": %lf, \"p99_ns\": %lf", platform, &floatOutcome.score, &floatOutcome.killed,
+            &floatOutcome.hash, &floatOutcome.steps, &floatOutcome.p50, &floatOutcome.p99) == 7;
+
+        for (int i = 0; i < runCount; i++) {
+            if (runs[i].level == level) {
+                runs[i].baseline = outcome;
+                runs[i].hasBaseline = true;
+                if (hasFloat) {
+                    runs[i].floatBaseline = floatOutcome;
+                    runs[i].hasFloatBaseline = true;
+                    snprintf(runs[i].floatPlatform, sizeof(runs[i].floatPlatform), "%s", platform);
+                }
+            }
+        }
+    }
+    fclose(file);
+}
+
+static bool ResultChanged(const LevelOutcome* result, const LevelOutcome* baseline) {
+    return result->score != baseline->score || result->killed != baseline->killed ||
+        result->hash != baseline->hash || result->steps != baseline->steps;
+}
+
+static bool OutcomeChanged(const LevelRun* run) {
+    return ResultChanged(&run->result, &run->baseline);
+}
+
+// Only a baseline recorded on this platform says anything about the float path
+static bool FloatBaselineApplies(const LevelRun* run) {
+    return run->hasFloatBaseline && strcmp(run->floatPlatform, REGRESSION_PLATFORM) == 0;
+}
+
+static bool WriteReport(const char* fileName, bool withBaseline) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "REGRESS: Failed to write %s", fileName);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"repeats\": %d,\n  \"levels\": [\n", REGRESSION_REPEATS);
+    for (int i = 0; i < runCount; i++) {
+        const LevelRun* run = &runs[i];
+        const char* separator = (i + 1 < runCount) ? "," : "";
+
+        if (!run->hasShots) {
+            fprintf(file, "    {\"level\": %d, \"error\": \"missing %s\"}%s\n", run->level,
+                TextFormat("level%d.shots", run->level), separator);
+            continue;
+        }
+
+        fprintf(file, "    {\"level\": %d, \"score\": %d, \"killed\": %d, \"hash\": \"%016llx\", \"steps\": %u, "
+            "\"p50_ns\": %.0f, \"p99_ns\": %.0f, \"deterministic\": %s",
+            run->level, run->result.score, run->result.killed, run->result.hash, run->result.steps,
+            run->result.p50, run->result.p99, run->deterministic ? "true" : "false");
+
+        if (withBaseline && run->hasBaseline) {
+            fprintf(file, ", \"outcome_changed\": %s, \"p50_ratio\": %.2f, \"p99_ratio\": %.2f",
+                OutcomeChanged(run) ? "true" : "false",
+                run->result.p50 / (run->baseline.p50 > 0.0 ? run->baseline.p50 : 1.0),
+                run->result.p99 / (run->baseline.p99 > 0.0 ? run->baseline.p99 : 1.0));
+        }
+        else if (withBaseline) {
+            fprintf(file, ", \"baseline\": null");
+        }
+
+        fprintf(file, ", \"float\": {\"platform\": \"%s\", \"score\": %d, \"killed\": %d, \"hash\": \"%016llx\", "
+            "\"steps\": %u, \"p50_ns\": %.0f, \"p99_ns\": %.0f, \"deterministic\": %s",
+            REGRESSION_PLATFORM, run->floatResult.score, run->floatResult.killed, run->floatResult.hash,
+            run->floatResult.steps, run->floatResult.p50, run->floatResult.p99,
+            run->floatDeterministic ? "true" : "false");
+
+        if (withBaseline && FloatBaselineApplies(run)) {
+            fprintf(file, ", \"outcome_changed\": %s, \"p50_ratio\": %.2f, \"p99_ratio\": %.2f",
+                ResultChanged(&run->floatResult, &run->floatBaseline) ? "true" : "false",
+                run->floatResult.p50 / (run->floatBaseline.p50 > 0.0 ? run->floatBaseline.p50 : 1.0),
+                run->floatResult.p99 / (run->floatBaseline.p99 > 0.0 ? run->floatBaseline.p99 : 1.0));
+        }
+        else if (withBaseline) {
+            fprintf(file, ", \"baseline\": null");
+        }
+        fprintf(file, "}}%s\n", separator);
+    }
+    fprintf(file, "  ]\n}\n");
+
+    fclose(file);
+    return true;
+}
+
+int RunRegression(const char* reportFile, bool updateBaseline) {
+    // Levels and shots are loaded up front; the workers only read them
+    runCount = 0;
+    for (int level = 1; level <= totalLevels && runCount < MAX_LEVELS; level++) {
+        LevelRun* run = &runs[runCount++];
+        memset(run, 0, sizeof(*run));
+        run->level = level;
+
+        GetLevelData(level);
+        run->hasShots = LoadReplay(TextFormat("level%d.shots", level), &run->shots) && run->shots.level == level;
+        if (run->hasShots) {
+            run->stepTimes = (long long*)GAME_ALLOC(ALLOC_CORE, sizeof(long long) * run->shots.steps * REGRESSION_REPEATS);
+            run->hasShots = (run->stepTimes != NULL);
+        }
+    }
+
+    if (!updateBaseline) LoadBaseline(REGRESSION_BASELINE_FILE);
+
+    atomic_store(&nextRun, 0);
+    RunAllLevels();
+
+    // The float world is the game's globals: one level at a time, on this thread
+    for (int i = 0; i < runCount; i++) {
+        if (runs[i].hasShots) ReplayFloatLevel(&runs[i]);
+    }
+
+    bool failed = false;
+    for (int i = 0; i < runCount; i++) {
+        const LevelRun* run = &runs[i];
+
+        if (!run->hasShots) {
+            printf("level %d: no usable level%d.shots\n", run->level, run->level);
+            failed = true;
+            continue;
+        }
+
+        printf("level %d: score %d, killed %d, hash %016llx, %u steps, p50 %.0f ns, p99 %.0f ns",
+            run->level, run->result.score, run->result.killed, run->result.hash, run->result.steps,
+            run->result.p50, run->result.p99);
+
+        if (!run->deterministic) {
+            printf(" NONDETERMINISTIC");
+            failed = true;
+        }
+        if (!updateBaseline && run->hasBaseline) {
+            if (OutcomeChanged(run)) {
+                printf(" CHANGED (baseline score %d, killed %d, hash %016llx)",
+                    run->baseline.score, run->baseline.killed, run->baseline.hash);
+                failed = true;
+            }
+            if (run->result.p99 > run->baseline.p99 * REGRESSION_SLOWER_RATIO) {
+                printf(" slower (baseline p99 %.0f ns)", run->baseline.p99);
+            }
+        }
+        printf("\n");
+
+        printf("level %d float: score %d, killed %d, hash %016llx, %u steps, p50 %.0f ns, p99 %.0f ns",
+            run->level, run->floatResult.score, run->floatResult.killed, run->floatResult.hash,
+            run->floatResult.steps, run->floatResult.p50, run->floatResult.p99);
+
+        if (!run->floatDeterministic) {
+            printf(" NONDETERMINISTIC");
+            failed = true;
+        }
+        if (!updateBaseline && FloatBaselineApplies(run)) {
+            if (ResultChanged(&run->floatResult, &run->floatBaseline)) {
+                printf(" CHANGED (baseline score %d, killed %d, hash %016llx)",
+                    run->floatBaseline.score, run->floatBaseline.killed, run->floatBaseline.hash);
+                failed = true;
+            }
+            if (run->floatResult.p99 > run->floatBaseline.p99 * REGRESSION_SLOWER_RATIO) {
+                printf(" slower (baseline p99 %.0f ns)", run->floatBaseline.p99);
+            }
+        }
+        else if (!updateBaseline && run->hasFloatBaseline) {
+            printf(" (baseline is from %s, not compared)", run->floatPlatform);
+        }
+        printf("\n");
+    }
+
+    if (!WriteReport(reportFile, !updateBaseline)) failed = true;
+
+    for (int i = 0; i < runCount; i++) {
+        GAME_FREE(runs[i].stepTimes);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include <stdbool.h>
+
+#define REGRESSION_BASELINE_FILE "regression_baseline.json"
+#define REGRESSION_REPEATS 5         // replays per level, for stable step timings
+#define REGRESSION_SLOWER_RATIO 1.5  // p99 above baseline * this is flagged
+
+// Replays levelN.shots for every level on the fixed-point path, one worker
+// per core, then on the float path the game plays, one level at a time on
+// the calling thread (that world is global). Writes a JSON report with
+// score, kills, world hash, step count and p50/p99 step time per level and
+// path. Outcomes are compared against REGRESSION_BASELINE_FILE, the float
+// ones only when the baseline was recorded on the same platform; returns
+// non-zero when one changed. With updateBaseline the report is written as
+// the new baseline instead.
+int RunRegression(const char* reportFile, bool updateBaseline);
+
+#endif
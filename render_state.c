@@ -0,0 +1,31 @@
+#include "render_state.h"
+#include <string.h>
+
+#define RENDER_BUFFER_FRESH 4u
+#define RENDER_BUFFER_INDEX 3u
+
+void RenderBufferInit(RenderBuffer* buffer) {
+    memset(buffer->slots, 0, sizeof(buffer->slots));
+    buffer->front = 0;
+    buffer->back = 1;
+    atomic_init(&buffer->middle, 2u);
+}
+
+RenderSnapshot* RenderBufferBack(RenderBuffer* buffer) {
+    return &buffer->slots[buffer->back];
+}
+
+void RenderBufferPublish(RenderBuffer* buffer) {
+    // Release: the slot contents must be visible before the reader can take it
+    unsigned int previous = atomic_exchange_explicit(&buffer->middle, buffer->back | RENDER_BUFFER_FRESH,
+        memory_order_acq_rel);
+    buffer->back = previous & RENDER_BUFFER_INDEX;
+}
+
+const RenderSnapshot* RenderBufferLatest(RenderBuffer* buffer) {
+    if (atomic_load_explicit(&buffer->middle, memory_order_relaxed) & RENDER_BUFFER_FRESH) {
+        unsigned int previous = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+        buffer->front = previous & RENDER_BUFFER_INDEX;
+    }
+    return &buffer->slots[buffer->front];
+}
@@ -0,0 +1,87 @@
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include "game.h"
+#include "explosion.h"
+#include <stdatomic.h>
+
+#define RENDER_SPRITE_TNT 2
+
+typedef struct {
+    Rectangle rect;
+    float rotation;
+    unsigned char sprite; // which block texture to draw, RENDER_SPRITE_TNT for explosives
+    bool active;
+} RenderBlock;
+
+// An unbroken joint, from its anchor on block A to its anchor on B (or the world)
+typedef struct {
+    Vector2 from;
+    Vector2 to;
+    unsigned char type;  // JointType
+} RenderJoint;
+
+typedef struct {
+    Vector2 position;
+    int health;
+    int maxHealth;
+    bool active;
+    float radius;
+} RenderEnemy;
+
+// Everything the main thread needs to draw one frame. Written by the
+// simulation, never modified after it is published.
+typedef struct {
+    unsigned int frame;
+    Bird bird;
+    bool dragging;
+    float aimHitTime;  // preview time at which the launch arc meets a body
+    int blockCount;
+    int enemyCount;
+    RenderBlock blocks[MAX_BLOCKS];
+    RenderEnemy enemies[MAX_ENEMIES];
+    int jointCount;
+    RenderJoint joints[MAX_JOINTS];
+    int flashCount;
+    ExplosionFlash flashes[MAX_EXPLOSION_FLASHES];
+
+    // The other player's world in a two-player session, when they are on this level
+    bool ghostVisible;
+    int ghostScore;
+    Bird ghostBird;
+    int ghostBlockCount;
+    int ghostEnemyCount;
+    RenderBlock ghostBlocks[MAX_BLOCKS];
+    RenderEnemy ghostEnemies[MAX_ENEMIES];
+
+    // HUD
+    int score;
+    int lives;
+    int level;
+    unsigned int simStep;
+    bool gameOver;
+    bool victory;
+    bool levelComplete;
+    bool scrubbing;
+    bool settled;  // nothing moves until the player acts
+} RenderSnapshot;
+
+// Lock-free triple buffer with one writer and one reader: the writer
+// fills its back slot and swaps it with the middle one, the reader swaps
+// its front slot with the middle one when something new was published.
+// Neither side ever waits, and the reader always gets the newest frame.
+typedef struct {
+    RenderSnapshot slots[3];
+    atomic_uint middle;  // slot index, plus a fresh bit until the reader takes it
+    unsigned int back;   // owned by the writer
+    unsigned int front;  // owned by the reader
+} RenderBuffer;
+
+void RenderBufferInit(RenderBuffer* buffer);
+
+RenderSnapshot* RenderBufferBack(RenderBuffer* buffer);
+void RenderBufferPublish(RenderBuffer* buffer);
+
+const RenderSnapshot* RenderBufferLatest(RenderBuffer* buffer);
+
+#endif
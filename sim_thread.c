@@ -0,0 +1,111 @@
+#include "sim_thread.h"
+#include <stddef.h>
+
+static SimFrameFunction frameFunction = NULL;
+static void* frameUserData = NULL;
+
+#ifndef _WIN32
+
+#include <pthread.h>
+
+static pthread_t simThread;
+static pthread_mutex_t simLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t simWake = PTHREAD_COND_INITIALIZER;  // input posted, or stopping
+static pthread_cond_t simDone = PTHREAD_COND_INITIALIZER;  // input taken, or frame finished
+
+static SimInput mailbox;
+static bool mailboxFull = false;
+static bool simBusy = false;
+static bool stopping = false;
+static bool running = false;
+
+static void* SimThreadMain(void* argument) {
+    pthread_mutex_lock(&simLock);
+    for (;;) {
+        while (!mailboxFull && !stopping) pthread_cond_wait(&simWake, &simLock);
+        if (stopping && !mailboxFull) break;
+
+        SimInput input = mailbox;
+        mailboxFull = false;
+        simBusy = true;
+        pthread_cond_broadcast(&simDone);
+        pthread_mutex_unlock(&simLock);
+
+        frameFunction(&input, frameUserData);
+
+        pthread_mutex_lock(&simLock);
+        simBusy = false;
+        pthread_cond_broadcast(&simDone);
+    }
+    pthread_mutex_unlock(&simLock);
+    return NULL;
+}
+
+bool SimThreadStart(SimFrameFunction frame, void* userData) {
+    frameFunction = frame;
+    frameUserData = userData;
+    stopping = false;
+
+    if (pthread_create(&simThread, NULL, SimThreadMain, NULL) != 0) {
+        TraceLog(LOG_WARNING, "SIM: Failed to start simulation thread, running frames inline");
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+void SimThreadStop(void) {
+    if (!running) return;
+
+    pthread_mutex_lock(&simLock);
+    stopping = true;
+    pthread_cond_broadcast(&simWake);
+    pthread_mutex_unlock(&simLock);
+
+    pthread_join(simThread, NULL);
+    running = false;
+}
+
+void SimThreadPost(const SimInput* input) {
+    if (!running) {
+        frameFunction(input, frameUserData);
+        return;
+    }
+
+    pthread_mutex_lock(&simLock);
+    while (mailboxFull) pthread_cond_wait(&simDone, &simLock);
+    mailbox = *input;
+    mailboxFull = true;
+    pthread_cond_signal(&simWake);
+    pthread_mutex_unlock(&simLock);
+}
+
+void SimThreadWaitIdle(void) {
+    if (!running) return;
+
+    pthread_mutex_lock(&simLock);
+    while (mailboxFull || simBusy) pthread_cond_wait(&simDone, &simLock);
+    pthread_mutex_unlock(&simLock);
+}
+
+#else
+
+// No worker thread on Windows builds: each frame runs inside SimThreadPost()
+
+bool SimThreadStart(SimFrameFunction frame, void* userData) {
+    frameFunction = frame;
+    frameUserData = userData;
+    return false;
+}
+
+void SimThreadStop(void) {
+}
+
+void SimThreadPost(const SimInput* input) {
+    frameFunction(input, frameUserData);
+}
+
+void SimThreadWaitIdle(void) {
+}
+
+#endif
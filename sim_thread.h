@@ -0,0 +1,34 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "raylib.h"
+
+// One frame of player input, captured on the main thread. raylib's input
+// state is only valid there, so the simulation never calls IsKeyPressed().
+typedef struct {
+    float deltaTime;
+    Vector2 mouse;
+    bool mousePressed;
+    bool mouseReleased;
+    bool undo;        // U
+    bool scrubLeft;   // LEFT held
+    bool scrubRight;  // RIGHT held
+    bool resume;      // SPACE
+} SimInput;
+
+typedef void (*SimFrameFunction)(const SimInput* input, void* userData);
+
+// Runs frame() for each posted input on a simulation thread, one frame
+// behind the main thread. Without thread support frames run inline.
+bool SimThreadStart(SimFrameFunction frame, void* userData);
+void SimThreadStop(void);
+
+// Hands the next frame's input over; waits only while the previous one
+// hasn't been picked up yet, so the simulation stays at most a frame behind
+void SimThreadPost(const SimInput* input);
+
+// Waits until every posted frame has finished, after which the main thread
+// may touch the world directly (level changes, resets)
+void SimThreadWaitIdle(void);
+
+#endif
@@ -0,0 +1,233 @@
+#include "snapshot.h"
+#include <string.h>
+
+#define MIN_ZERO_RUN 4 // shorter unchanged gaps stay inside a literal run
+
+void CaptureWorld(WorldSnapshot* snapshot, const Bird* bird, int score, int lives, bool gameOver, unsigned int step) {
+    // Zero first so padding bytes don't show up in the deltas
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    snapshot->step = step;
+    snapshot->rngState = gameRngState;
+    snapshot->score = score;
+    snapshot->lives = lives;
+    snapshot->gameOver = gameOver;
+    snapshot->bird = *bird;
+    snapshot->blockCount = blockCount;
+    snapshot->enemyCount = enemyCount;
+    memcpy(snapshot->blocks, blocks, sizeof(Block) * blockCount);
+    memcpy(snapshot->enemies, enemies, sizeof(Enemy) * enemyCount);
+    snapshot->jointCount = jointCount;
+    memcpy(snapshot->joints, joints, sizeof(Joint) * jointCount);
+    snapshot->timers = gameTimers;
+}
+
+void RestoreWorld(const WorldSnapshot* snapshot, Bird* bird, int* score, int* lives, bool* gameOver, unsigned int* step) {
+    *step = snapshot->step;
+    gameRngState = snapshot->rngState;
+    *score = snapshot->score;
+    *lives = snapshot->lives;
+    *gameOver = snapshot->gameOver;
+    *bird = snapshot->bird;
+    blockCount = snapshot->blockCount;
+    enemyCount = snapshot->enemyCount;
+    memcpy(blocks, snapshot->blocks, sizeof(Block) * blockCount);
+    memcpy(enemies, snapshot->enemies, sizeof(Enemy) * enemyCount);
+    jointCount = snapshot->jointCount;
+    memcpy(joints, snapshot->joints, sizeof(Joint) * jointCount);
+    gameTimers = snapshot->timers;
+}
+
+// Function to encode (current XOR base) as [zero run][literal length][literal bytes]...
+// Returns the encoded size, or 0 if it wouldn't be smaller than a keyframe.
+static unsigned int EncodeDelta(const unsigned char* base, const unsigned char* current, unsigned char* out) {
+    const unsigned int size = sizeof(WorldSnapshot);
+    unsigned int in = 0;
+    unsigned int written = 0;
+
+    while (in < size) {
+        unsigned int zeroStart = in;
+        while (in < size && in - zeroStart < 0xFFFF && base[in] == current[in]) in++;
+        unsigned short zeroRun = (unsigned short)(in - zeroStart);
+
+        // Extend the literal until MIN_ZERO_RUN unchanged bytes in a row
+        unsigned int literalStart = in;
+        unsigned int unchanged = 0;
+        while (in < size && in - literalStart < 0xFFFF && unchanged < MIN_ZERO_RUN) {
+            unchanged = (base[in] == current[in]) ? unchanged + 1 : 0;
+            in++;
+        }
+        if (unchanged == MIN_ZERO_RUN) in -= MIN_ZERO_RUN;
+        unsigned short literalLength = (unsigned short)(in - literalStart);
+
+        if (written + 4 + literalLength >= size) return 0;
+
+        memcpy(out + written, &zeroRun, 2);
+        memcpy(out + written + 2, &literalLength, 2);
+        written += 4;
+        for (unsigned int i = 0; i < literalLength; i++) {
+            out[written++] = base[literalStart + i] ^ current[literalStart + i];
+        }
+    }
+    return written;
+}
+
+static void ApplyDelta(unsigned char* target, const unsigned char* delta, unsigned int deltaSize) {
+    unsigned int position = 0;
+    unsigned int read = 0;
+
+    while (read + 4 <= deltaSize) {
+        unsigned short zeroRun, literalLength;
+        memcpy(&zeroRun, delta + read, 2);
+        memcpy(&literalLength, delta + read + 2, 2);
+        read += 4;
+
+        position += zeroRun;
+        for (unsigned int i = 0; i < literalLength; i++) {
+            target[position++] ^= delta[read++];
+        }
+    }
+}
+
+static SnapshotRecord* RecordAt(SnapshotRing* ring, int sequence) {
+    return &ring->records[sequence % MAX_SNAPSHOTS];
+}
+
+static const SnapshotRecord* RecordAtConst(const SnapshotRing* ring, int sequence) {
+    return &ring->records[sequence % MAX_SNAPSHOTS];
+}
+
+void SnapshotRingClear(SnapshotRing* ring) {
+    ring->writeOffset = 0;
+    ring->first = 0;
+    ring->count = 0;
+    ring->sinceKeyframe = 0;
+}
+
+static void EvictOldest(SnapshotRing* ring) {
+    ring->first++;
+    ring->count--;
+
+    // Deltas whose keyframe is gone can't be decoded any more
+    while (ring->count > 0 && !RecordAt(ring, ring->first)->isKeyframe) {
+        ring->first++;
+        ring->count--;
+    }
+}
+
+// Function to reserve arena space for a record, evicting whatever it overlaps
+static unsigned int ReserveArena(SnapshotRing* ring, unsigned int size) {
+    if (ring->writeOffset + size > SNAPSHOT_ARENA_SIZE) {
+        ring->writeOffset = 0;
+    }
+
+    unsigned int start = ring->writeOffset;
+    unsigned int end = start + size;
+
+    while (ring->count > 0) {
+        const SnapshotRecord* oldest = RecordAt(ring, ring->first);
+        bool overlaps = oldest->offset < end && start < oldest->offset + oldest->size;
+        if (!overlaps && ring->count < MAX_SNAPSHOTS) break;
+        EvictOldest(ring);
+    }
+
+    ring->writeOffset = end;
+    return start;
+}
+
+void SnapshotRingPush(SnapshotRing* ring, const WorldSnapshot* snapshot, unsigned char flags) {
+    static unsigned char deltaBuffer[sizeof(WorldSnapshot)];
+    unsigned int deltaSize = 0;
+
+    int newest = SnapshotRingNewest(ring);
+    int keyframe = (newest >= 0) ? RecordAt(ring, newest)->keyframe : -1;
+    bool keyframeAlive = keyframe >= ring->first && ring->count > 0;
+
+    if (keyframeAlive && ring->sinceKeyframe < SNAPSHOT_KEYFRAME_INTERVAL) {
+        deltaSize = EncodeDelta((const unsigned char*)&ring->keyframe, (const unsigned char*)snapshot, deltaBuffer);
+    }
+
+    bool isKeyframe = (deltaSize == 0);
+    unsigned int size = isKeyframe ? (unsigned int)sizeof(WorldSnapshot) : deltaSize;
+    unsigned int offset = ReserveArena(ring, size);
+
+    // Making room may have evicted the keyframe this delta was encoded against
+    if (!isKeyframe && (ring->count == 0 || keyframe < ring->first)) {
+        isKeyframe = true;
+        size = sizeof(WorldSnapshot);
+        offset = ReserveArena(ring, size);
+    }
+
+    int sequence = ring->first + ring->count;
+
+    if (isKeyframe) {
+        memcpy(ring->arena + offset, snapshot, size);
+        ring->keyframe = *snapshot;
+        ring->sinceKeyframe = 0;
+        keyframe = sequence;
+    }
+    else {
+        memcpy(ring->arena + offset, deltaBuffer, size);
+        ring->sinceKeyframe++;
+    }
+
+    SnapshotRecord* record = RecordAt(ring, sequence);
+    record->offset = offset;
+    record->size = size;
+    record->step = snapshot->step;
+    record->keyframe = keyframe;
+    record->flags = flags;
+    record->isKeyframe = isKeyframe;
+    ring->count++;
+}
+
+int SnapshotRingOldest(const SnapshotRing* ring) {
+    return (ring->count > 0) ? ring->first : -1;
+}
+
+int SnapshotRingNewest(const SnapshotRing* ring) {
+    return (ring->count > 0) ? ring->first + ring->count - 1 : -1;
+}
+
+int SnapshotRingFindShotStart(const SnapshotRing* ring, int before) {
+    int newest = SnapshotRingNewest(ring);
+    if (before > newest) before = newest;
+
+    for (int sequence = before; sequence >= ring->first && sequence >= 0; sequence--) {
+        if (RecordAtConst(ring, sequence)->flags & SNAPSHOT_SHOT_START) return sequence;
+    }
+    return -1;
+}
+
+bool SnapshotRingGet(const SnapshotRing* ring, int sequence, WorldSnapshot* out) {
+    if (ring->count == 0 || sequence < ring->first || sequence > SnapshotRingNewest(ring)) return false;
+
+    const SnapshotRecord* record = RecordAtConst(ring, sequence);
+    const SnapshotRecord* keyframe = RecordAtConst(ring, record->keyframe);
+
+    memcpy(out, ring->arena + keyframe->offset, sizeof(WorldSnapshot));
+    if (!record->isKeyframe) {
+        ApplyDelta((unsigned char*)out, ring->arena + record->offset, record->size);
+    }
+    return true;
+}
+
+void SnapshotRingTruncate(SnapshotRing* ring, int sequence) {
+    int newest = SnapshotRingNewest(ring);
+    if (newest < 0 || sequence >= newest) return;
+
+    if (sequence < ring->first) {
+        SnapshotRingClear(ring);
+        return;
+    }
+
+    ring->count = sequence - ring->first + 1;
+
+    const SnapshotRecord* last = RecordAt(ring, sequence);
+    ring->writeOffset = last->offset + last->size;
+
+    // Keep delta-encoding against the keyframe the new newest record uses
+    const SnapshotRecord* keyframe = RecordAt(ring, last->keyframe);
+    memcpy(&ring->keyframe, ring->arena + keyframe->offset, sizeof(WorldSnapshot));
+    ring->sinceKeyframe = sequence - last->keyframe;
+}
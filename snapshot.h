@@ -0,0 +1,68 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "game.h"
+
+#define SNAPSHOT_INTERVAL 4           // steps between automatic captures
+#define SNAPSHOT_KEYFRAME_INTERVAL 16 // captures between full keyframes
+#define SNAPSHOT_ARENA_SIZE (256 * 1024)
+#define MAX_SNAPSHOTS 1024
+
+#define SNAPSHOT_SHOT_START 1 // captured right before a launch
+
+// Everything the simulation needs to continue from a given step
+typedef struct {
+    unsigned int step;
+    unsigned int rngState;
+    int score;
+    int lives;
+    bool gameOver;
+    Bird bird;
+    int blockCount;
+    int enemyCount;
+    Block blocks[MAX_BLOCKS];
+    Enemy enemies[MAX_ENEMIES];
+    int jointCount;
+    Joint joints[MAX_JOINTS];
+    TimerWheel timers;
+} WorldSnapshot;
+
+typedef struct {
+    unsigned int offset;   // start of the record in the arena
+    unsigned int size;     // encoded bytes
+    unsigned int step;
+    int keyframe;          // descriptor sequence number of the keyframe this delta applies to
+    unsigned char flags;
+    bool isKeyframe;
+} SnapshotRecord;
+
+// Fixed-memory history: keyframes are stored raw, the captures in
+// between are XOR deltas against their keyframe, run-length encoded.
+// The oldest records are evicted when the arena or descriptor ring fills.
+typedef struct {
+    unsigned char arena[SNAPSHOT_ARENA_SIZE];
+    unsigned int writeOffset;
+    SnapshotRecord records[MAX_SNAPSHOTS];
+    int first;            // sequence number of the oldest record
+    int count;
+    int sinceKeyframe;
+    WorldSnapshot keyframe; // decoded copy of the newest keyframe
+} SnapshotRing;
+
+void CaptureWorld(WorldSnapshot* snapshot, const Bird* bird, int score, int lives, bool gameOver, unsigned int step);
+void RestoreWorld(const WorldSnapshot* snapshot, Bird* bird, int* score, int* lives, bool* gameOver, unsigned int* step);
+
+void SnapshotRingClear(SnapshotRing* ring);
+void SnapshotRingPush(SnapshotRing* ring, const WorldSnapshot* snapshot, unsigned char flags);
+
+// Records are addressed by sequence number, from SnapshotRingOldest()
+// to SnapshotRingNewest(); -1 means none
+int SnapshotRingOldest(const SnapshotRing* ring);
+int SnapshotRingNewest(const SnapshotRing* ring);
+int SnapshotRingFindShotStart(const SnapshotRing* ring, int before);
+bool SnapshotRingGet(const SnapshotRing* ring, int sequence, WorldSnapshot* out);
+
+// Drops every record newer than sequence (the timeline branches from there)
+void SnapshotRingTruncate(SnapshotRing* ring, int sequence);
+
+#endif
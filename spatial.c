@@ -0,0 +1,233 @@
+#include "spatial.h"
+#include "aabb_tree.h"
+#include "sprite_shapes.h"
+#include <math.h>
+
+#define SPATIAL_LEAVES (MAX_BLOCKS + MAX_ENEMIES + 1)
+
+static AabbNode treeNodes[2 * SPATIAL_LEAVES];
+static AabbTree tree;
+static bool treeReady = false;
+
+static int birdProxy = AABB_TREE_NULL;
+static int blockProxy[MAX_BLOCKS];
+static int enemyProxy[MAX_ENEMIES];
+static int syncedBlocks = 0;
+static int syncedEnemies = 0;
+static Bird syncedBird;
+static bool stale = true;  // bodies moved since the tree was last refit
+
+// Leaves carry (index << 2) | kind
+static int PackBody(BodyKind kind, int index) {
+    return (index << 2) | (int)kind;
+}
+
+static BodyRef UnpackBody(int userData) {
+    return (BodyRef){ (BodyKind)(userData & 3), userData >> 2 };
+}
+
+static AABB RectBox(Rectangle rect) {
+    return (AABB){ { rect.x, rect.y }, { rect.x + rect.width, rect.y + rect.height } };
+}
+
+static AABB CircleBox(Vector2 centre, float radius) {
+    return (AABB){ { centre.x - radius, centre.y - radius }, { centre.x + radius, centre.y + radius } };
+}
+
+// Function to find the circle a round body collides with
+static void RoundShape(BodyRef body, Vector2* centre, float* radius) {
+    if (body.kind == BODY_ENEMY) EnemyCollisionCircle(&enemies[body.index], centre, radius);
+    else BirdCollisionCircle(&syncedBird, centre, radius);
+}
+
+// Function to insert, refit or remove one body's leaf
+static void SyncProxy(int* proxy, bool present, AABB box, Vector2 velocity, BodyKind kind, int index) {
+    if (!present) {
+        if (*proxy != AABB_TREE_NULL) AabbTreeRemove(&tree, *proxy);
+        *proxy = AABB_TREE_NULL;
+    }
+    else if (*proxy == AABB_TREE_NULL) {
+        *proxy = AabbTreeInsert(&tree, box, PackBody(kind, index));
+    }
+    else {
+        AabbTreeMove(&tree, *proxy, box, velocity);
+    }
+}
+
+void SpatialSync(const Bird* bird) {
+    syncedBird = *bird;
+    stale = true;
+}
+
+// Function to refit the tree before a query; steps nobody queries cost nothing
+static void Refit(void) {
+    if (!stale) return;
+    stale = false;
+
+    if (!treeReady) {
+        AabbTreeInit(&tree, treeNodes, 2 * SPATIAL_LEAVES);
+        for (int i = 0; i < MAX_BLOCKS; i++) blockProxy[i] = AABB_TREE_NULL;
+        for (int i = 0; i < MAX_ENEMIES; i++) enemyProxy[i] = AABB_TREE_NULL;
+        treeReady = true;
+    }
+
+    const Bird* bird = &syncedBird;
+    Vector2 centre;
+    float radius;
+    RoundShape((BodyRef){ BODY_BIRD, 0 }, &centre, &radius);
+    SyncProxy(&birdProxy, bird->launched, CircleBox(centre, radius), bird->velocity, BODY_BIRD, 0);
+
+    // Level loads and rewinds replace the arrays wholesale; slots past the new count are dropped
+    int blockSlots = (blockCount > syncedBlocks) ? blockCount : syncedBlocks;
+    for (int i = 0; i < blockSlots; i++) {
+        bool present = i < blockCount && blocks[i].active;
+        SyncProxy(&blockProxy[i], present, present ? RectBox(BlockCollisionRect(&blocks[i], i)) : (AABB){ 0 },
+            blocks[i].velocity, BODY_BLOCK, i);
+    }
+    syncedBlocks = blockCount;
+
+    int enemySlots = (enemyCount > syncedEnemies) ? enemyCount : syncedEnemies;
+    for (int i = 0; i < enemySlots; i++) {
+        bool present = i < enemyCount && enemies[i].active;
+        if (present) RoundShape((BodyRef){ BODY_ENEMY, i }, &centre, &radius);
+        SyncProxy(&enemyProxy[i], present, present ? CircleBox(centre, radius) : (AABB){ 0 },
+            enemies[i].velocity, BODY_ENEMY, i);
+    }
+    syncedEnemies = enemyCount;
+}
+
+typedef enum {
+    SHAPE_RECT,
+    SHAPE_CIRCLE,
+    SHAPE_POINT
+} QueryShape;
+
+typedef struct {
+    QueryShape shape;
+    Rectangle rect;
+    Vector2 centre;
+    float radius;
+
+    BodyRef* found;
+    int capacity;
+    int count;
+} QueryContext;
+
+// Function to test the query shape against a body's exact shape
+static bool Touches(const QueryContext* query, BodyRef body) {
+    Vector2 centre;
+    float radius;
+
+    if (body.kind == BODY_BLOCK) {
+        Rectangle rect = BlockCollisionRect(&blocks[body.index], body.index);
+        switch (query->shape) {
+        case SHAPE_RECT: return CheckCollisionRecs(query->rect, rect);
+        case SHAPE_CIRCLE: return CheckCollisionCircleRec(query->centre, query->radius, rect);
+        default: return CheckCollisionPointRec(query->centre, rect);
+        }
+    }
+
+    RoundShape(body, &centre, &radius);
+
+    switch (query->shape) {
+    case SHAPE_RECT: return CheckCollisionCircleRec(centre, radius, query->rect);
+    case SHAPE_CIRCLE: return CheckCollisionCircles(query->centre, query->radius, centre, radius);
+    default: return CheckCollisionPointCircle(query->centre, centre, radius);
+    }
+}
+
+static bool CollectBody(int userData, void* context) {
+    QueryContext* query = (QueryContext*)context;
+    BodyRef body = UnpackBody(userData);
+    if (!Touches(query, body)) return true;
+
+    // Insertion by (kind, index); there are only a handful of hits
+    int slot = query->count;
+    while (slot > 0 && (query->found[slot - 1].kind > body.kind ||
+        (query->found[slot - 1].kind == body.kind && query->found[slot - 1].index > body.index))) {
+        if (slot < query->capacity) query->found[slot] = query->found[slot - 1];
+        slot--;
+    }
+    if (slot < query->capacity) query->found[slot] = body;
+    if (query->count < query->capacity) query->count++;
+    return true;
+}
+
+int SpatialQueryAABB(Rectangle area, BodyRef* found, int capacity) {
+    Refit();
+
+    QueryContext query = { SHAPE_RECT, area, { 0.0f, 0.0f }, 0.0f, found, capacity, 0 };
+    AabbTreeQueryAABB(&tree, RectBox(area), CollectBody, &query);
+    return query.count;
+}
+
+int SpatialQueryCircle(Vector2 centre, float radius, BodyRef* found, int capacity) {
+    Refit();
+
+    QueryContext query = { SHAPE_CIRCLE, { 0.0f, 0.0f, 0.0f, 0.0f }, centre, radius, found, capacity, 0 };
+    AabbTreeQueryCircle(&tree, centre, radius, CollectBody, &query);
+    return query.count;
+}
+
+int SpatialQueryPoint(Vector2 point, BodyRef* found, int capacity) {
+    Refit();
+
+    QueryContext query = { SHAPE_POINT, { 0.0f, 0.0f, 0.0f, 0.0f }, point, 0.0f, found, capacity, 0 };
+    AabbTreeQueryPoint(&tree, point, CollectBody, &query);
+    return query.count;
+}
+
+typedef struct {
+    BodyRef body;
+    float fraction;
+    bool hit;
+} RaycastContext;
+
+// Function to intersect the segment with a circle; returns the entry fraction or -1
+static float RayCircle(Vector2 from, Vector2 delta, Vector2 centre, float radius) {
+    Vector2 offset = { from.x - centre.x, from.y - centre.y };
+    float a = delta.x * delta.x + delta.y * delta.y;
+    float b = 2.0f * (offset.x * delta.x + offset.y * delta.y);
+    float c = offset.x * offset.x + offset.y * offset.y - radius * radius;
+    if (c <= 0.0f) return 0.0f;  // starts inside
+
+    float discriminant = b * b - 4.0f * a * c;
+    if (a <= 0.0f || discriminant < 0.0f) return -1.0f;
+    return (-b - sqrtf(discriminant)) / (2.0f * a);
+}
+
+static float RaycastBody(int userData, Vector2 from, Vector2 to, float maxFraction, void* context) {
+    RaycastContext* ray = (RaycastContext*)context;
+    BodyRef body = UnpackBody(userData);
+    Vector2 delta = { to.x - from.x, to.y - from.y };
+    float fraction;
+
+    if (body.kind == BODY_BLOCK) {
+        fraction = AabbSegmentFraction(RectBox(BlockCollisionRect(&blocks[body.index], body.index)), from, to, 1.0f);
+    }
+    else {
+        Vector2 centre;
+        float radius;
+        RoundShape(body, &centre, &radius);
+        fraction = RayCircle(from, delta, centre, radius);
+    }
+
+    if (fraction < 0.0f || fraction > maxFraction) return maxFraction;
+
+    ray->body = body;
+    ray->fraction = fraction;
+    ray->hit = true;
+    return fraction;
+}
+
+bool SpatialRaycast(Vector2 from, Vector2 to, BodyRef* hit, Vector2* point) {
+    Refit();
+
+    RaycastContext ray = { { BODY_NONE, -1 }, 1.0f, false };
+    AabbTreeRaycast(&tree, from, to, RaycastBody, &ray);
+    if (!ray.hit) return false;
+
+    if (hit) *hit = ray.body;
+    if (point) *point = (Vector2){ from.x + (to.x - from.x) * ray.fraction, from.y + (to.y - from.y) * ray.fraction };
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include "game.h"
+#include "events.h"
+
+typedef struct {
+    BodyKind kind;
+    int index;  // into blocks[] / enemies[]; 0 for the bird
+} BodyRef;
+
+// AABB tree over the launched bird, active blocks and active enemies.
+// SpatialSync() is called after every physics step and only marks the
+// tree stale; the next query refits the leaves that moved. Blocks are
+// their unrotated rect, round bodies their circle, matching the collision
+// passes. Simulation thread only.
+void SpatialSync(const Bird* bird);
+
+// Exact overlap queries. Results are sorted by kind and index, so a pass
+// visits bodies in the same order as a linear scan over the arrays would.
+// Return the number of bodies found (up to capacity).
+int SpatialQueryAABB(Rectangle area, BodyRef* found, int capacity);
+int SpatialQueryCircle(Vector2 centre, float radius, BodyRef* found, int capacity);
+int SpatialQueryPoint(Vector2 point, BodyRef* found, int capacity);
+
+// Closest body hit by the segment from -> to, with the hit point
+bool SpatialRaycast(Vector2 from, Vector2 to, BodyRef* hit, Vector2* point);
+
+#endif
@@ -0,0 +1,264 @@
+#include "sprite_shapes.h"
+#include "materials.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SHAPES_MAGIC "SHP2"
+
+typedef struct {
+    const char* fileName;
+    float scale;    // drawn pixels per texture pixel, 0 when stretched over a rect
+    float anchorX;  // the body's position within the drawn sprite, as a fraction of its size
+    float anchorY;
+} SpriteSource;
+
+static const SpriteSource sources[SPRITE_SHAPE_COUNT] = {
+    { "blockd.png", 0.0f, 0.0f, 0.0f },
+    { "blocky.png", 0.0f, 0.0f, 0.0f },
+    { "enemy.png", ENEMY_SPRITE_SCALE, ENEMY_SPRITE_ANCHOR_X, ENEMY_SPRITE_ANCHOR_Y },
+    { "angrybird.png", 1.0f, 0.5f, 0.5f },
+};
+
+static SpriteShape shapes[SPRITE_SHAPE_COUNT];
+
+// Function to hash a whole file (FNV-1a); 0 if it can't be read
+static unsigned long long HashFile(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) return 0;
+
+    unsigned long long hash = 14695981039346656037ull;
+    unsigned char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= buffer[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    fclose(file);
+    return hash;
+}
+
+// Function to move a point from texture pixels to where it is drawn in game
+static Vector2 ToGame(const SpriteSource* source, Vector2 point, int width, int height) {
+    if (source->scale == 0.0f) return (Vector2){ point.x / (float)width, point.y / (float)height };
+
+    return (Vector2){
+        (point.x - source->anchorX * (float)width) * source->scale,
+        (point.y - source->anchorY * (float)height) * source->scale
+    };
+}
+
+// Function to trace one sprite's solid pixels into its shape
+static bool TraceSprite(SpriteShapeId id, SpriteShape* shape) {
+    const SpriteSource* source = &sources[id];
+    Image image = LoadImage(source->fileName);
+    if (image.data == NULL) return false;
+
+    const int width = image.width;
+    const int height = image.height;
+    Color* pixels = LoadImageColors(image);
+    UnloadImage(image);
+
+    int left = width, top = height, right = -1, bottom = -1;
+    double sumX = 0.0, sumY = 0.0;
+    long long area = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (pixels[y * width + x].a < SHAPE_ALPHA_THRESHOLD) continue;
+
+            if (x < left) left = x;
+            if (x > right) right = x;
+            if (y < top) top = y;
+            bottom = y;
+            sumX += x + 0.5;
+            sumY += y + 0.5;
+            area++;
+        }
+    }
+    UnloadImageColors(pixels);
+
+    bool traced = area > 0;
+    if (traced) {
+        Vector2 topLeft = ToGame(source, (Vector2){ (float)left, (float)top }, width, height);
+        Vector2 bottomRight = ToGame(source, (Vector2){ (float)(right + 1), (float)(bottom + 1) }, width, height);
+        shape->bounds = (Rectangle){ topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y };
+        shape->centre = ToGame(source, (Vector2){ (float)(sumX / area), (float)(sumY / area) }, width, height);
+        shape->radius = sqrtf((float)area / PI) * source->scale;
+    }
+    shape->traced = traced;
+    return traced;
+}
+
+// Little-endian, whatever the host
+static void WriteBytes(FILE* file, unsigned long long value, int size) {
+    for (int i = 0; i < size; i++) fputc((int)((value >> (i * 8)) & 0xFF), file);
+}
+
+static void WriteFloat(FILE* file, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteBytes(file, bits, 4);
+}
+
+static bool ReadBytes(FILE* file, unsigned long long* value, int size) {
+    *value = 0;
+    for (int i = 0; i < size; i++) {
+        int byte = fgetc(file);
+        if (byte == EOF) return false;
+        *value |= (unsigned long long)byte << (i * 8);
+    }
+    return true;
+}
+
+static bool ReadFloat(FILE* file, float* value) {
+    unsigned long long bits;
+    if (!ReadBytes(file, &bits, 4)) return false;
+
+    unsigned int word = (unsigned int)bits;
+    memcpy(value, &word, sizeof(word));
+    return true;
+}
+
+// Layout: magic, count, then per sprite: traced, source hash, the
+// bounds, the circle's centre and radius
+static bool SaveSpriteShapes(const char* fileName) {
+    FILE* file = fopen(fileName, "wb");
+    if (!file) return false;
+
+    fwrite(SHAPES_MAGIC, 1, 4, file);
+    WriteBytes(file, SPRITE_SHAPE_COUNT, 1);
+    for (int i = 0; i < SPRITE_SHAPE_COUNT; i++) {
+        const SpriteShape* shape = &shapes[i];
+        WriteBytes(file, shape->traced, 1);
+        WriteBytes(file, shape->sourceHash, 8);
+        WriteFloat(file, shape->bounds.x);
+        WriteFloat(file, shape->bounds.y);
+        WriteFloat(file, shape->bounds.width);
+        WriteFloat(file, shape->bounds.height);
+        WriteFloat(file, shape->centre.x);
+        WriteFloat(file, shape->centre.y);
+        WriteFloat(file, shape->radius);
+    }
+
+    bool written = ferror(file) == 0;
+    fclose(file);
+    return written;
+}
+
+int BuildSpriteShapes(const char* fileName) {
+    int failed = 0;
+
+    for (int i = 0; i < SPRITE_SHAPE_COUNT; i++) {
+        SpriteShape* shape = &shapes[i];
+        memset(shape, 0, sizeof(*shape));
+        shape->sourceHash = HashFile(sources[i].fileName);
+
+        if (shape->sourceHash == 0 || !TraceSprite((SpriteShapeId)i, shape)) {
+            printf("%s: no solid pixels, keeping the level shapes\n", sources[i].fileName);
+            failed++;
+            continue;
+        }
+
+        printf("%s: bounds %.3f %.3f %.3f %.3f", sources[i].fileName,
+            shape->bounds.x, shape->bounds.y, shape->bounds.width, shape->bounds.height);
+        if (sources[i].scale != 0.0f) {
+            printf(", circle %.1f %.1f r %.1f", shape->centre.x, shape->centre.y, shape->radius);
+        }
+        printf("\n");
+    }
+
+    if (!SaveSpriteShapes(fileName)) {
+        printf("Can't write %s\n", fileName);
+        return 2;
+    }
+    printf("Wrote %s\n", fileName);
+    return failed > 0 ? 1 : 0;
+}
+
+bool LoadSpriteShapes(const char* fileName) {
+    memset(shapes, 0, sizeof(shapes));
+
+    FILE* file = fopen(fileName, "rb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "SHAPES: no %s, colliding with level shapes (run --build-shapes)", fileName);
+        return false;
+    }
+
+    char magic[4];
+    unsigned long long count = 0;
+    bool hasMagic = fread(magic, 1, 4, file) == 4;
+    if (hasMagic && memcmp(magic, SHAPES_MAGIC, 3) == 0 && magic[3] != SHAPES_MAGIC[3]) {
+        TraceLog(LOG_WARNING, "SHAPES: %s is in an older format, colliding with level shapes (run --build-shapes)", fileName);
+        fclose(file);
+        return false;
+    }
+    bool valid = hasMagic && memcmp(magic, SHAPES_MAGIC, 4) == 0 && ReadBytes(file, &count, 1) && count <= SPRITE_SHAPE_COUNT;
+
+    for (int i = 0; i < (int)count && valid; i++) {
+        SpriteShape shape = { 0 };
+        unsigned long long traced, hash;
+
+        valid = ReadBytes(file, &traced, 1) && ReadBytes(file, &hash, 8) &&
+            ReadFloat(file, &shape.bounds.x) && ReadFloat(file, &shape.bounds.y) &&
+            ReadFloat(file, &shape.bounds.width) && ReadFloat(file, &shape.bounds.height);
+        valid = valid && ReadFloat(file, &shape.centre.x) && ReadFloat(file, &shape.centre.y) && ReadFloat(file, &shape.radius);
+        if (!valid || !traced) continue;
+
+        // A sprite edited since the cache was built goes back to the level shapes
+        if (hash != HashFile(sources[i].fileName)) {
+            TraceLog(LOG_WARNING, "SHAPES: %s changed since %s was built (run --build-shapes)", sources[i].fileName, fileName);
+            continue;
+        }
+
+        shape.traced = true;
+        shape.sourceHash = hash;
+        shapes[i] = shape;
+    }
+    fclose(file);
+
+    if (!valid) {
+        TraceLog(LOG_WARNING, "SHAPES: %s is damaged, colliding with level shapes", fileName);
+        memset(shapes, 0, sizeof(shapes));
+        return false;
+    }
+    return true;
+}
+
+SpriteShapeId BlockSprite(int index, unsigned char material) {
+    return (material != MATERIAL_TNT && index % 2 == 1) ? SPRITE_BLOCKY : SPRITE_BLOCKD;
+}
+
+Rectangle BlockCollisionRect(const Block* block, int index) {
+    const SpriteShape* shape = &shapes[BlockSprite(index, block->material)];
+    if (!shape->traced) return block->rect;
+
+    return (Rectangle){
+        block->rect.x + shape->bounds.x * block->rect.width,
+        block->rect.y + shape->bounds.y * block->rect.height,
+        shape->bounds.width * block->rect.width,
+        shape->bounds.height * block->rect.height
+    };
+}
+
+// Function to place a round sprite's circle at a body, or keep the body's own
+static void RoundCollisionCircle(SpriteShapeId id, Vector2 position, float bodyRadius, Vector2* centre, float* radius) {
+    const SpriteShape* shape = &shapes[id];
+    if (!shape->traced) {
+        *centre = position;
+        *radius = bodyRadius;
+        return;
+    }
+
+    *centre = (Vector2){ position.x + shape->centre.x, position.y + shape->centre.y };
+    *radius = shape->radius;
+}
+
+void EnemyCollisionCircle(const Enemy* enemy, Vector2* centre, float* radius) {
+    RoundCollisionCircle(SPRITE_ENEMY, enemy->position, enemy->radius, centre, radius);
+}
+
+void BirdCollisionCircle(const Bird* bird, Vector2* centre, float* radius) {
+    RoundCollisionCircle(SPRITE_BIRD, bird->position, bird->radius, centre, radius);
+}
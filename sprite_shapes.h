@@ -0,0 +1,59 @@
+#ifndef SPRITE_SHAPES_H
+#define SPRITE_SHAPES_H
+
+#include "game.h"
+
+// Collision shapes traced from the sprites' alpha channels. Tracing runs
+// as an asset build step (--build-shapes) and is cached in SHAPES_FILE;
+// the game only reads the cache. A sprite whose image changed since the
+// cache was built, or that the cache lacks, keeps the raw body shapes
+// from the level file until the step is run again.
+#define SHAPES_FILE "shapes.bin"
+#define SHAPE_ALPHA_THRESHOLD 128   // pixels at least this opaque are solid
+
+// How the enemy sprite is drawn: scaled down, and shifted left of and up
+// from the enemy's position by these fractions of its drawn size
+#define ENEMY_SPRITE_SCALE 0.05f
+#define ENEMY_SPRITE_ANCHOR_X (1.0f / 1.2f)
+#define ENEMY_SPRITE_ANCHOR_Y 0.5f
+
+typedef enum {
+    SPRITE_BLOCKD,   // blockd.png, also under TNT
+    SPRITE_BLOCKY,   // blocky.png
+    SPRITE_ENEMY,
+    SPRITE_BIRD,
+    SPRITE_SHAPE_COUNT
+} SpriteShapeId;
+
+// A sprite's solid area as it is drawn in game. Block textures are
+// stretched over the block's rect, so their bounds are in fractions of it;
+// enemies and the bird are drawn at a fixed size, so theirs are in pixels
+// from the body's position. The circle has the solid area's area and
+// centroid, and is only used for round bodies.
+typedef struct {
+    bool traced;
+    unsigned long long sourceHash;   // of the image file it was traced from
+    Rectangle bounds;                // of the solid pixels
+    Vector2 centre;
+    float radius;
+} SpriteShape;
+
+// Traces every sprite and writes the cache; returns 0 on success
+int BuildSpriteShapes(const char* fileName);
+
+// Reads the cache, keeping the shapes whose image is unchanged
+bool LoadSpriteShapes(const char* fileName);
+
+// Which texture block index is drawn with (see the block drawing in FileName.c)
+SpriteShapeId BlockSprite(int index, unsigned char material);
+
+// Shapes the collision passes test, falling back to the body's own
+// rect or circle. Blocks keep to axis-aligned rects like the narrow
+// phase and the AABB tree, so they get the bounds of their solid pixels.
+// Enemies are moved, landed and hit as their circle everywhere: the
+// ECS bodies, the spatial tree and the fixed-point world.
+Rectangle BlockCollisionRect(const Block* block, int index);
+void EnemyCollisionCircle(const Enemy* enemy, Vector2* centre, float* radius);
+void BirdCollisionCircle(const Bird* bird, Vector2* centre, float* radius);
+
+#endif
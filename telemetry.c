@@ -0,0 +1,262 @@
+#include "telemetry.h"
+#include "raylib.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    atomic_ullong buckets[TELEMETRY_BUCKETS];
+    atomic_ullong sum;
+    atomic_ullong max;
+} HistogramCells;
+
+// One second of recordings. Writers add into the active slot; the flush
+// thread swaps slots and drains the other one with atomic exchanges, so a
+// writer that raced the swap only lands in the following second.
+typedef struct {
+    HistogramCells histograms[TELEMETRY_HISTOGRAM_COUNT];
+    atomic_ullong counters[TELEMETRY_COUNTER_COUNT];
+} TelemetrySlot;
+
+typedef struct {
+    unsigned long long buckets[TELEMETRY_BUCKETS];
+    unsigned long long sum;
+    unsigned long long max;
+} HistogramTotals;
+
+typedef struct {
+    const char* name;
+    const char* help;
+} MetricInfo;
+
+static const MetricInfo histogramInfo[TELEMETRY_HISTOGRAM_COUNT] = {
+    [TELEMETRY_FRAME_TIME] = { "game_frame_time_us", "Frame time in microseconds" },
+    [TELEMETRY_PHYSICS_STEP] = { "game_physics_step_us", "Simulation step time in microseconds" },
+    [TELEMETRY_LIVE_BODIES] = { "game_live_bodies", "Active bird, blocks and enemies per step" },
+};
+
+static const MetricInfo counterInfo[TELEMETRY_COUNTER_COUNT] = {
+    [TELEMETRY_COLLISION_PAIRS] = { "game_collision_pairs_total", "Collision pairs tested" },
+    [TELEMETRY_DRAW_CALLS] = { "game_draw_calls_total", "Draw submissions from the game view" },
+    [TELEMETRY_SHOTS_FIRED] = { "game_shots_fired_total", "Birds launched" },
+    [TELEMETRY_LEVELS_WON] = { "game_levels_won_total", "Levels finished with every enemy dead" },
+    [TELEMETRY_LEVELS_LOST] = { "game_levels_lost_total", "Levels ended by running out of birds" },
+};
+
+static TelemetrySlot slots[2];
+static atomic_uint activeSlot;
+static bool enabled = false;
+
+// Flush thread only
+static char directoryPath[256];
+static HistogramTotals histogramTotals[TELEMETRY_HISTOGRAM_COUNT];
+static unsigned long long counterTotals[TELEMETRY_COUNTER_COUNT];
+
+static int BucketOf(unsigned long long value) {
+    int bucket = 0;
+    while (bucket < TELEMETRY_BUCKETS - 1 && (1ull << bucket) < value) bucket++;
+    return bucket;
+}
+
+void TelemetryObserve(TelemetryHistogram histogram, unsigned long long value) {
+    if (!enabled) return;
+
+    TelemetrySlot* slot = &slots[atomic_load_explicit(&activeSlot, memory_order_relaxed)];
+    HistogramCells* cells = &slot->histograms[histogram];
+
+    atomic_fetch_add_explicit(&cells->buckets[BucketOf(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&cells->sum, value, memory_order_relaxed);
+
+    unsigned long long seen = atomic_load_explicit(&cells->max, memory_order_relaxed);
+    while (value > seen && !atomic_compare_exchange_weak_explicit(&cells->max, &seen, value,
+        memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void TelemetryCount(TelemetryCounter counter, unsigned long long amount) {
+    if (!enabled || amount == 0) return;
+
+    TelemetrySlot* slot = &slots[atomic_load_explicit(&activeSlot, memory_order_relaxed)];
+    atomic_fetch_add_explicit(&slot->counters[counter], amount, memory_order_relaxed);
+}
+
+static void PathFor(char* path, size_t size, const char* fileName) {
+    snprintf(path, size, "%s/%s", directoryPath, fileName);
+}
+
+// Function to shift telemetry.jsonl -> .1 -> .2 ..., dropping the oldest
+static void RotateJsonl(void) {
+    char from[300];
+    char to[300];
+
+    // Not TextFormat(): its buffers are shared with the drawing thread
+    for (int i = TELEMETRY_KEEP_FILES - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s/telemetry.jsonl.%d", directoryPath, i);
+        snprintf(to, sizeof(to), "%s/telemetry.jsonl.%d", directoryPath, i + 1);
+        rename(from, to);
+    }
+    PathFor(from, sizeof(from), "telemetry.jsonl");
+    PathFor(to, sizeof(to), "telemetry.jsonl.1");
+    rename(from, to);
+}
+
+static void WriteJsonl(long long now, const HistogramTotals* second, const unsigned long long* counters) {
+    char path[300];
+    PathFor(path, sizeof(path), "telemetry.jsonl");
+
+    FILE* file = fopen(path, "a");
+    if (file == NULL) return;
+
+    fprintf(file, "{\"time\": %lld", now);
+    for (int h = 0; h < TELEMETRY_HISTOGRAM_COUNT; h++) {
+        unsigned long long count = 0;
+        for (int b = 0; b < TELEMETRY_BUCKETS; b++) count += second[h].buckets[b];
+
+        fprintf(file, ", \"%s\": {\"count\": %llu, \"sum\": %llu, \"max\": %llu, \"buckets\": [",
+            histogramInfo[h].name, count, second[h].sum, second[h].max);
+        for (int b = 0; b < TELEMETRY_BUCKETS; b++) {
+            fprintf(file, b ? ", %llu" : "%llu", second[h].buckets[b]);
+        }
+        fprintf(file, "]}");
+    }
+    for (int c = 0; c < TELEMETRY_COUNTER_COUNT; c++) {
+        fprintf(file, ", \"%s\": %llu", counterInfo[c].name, counters[c]);
+    }
+    fprintf(file, "}\n");
+
+    bool rotate = ftell(file) > TELEMETRY_ROTATE_BYTES;
+    fclose(file);
+    if (rotate) RotateJsonl();
+}
+
+// Function to write the cumulative totals next to the live file and swap it in
+static void WritePrometheus(void) {
+    char path[300];
+    char temporary[300];
+    PathFor(path, sizeof(path), "telemetry.prom");
+    PathFor(temporary, sizeof(temporary), "telemetry.prom.tmp");
+
+    FILE* file = fopen(temporary, "w");
+    if (file == NULL) return;
+
+    for (int h = 0; h < TELEMETRY_HISTOGRAM_COUNT; h++) {
+        const char* name = histogramInfo[h].name;
+        unsigned long long cumulative = 0;
+
+        fprintf(file, "# HELP %s %s\n# TYPE %s histogram\n", name, histogramInfo[h].help, name);
+        for (int b = 0; b < TELEMETRY_BUCKETS; b++) {
+            cumulative += histogramTotals[h].buckets[b];
+            if (b < TELEMETRY_BUCKETS - 1) {
+                fprintf(file, "%s_bucket{le=\"%llu\"} %llu\n", name, 1ull << b, cumulative);
+            }
+            else {
+                fprintf(file, "%s_bucket{le=\"+Inf\"} %llu\n", name, cumulative);
+            }
+        }
+        fprintf(file, "%s_sum %llu\n%s_count %llu\n", name, histogramTotals[h].sum, name, cumulative);
+    }
+    for (int c = 0; c < TELEMETRY_COUNTER_COUNT; c++) {
+        const char* name = counterInfo[c].name;
+        fprintf(file, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", name, counterInfo[c].help, name, name, counterTotals[c]);
+    }
+
+    fclose(file);
+    rename(temporary, path);
+}
+
+// Function to take the last second's slot, fold it into the totals and write both files
+static void FlushSecond(void) {
+    unsigned int drained = atomic_fetch_xor_explicit(&activeSlot, 1u, memory_order_relaxed);
+    TelemetrySlot* slot = &slots[drained];
+
+    HistogramTotals second[TELEMETRY_HISTOGRAM_COUNT];
+    unsigned long long counters[TELEMETRY_COUNTER_COUNT];
+
+    for (int h = 0; h < TELEMETRY_HISTOGRAM_COUNT; h++) {
+        HistogramCells* cells = &slot->histograms[h];
+        for (int b = 0; b < TELEMETRY_BUCKETS; b++) {
+            second[h].buckets[b] = atomic_exchange_explicit(&cells->buckets[b], 0, memory_order_relaxed);
+            histogramTotals[h].buckets[b] += second[h].buckets[b];
+        }
+        second[h].sum = atomic_exchange_explicit(&cells->sum, 0, memory_order_relaxed);
+        second[h].max = atomic_exchange_explicit(&cells->max, 0, memory_order_relaxed);
+        histogramTotals[h].sum += second[h].sum;
+        if (second[h].max > histogramTotals[h].max) histogramTotals[h].max = second[h].max;
+    }
+    for (int c = 0; c < TELEMETRY_COUNTER_COUNT; c++) {
+        counters[c] = atomic_exchange_explicit(&slot->counters[c], 0, memory_order_relaxed);
+        counterTotals[c] += counters[c];
+    }
+
+    WriteJsonl((long long)time(NULL), second, counters);
+    WritePrometheus();
+}
+
+#ifndef _WIN32
+
+#include <pthread.h>
+
+static pthread_t flushThread;
+static pthread_mutex_t flushLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flushWake = PTHREAD_COND_INITIALIZER;
+static bool stopping = false;
+
+static void* TelemetryMain(void* argument) {
+    pthread_mutex_lock(&flushLock);
+    while (!stopping) {
+        struct timespec deadline;
+        timespec_get(&deadline, TIME_UTC);
+        deadline.tv_sec += 1;
+
+        pthread_cond_timedwait(&flushWake, &flushLock, &deadline);
+
+        pthread_mutex_unlock(&flushLock);
+        FlushSecond();
+        pthread_mutex_lock(&flushLock);
+    }
+    pthread_mutex_unlock(&flushLock);
+    return NULL;
+}
+
+bool TelemetryStart(const char* directory) {
+    snprintf(directoryPath, sizeof(directoryPath), "%s", directory);
+    memset(histogramTotals, 0, sizeof(histogramTotals));
+    memset(counterTotals, 0, sizeof(counterTotals));
+    stopping = false;
+
+    // Set before any recording thread exists, so the plain flag needs no synchronisation
+    enabled = true;
+    if (pthread_create(&flushThread, NULL, TelemetryMain, NULL) != 0) {
+        TraceLog(LOG_WARNING, "TELEMETRY: Failed to start flush thread");
+        enabled = false;
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "TELEMETRY: Writing %s/telemetry.prom and telemetry.jsonl", directoryPath);
+    return true;
+}
+
+void TelemetryStop(void) {
+    if (!enabled) return;
+
+    pthread_mutex_lock(&flushLock);
+    stopping = true;
+    pthread_cond_signal(&flushWake);
+    pthread_mutex_unlock(&flushLock);
+
+    pthread_join(flushThread, NULL);
+    enabled = false;
+}
+
+#else
+
+bool TelemetryStart(const char* directory) {
+    TraceLog(LOG_WARNING, "TELEMETRY: Not supported in this build");
+    return false;
+}
+
+void TelemetryStop(void) {
+}
+
+#endif
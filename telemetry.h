@@ -0,0 +1,38 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+
+#define TELEMETRY_BUCKETS 24                        // value <= 1, 2, 4, ... 2^22, then +Inf
+#define TELEMETRY_ROTATE_BYTES (4 * 1024 * 1024)    // telemetry.jsonl is rotated past this
+#define TELEMETRY_KEEP_FILES 3                      // telemetry.jsonl.1 .. .3
+
+typedef enum {
+    TELEMETRY_FRAME_TIME,    // microseconds
+    TELEMETRY_PHYSICS_STEP,  // microseconds
+    TELEMETRY_LIVE_BODIES,   // sampled once per step
+    TELEMETRY_HISTOGRAM_COUNT
+} TelemetryHistogram;
+
+typedef enum {
+    TELEMETRY_COLLISION_PAIRS,
+    TELEMETRY_DRAW_CALLS,
+    TELEMETRY_SHOTS_FIRED,
+    TELEMETRY_LEVELS_WON,
+    TELEMETRY_LEVELS_LOST,
+    TELEMETRY_COUNTER_COUNT
+} TelemetryCounter;
+
+// Starts the flush thread. Every second it writes directory/telemetry.prom
+// (Prometheus text format, cumulative, replaced atomically for a textfile
+// collector) and appends that second's values to directory/telemetry.jsonl.
+// Without thread support telemetry stays off.
+bool TelemetryStart(const char* directory);
+void TelemetryStop(void);
+
+// Hot path: a few relaxed atomic adds, callable from any thread. Does
+// nothing until TelemetryStart() succeeded.
+void TelemetryObserve(TelemetryHistogram histogram, unsigned long long value);
+void TelemetryCount(TelemetryCounter counter, unsigned long long amount);
+
+#endif
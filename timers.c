@@ -0,0 +1,157 @@
+#include "timers.h"
+#include <string.h>
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_SPAN ((unsigned int)TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS)
+
+typedef struct {
+    TimerHandler callback;
+    void* userData;
+} HandlerSlot;
+
+static HandlerSlot handlers[TIMER_ACTION_COUNT];
+
+void SetTimerHandler(TimerAction action, TimerHandler handler, void* userData) {
+    if (action < 0 || action >= TIMER_ACTION_COUNT) return;
+
+    handlers[action].callback = handler;
+    handlers[action].userData = userData;
+}
+
+void ClearTimers(TimerWheel* wheel) {
+    // Zero first so snapshots of equal wheels compare equal
+    memset(wheel, 0, sizeof(*wheel));
+
+    for (int i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++) {
+        wheel->heads[i] = -1;
+    }
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        wheel->timers[i].next = (short)((i + 1 < MAX_TIMERS) ? i + 1 : -1);
+        wheel->timers[i].prev = -1;
+        wheel->timers[i].bucket = -1;
+    }
+    wheel->freeList = 0;
+}
+
+// Function to pick the slot for a due step: the near slots one step each,
+// the far ones TIMER_WHEEL_SLOTS steps each
+static short BucketFor(const TimerWheel* wheel, unsigned int due) {
+    unsigned int delta = due - wheel->now;
+    if (delta < TIMER_WHEEL_SLOTS) return (short)(due & TIMER_WHEEL_MASK);
+
+    // Beyond the wheel: park in the furthest slot and get placed again when it comes round
+    if (delta >= TIMER_WHEEL_SPAN) due = wheel->now + TIMER_WHEEL_SPAN - 1;
+    return (short)(TIMER_WHEEL_SLOTS + ((due >> TIMER_WHEEL_BITS) & TIMER_WHEEL_MASK));
+}
+
+static void Link(TimerWheel* wheel, int index, short bucket) {
+    Timer* timer = &wheel->timers[index];
+    timer->bucket = bucket;
+    timer->prev = -1;
+    timer->next = wheel->heads[bucket];
+    if (timer->next >= 0) wheel->timers[timer->next].prev = (short)index;
+    wheel->heads[bucket] = (short)index;
+}
+
+static void Unlink(TimerWheel* wheel, int index) {
+    Timer* timer = &wheel->timers[index];
+    if (timer->prev >= 0) wheel->timers[timer->prev].next = timer->next;
+    else wheel->heads[timer->bucket] = timer->next;
+    if (timer->next >= 0) wheel->timers[timer->next].prev = timer->prev;
+    timer->bucket = -1;
+}
+
+static void Release(TimerWheel* wheel, int index) {
+    Timer* timer = &wheel->timers[index];
+    timer->next = wheel->freeList;
+    timer->prev = -1;
+    wheel->freeList = (short)index;
+    wheel->pending--;
+}
+
+// Function to look up a handle's timer; -1 if it isn't pending
+static int PendingIndex(const TimerWheel* wheel, int handle) {
+    int index = handle - 1;
+    if (index < 0 || index >= MAX_TIMERS || wheel->timers[index].bucket < 0) return -1;
+    return index;
+}
+
+int ScheduleTimer(TimerWheel* wheel, unsigned int delay, TimerAction action, int target) {
+    if (wheel->freeList < 0) return TIMER_NONE;
+
+    int index = wheel->freeList;
+    Timer* timer = &wheel->timers[index];
+    wheel->freeList = timer->next;
+    wheel->pending++;
+
+    timer->due = wheel->now + (delay > 0 ? delay : 1);
+    timer->sequence = wheel->sequence++;
+    timer->action = (unsigned char)action;
+    timer->target = target;
+    Link(wheel, index, BucketFor(wheel, timer->due));
+    return index + 1;
+}
+
+bool CancelTimer(TimerWheel* wheel, int handle) {
+    int index = PendingIndex(wheel, handle);
+    if (index < 0) return false;
+
+    Unlink(wheel, index);
+    Release(wheel, index);
+    return true;
+}
+
+unsigned int TimerRemaining(const TimerWheel* wheel, int handle) {
+    int index = PendingIndex(wheel, handle);
+    return (index < 0) ? 0 : wheel->timers[index].due - wheel->now;
+}
+
+int TakeDueTimers(TimerWheel* wheel, Timer* due) {
+    wheel->now++;
+
+    // Every TIMER_WHEEL_SLOTS steps the next far slot is spread over the near ones
+    if ((wheel->now & TIMER_WHEEL_MASK) == 0) {
+        short bucket = (short)(TIMER_WHEEL_SLOTS + ((wheel->now >> TIMER_WHEEL_BITS) & TIMER_WHEEL_MASK));
+        int index = wheel->heads[bucket];
+        wheel->heads[bucket] = -1;
+
+        while (index >= 0) {
+            int next = wheel->timers[index].next;
+            Link(wheel, index, BucketFor(wheel, wheel->timers[index].due));
+            index = next;
+        }
+    }
+
+    // Take the whole slot first, so handlers can schedule into it safely
+    short bucket = (short)(wheel->now & TIMER_WHEEL_MASK);
+    int count = 0;
+
+    for (int index = wheel->heads[bucket]; index >= 0; index = wheel->timers[index].next) {
+        // Insertion sort on schedule order; a slot holds a handful at most
+        int at = count++;
+        while (at > 0 && due[at - 1].sequence > wheel->timers[index].sequence) {
+            due[at] = due[at - 1];
+            at--;
+        }
+        due[at] = wheel->timers[index];
+    }
+    for (int index = wheel->heads[bucket]; index >= 0;) {
+        int next = wheel->timers[index].next;
+        wheel->timers[index].bucket = -1;
+        Release(wheel, index);
+        index = next;
+    }
+    wheel->heads[bucket] = -1;
+    return count;
+}
+
+int AdvanceTimers(TimerWheel* wheel) {
+    Timer due[MAX_TIMERS];
+    int count = TakeDueTimers(wheel, due);
+
+    for (int i = 0; i < count; i++) {
+        const HandlerSlot* handler = &handlers[due[i].action];
+        if (handler->callback != NULL) handler->callback(due[i].target, handler->userData);
+    }
+    return count;
+}
@@ -0,0 +1,71 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include <stdbool.h>
+
+#define MAX_TIMERS 64
+#define TIMER_NONE 0           // handle of no timer; zeroed structs hold none
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 2   // reaches TIMER_WHEEL_SLOTS^2 steps ahead; later timers wait at the far end
+
+typedef enum {
+    TIMER_ENEMY_RECOVER,   // target enemy can be hurt by blocks again
+    TIMER_LEVEL_COMPLETE,  // show the level complete screen
+    TIMER_ACTION_COUNT
+} TimerAction;
+
+// Pending timers sit in doubly linked lists, one per wheel slot; free ones
+// in a list of their own. Links are indices, so a wheel can be copied
+// whole into a snapshot and restored later.
+typedef struct {
+    unsigned int due;       // step it fires on
+    unsigned int sequence;  // order it was scheduled in, for timers due on the same step
+    short next;             // -1 at the end of a list
+    short prev;
+    short bucket;           // level * TIMER_WHEEL_SLOTS + slot, -1 while free
+    unsigned char action;   // TimerAction
+    int target;
+} Timer;
+
+typedef struct {
+    unsigned int now;       // steps advanced so far
+    unsigned int sequence;
+    short heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    short freeList;
+    int pending;
+    Timer timers[MAX_TIMERS];
+} TimerWheel;
+
+// Runs the action for target. Handlers are registered once for the
+// process and are not part of the wheel.
+typedef void (*TimerHandler)(int target, void* userData);
+
+void SetTimerHandler(TimerAction action, TimerHandler handler, void* userData);
+
+// Drops every pending timer and starts counting from step 0
+void ClearTimers(TimerWheel* wheel);
+
+// Fires action on target after delay more AdvanceTimers() calls (at least
+// one). Returns a handle for CancelTimer(), or TIMER_NONE when all
+// MAX_TIMERS are pending. A handle is only good until its timer fires or
+// is cancelled.
+int ScheduleTimer(TimerWheel* wheel, unsigned int delay, TimerAction action, int target);
+
+// Returns false if the timer already fired or was cancelled
+bool CancelTimer(TimerWheel* wheel, int handle);
+
+// Steps until the timer fires, 0 when it isn't pending
+unsigned int TimerRemaining(const TimerWheel* wheel, int handle);
+
+// Moves the wheel on one step and fires the timers due, in the order they
+// were scheduled. Handlers may schedule and cancel timers. Returns how
+// many fired.
+int AdvanceTimers(TimerWheel* wheel);
+
+// Like AdvanceTimers(), but copies the timers due into due[] (room for
+// MAX_TIMERS) instead of running handlers, for wheels that belong to a
+// world of their own. Returns how many are due.
+int TakeDueTimers(TimerWheel* wheel, Timer* due);
+
+#endif